@@ -0,0 +1,135 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Generates the src/bench/data/sigma_spend_*.raw fixtures of the sigma spend
+// benchmarks (src/bench/sigma_spend.cpp): a spend of one coin out of an
+// anonymity set of the given size, in the layout SigmaSpendFixture reads.
+//
+// The mints of the set other than the spent coin, and the hashes of the blocks
+// minting them, are derived from the set size and their position exactly as
+// the benchmark derives them. The spent coin is fresh, so every run gives a
+// different but equally valid fixture.
+//
+// The set is in the order CSigmaState hands it out to CheckSigmaTransaction:
+// the 100 mints of the last block of the group first, then those of the block
+// before it and so on, and the spend refers to the last block. The spent coin
+// is in the middle of the set.
+//
+// Build it from src/ of a built tree, e.g.:
+//
+//     g++ -std=c++11 -DHAVE_CONFIG_H -I. -Iconfig -Isecp256k1/include -Iunivalue/include \
+//         ../contrib/testgen/gen_sigma_spend_bench_fixtures.cpp \
+//         libsigma.a libbitcoin_common.a libbitcoin_util.a libbitcoin_consensus.a \
+//         crypto/libbitcoin_crypto.a secp256k1/.libs/libsecp256k1.a \
+//         -lboost_system -lboost_filesystem -lboost_thread -lboost_chrono -lcrypto -pthread \
+//         -o gen_sigma_spend_bench_fixtures
+//
+// and run it as:
+//
+//     gen_sigma_spend_bench_fixtures 1000 bench/data/sigma_spend_1000.raw
+//     gen_sigma_spend_bench_fixtures 8000 bench/data/sigma_spend_8000.raw
+//     gen_sigma_spend_bench_fixtures 16000 bench/data/sigma_spend_16000.raw
+
+#include "amount.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "primitives/transaction.h"
+#include "primitives/zerocoin.h"
+#include "pubkey.h"
+#include "script/script.h"
+#include "sigma/coin.h"
+#include "sigma/coinspend.h"
+#include "sigma/params.h"
+#include "streams.h"
+#include "version.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const sigma::CoinDenomination FIXTURE_DENOMINATION = sigma::CoinDenomination::SIGMA_DENOM_1;
+const int FIXTURE_GROUP_ID = 1;
+const uint32_t FIXTURE_MINTS_PER_BLOCK = 100;
+
+GroupElement DeriveMint(uint32_t nSetSize, uint32_t i)
+{
+    CHashWriter hasher(SER_GETHASH, 0);
+    hasher << std::string("sigma bench mint") << nSetSize << i;
+    uint256 hash = hasher.GetHash();
+
+    GroupElement mint;
+    mint.generate(hash.begin());
+    return mint;
+}
+
+/** The hash of block nBlock of the group, counted from the first block */
+uint256 DeriveBlockHash(uint32_t nSetSize, uint32_t nBlock)
+{
+    CHashWriter hasher(SER_GETHASH, 0);
+    hasher << std::string("sigma bench block") << nSetSize << nBlock;
+    return hasher.GetHash();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 || atoi(argv[1]) <= 0) {
+        std::cerr << "Usage: " << argv[0] << " <set size> <output file>" << std::endl;
+        return 1;
+    }
+
+    SelectParams(CBaseChainParams::MAIN);
+
+    uint32_t nSetSize = atoi(argv[1]);
+    uint32_t nCoinIndex = nSetSize / 2;
+    uint32_t nBlockCount = (nSetSize + FIXTURE_MINTS_PER_BLOCK - 1) / FIXTURE_MINTS_PER_BLOCK;
+    const sigma::Params* params = sigma::Params::get_default();
+
+    sigma::PrivateCoin coin(params, FIXTURE_DENOMINATION, ZEROCOIN_TX_VERSION_3_1);
+    std::vector<sigma::PublicCoin> anonymitySet;
+    anonymitySet.reserve(nSetSize);
+    for (uint32_t i = 0; i < nSetSize; i++) {
+        if (i == nCoinIndex)
+            anonymitySet.push_back(coin.getPublicCoin());
+        else
+            anonymitySet.emplace_back(DeriveMint(nSetSize, i), FIXTURE_DENOMINATION);
+    }
+
+    // the spend is bound to the transaction without its spend scripts
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint(uint256(), 1), CScript(), uint32_t(CTxIn::SEQUENCE_FINAL));
+    tx.vout.emplace_back(1 * COIN, CScript() << OP_DUP << OP_HASH160 << ToByteVector(CKeyID()) << OP_EQUALVERIFY << OP_CHECKSIG);
+    sigma::SpendMetaData metaData(FIXTURE_GROUP_ID, DeriveBlockHash(nSetSize, nBlockCount - 1), tx.GetHash());
+
+    sigma::CoinSpend spend(params, coin, anonymitySet, metaData, true);
+    spend.setVersion(ZEROCOIN_TX_VERSION_3_1);
+    if (!spend.Verify(anonymitySet, metaData, true)) {
+        std::cerr << "Error: the spend does not verify" << std::endl;
+        return 1;
+    }
+
+    CDataStream serializedSpend(SER_NETWORK, PROTOCOL_VERSION);
+    serializedSpend << spend;
+    tx.vin[0].scriptSig << OP_SIGMASPEND;
+    tx.vin[0].scriptSig.insert(tx.vin[0].scriptSig.end(), serializedSpend.begin(), serializedSpend.end());
+
+    uint256 ecdsaSeckey;
+    memcpy(ecdsaSeckey.begin(), coin.getEcdsaSeckey(), ecdsaSeckey.size());
+
+    CDataStream fixture(SER_NETWORK, PROTOCOL_VERSION);
+    fixture << nSetSize << nCoinIndex << coin.getSerialNumber() << coin.getRandomness() << ecdsaSeckey << CTransaction(tx);
+
+    std::ofstream file(argv[2], std::ios::binary);
+    file.write(fixture.data(), fixture.size());
+    if (!file) {
+        std::cerr << "Error: cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
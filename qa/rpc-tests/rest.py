@@ -24,6 +24,16 @@ def deser_uint256(f):
         r += t << (i * 32)
     return r
 
+def deser_compact_size(f):
+    nit = unpack(b"<B", f.read(1))[0]
+    if nit == 253:
+        nit = unpack(b"<H", f.read(2))[0]
+    elif nit == 254:
+        nit = unpack(b"<I", f.read(4))[0]
+    elif nit == 255:
+        nit = unpack(b"<Q", f.read(8))[0]
+    return nit
+
 #allows simple http get calls
 def http_get_call(host, port, path, response_object = 0):
     conn = http.client.HTTPConnection(host, port)
@@ -274,6 +284,32 @@ class RESTTest (BitcoinTestFramework):
         json_obj = json.loads(response_header_json_str)
         assert_equal(len(json_obj), 5) #now we should have 5 header objects
 
+        #stream the same 5 blocks, the first record starts with the block we asked for
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/'+str(rpc_block_json['height'])+'/5'+self.FORMAT_SEPARATOR+"bin", True)
+        assert_equal(response_blocks.status, 200)
+        blocks_stream = BytesIO(response_blocks.read())
+        assert_equal(unpack(b"<i", blocks_stream.read(4))[0], rpc_block_json['height'])
+        assert_equal(deser_uint256(blocks_stream), int(bb_hash, 16))
+        assert_equal(blocks_stream.read(deser_compact_size(blocks_stream)), response_str)
+
+        #the deltas form carries the same records with the index entries appended
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/'+str(rpc_block_json['height'])+'/5/deltas'+self.FORMAT_SEPARATOR+"bin", True)
+        assert_equal(response_blocks.status, 200)
+        blocks_stream = BytesIO(response_blocks.read())
+        assert_equal(unpack(b"<i", blocks_stream.read(4))[0], rpc_block_json['height'])
+        assert_equal(deser_uint256(blocks_stream), int(bb_hash, 16))
+        assert_equal(blocks_stream.read(deser_compact_size(blocks_stream)), response_str)
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/'+str(rpc_block_json['height'])+'/5/other'+self.FORMAT_SEPARATOR+"bin", True)
+        assert_equal(response_blocks.status, 400)
+
+        #only the binary format is supported, and the range has to start in the chain
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/'+str(rpc_block_json['height'])+'/5'+self.FORMAT_SEPARATOR+"json", True)
+        assert_equal(response_blocks.status, 404)
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/'+str(self.nodes[0].getblockcount()+1)+'/1'+self.FORMAT_SEPARATOR+"bin", True)
+        assert_equal(response_blocks.status, 404)
+        response_blocks = http_get_call(url.hostname, url.port, '/rest/blocks/0/0'+self.FORMAT_SEPARATOR+"bin", True)
+        assert_equal(response_blocks.status, 400)
+
         # do tx test
         tx_hash = block_json_obj['tx'][0]['txid']
         json_string = http_get_call(url.hostname, url.port, '/rest/tx/'+tx_hash+self.FORMAT_SEPARATOR+"json")
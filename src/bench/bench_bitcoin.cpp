@@ -4,6 +4,8 @@
 
 #include "bench.h"
 
+#include "chainparams.h"
+#include "crypto/sha256.h"
 #include "key.h"
 #include "stacktraces.h"
 #include "validation.h"
@@ -16,9 +18,11 @@ main(int argc, char** argv)
     RegisterPrettySignalHandlers();
     RegisterPrettyTerminateHander();
 #endif
+    SHA256AutoDetect();
     ECC_Start();
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
+    SelectParams(CBaseChainParams::MAIN); // sigma benchmarks use the mainnet generators and consensus rules
 
     benchmark::BenchRunner::RunAll();
 
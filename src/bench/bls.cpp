@@ -0,0 +1,132 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "bls/bls.h"
+#include "hash.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** Keys of the members of a LLMQ_50_60 quorum */
+const size_t BENCH_QUORUM_SIZE = 50;
+
+uint256 BenchHash(const std::string& tag, size_t i)
+{
+    CHashWriter hasher(SER_GETHASH, 0);
+    hasher << tag << (uint64_t)i;
+    return hasher.GetHash();
+}
+
+/** The same keys on every run; secret keys are big endian and must be below the group order */
+CBLSSecretKey BenchSecretKey(size_t i)
+{
+    uint256 buf = BenchHash("bls bench key", i);
+    *buf.begin() &= 0x3f;
+
+    CBLSSecretKey sk;
+    sk.SetBuf(buf.begin(), buf.size());
+    assert(sk.IsValid());
+    return sk;
+}
+
+struct BLSQuorumSetup
+{
+    std::vector<CBLSSecretKey> secretKeys;
+    std::vector<CBLSPublicKey> publicKeys;
+    std::vector<uint256> hashes;
+    //! All members signing the same hash, as for a quorum signature
+    std::vector<CBLSSignature> sigsSameHash;
+    //! Every member signing its own hash
+    std::vector<CBLSSignature> sigsOwnHash;
+
+    BLSQuorumSetup()
+    {
+        for (size_t i = 0; i < BENCH_QUORUM_SIZE; i++) {
+            secretKeys.push_back(BenchSecretKey(i));
+            publicKeys.push_back(secretKeys.back().GetPublicKey());
+            hashes.push_back(BenchHash("bls bench message", i));
+            sigsSameHash.push_back(secretKeys.back().Sign(hashes.front()));
+            sigsOwnHash.push_back(secretKeys.back().Sign(hashes.back()));
+        }
+    }
+};
+
+} // namespace
+
+static void BLS_Sign(benchmark::State& state)
+{
+    CBLSSecretKey sk = BenchSecretKey(0);
+    uint256 hash = BenchHash("bls bench message", 0);
+
+    while (state.KeepRunning()) {
+        sk.Sign(hash);
+    }
+}
+
+static void BLS_Verify(benchmark::State& state)
+{
+    CBLSSecretKey sk = BenchSecretKey(0);
+    CBLSPublicKey pk = sk.GetPublicKey();
+    uint256 hash = BenchHash("bls bench message", 0);
+    CBLSSignature sig = sk.Sign(hash);
+
+    while (state.KeepRunning()) {
+        bool fValid = sig.VerifyInsecure(pk, hash);
+        assert(fValid);
+    }
+}
+
+static void BLS_AggregatePublicKeys(benchmark::State& state)
+{
+    BLSQuorumSetup setup;
+
+    while (state.KeepRunning()) {
+        CBLSPublicKey::AggregateInsecure(setup.publicKeys);
+    }
+}
+
+static void BLS_AggregateSignatures(benchmark::State& state)
+{
+    BLSQuorumSetup setup;
+
+    while (state.KeepRunning()) {
+        CBLSSignature::AggregateInsecure(setup.sigsSameHash);
+    }
+}
+
+// Verification of the aggregated signature of the quorum members on one hash
+static void BLS_VerifySecureAggregated(benchmark::State& state)
+{
+    BLSQuorumSetup setup;
+    CBLSSignature sig = CBLSSignature::AggregateSecure(setup.sigsSameHash, setup.publicKeys, setup.hashes.front());
+
+    while (state.KeepRunning()) {
+        bool fValid = sig.VerifySecureAggregated(setup.publicKeys, setup.hashes.front());
+        assert(fValid);
+    }
+}
+
+// Verification of the aggregated signatures of the quorum members on different hashes
+static void BLS_VerifyInsecureAggregated(benchmark::State& state)
+{
+    BLSQuorumSetup setup;
+    CBLSSignature sig = CBLSSignature::AggregateInsecure(setup.sigsOwnHash);
+
+    while (state.KeepRunning()) {
+        bool fValid = sig.VerifyInsecureAggregated(setup.publicKeys, setup.hashes);
+        assert(fValid);
+    }
+}
+
+BENCHMARK(BLS_Sign);
+BENCHMARK(BLS_Verify);
+BENCHMARK(BLS_AggregatePublicKeys);
+BENCHMARK(BLS_AggregateSignatures);
+BENCHMARK(BLS_VerifySecureAggregated);
+BENCHMARK(BLS_VerifyInsecureAggregated);
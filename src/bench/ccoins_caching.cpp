@@ -5,6 +5,7 @@
 #include "bench.h"
 #include "coins.h"
 #include "policy/policy.h"
+#include "random.h"
 #include "wallet/crypter.h"
 
 #include <vector>
@@ -85,3 +86,62 @@ static void CCoinsCaching(benchmark::State& state)
 }
 
 BENCHMARK(CCoinsCaching);
+
+static const uint32_t BENCH_COINS = 10000;
+
+static std::vector<COutPoint> BenchOutpoints(uint32_t nCount)
+{
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(nCount);
+    for (uint32_t i = 0; i < nCount; i++)
+        outpoints.emplace_back(GetRandHash(), i % 4);
+    return outpoints;
+}
+
+static void AddBenchCoins(CCoinsViewCache& cache, const std::vector<COutPoint>& outpoints)
+{
+    for (const COutPoint& outpoint : outpoints)
+        cache.AddCoin(outpoint, Coin(CTxOut(CENT, CScript() << OP_TRUE), 1, false, false), false);
+}
+
+// Fill an empty cache, which is what connecting blocks does between flushes.
+static void CCoinsCacheInsert(benchmark::State& state)
+{
+    CCoinsView coinsDummy;
+    std::vector<COutPoint> outpoints = BenchOutpoints(BENCH_COINS);
+    while (state.KeepRunning()) {
+        CCoinsViewCache cache(&coinsDummy);
+        AddBenchCoins(cache, outpoints);
+    }
+}
+
+static void CCoinsCacheLookup(benchmark::State& state)
+{
+    CCoinsView coinsDummy;
+    CCoinsViewCache cache(&coinsDummy);
+    std::vector<COutPoint> outpoints = BenchOutpoints(BENCH_COINS);
+    AddBenchCoins(cache, outpoints);
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const Coin& coin = cache.AccessCoin(outpoints[i++ % outpoints.size()]);
+        assert(!coin.IsSpent());
+    }
+}
+
+// Flush a filled cache into a parent cache, as the block connection cache does into pcoinsTip.
+static void CCoinsCacheFlush(benchmark::State& state)
+{
+    CCoinsView coinsDummy;
+    CCoinsViewCache parent(&coinsDummy);
+    std::vector<COutPoint> outpoints = BenchOutpoints(BENCH_COINS);
+    while (state.KeepRunning()) {
+        CCoinsViewCache cache(&parent);
+        AddBenchCoins(cache, outpoints);
+        cache.Flush();
+    }
+}
+
+BENCHMARK(CCoinsCacheInsert);
+BENCHMARK(CCoinsCacheLookup);
+BENCHMARK(CCoinsCacheFlush);
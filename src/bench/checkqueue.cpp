@@ -7,6 +7,7 @@
 #include "validation.h"
 #include "checkqueue.h"
 #include "prevector.h"
+#include "crypto/sha256.h"
 #include <vector>
 #include <boost/thread/thread.hpp>
 #include "random.h"
@@ -99,5 +100,56 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::State& state)
     tg.interrupt_all();
     tg.join_all();
 }
+
+// This Benchmark shows how the CheckQueue scales with the number of threads
+// taking part (including the master), using checks that each hash a little
+// data so the scheduling overhead is compared against some real work.
+template <int nThreads>
+static void CCheckQueueScaling(benchmark::State& state)
+{
+    struct HashJob {
+        unsigned char data[64] = {};
+        bool operator()()
+        {
+            unsigned char hash[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(data, sizeof(data)).Finalize(hash);
+            return hash[0] != 0 || hash[1] != 0 || hash[2] != 0 || hash[3] != 0;
+        }
+        void swap(HashJob& x){std::swap(data, x.data);};
+    };
+    CCheckQueue<HashJob> queue {QUEUE_BATCH_SIZE};
+    boost::thread_group tg;
+    for (auto x = 1; x < nThreads; ++x) {
+       tg.create_thread([&]{queue.Thread();});
+    }
+    while (state.KeepRunning()) {
+        CCheckQueueControl<HashJob> control(&queue);
+        for (size_t nBatch = 0; nBatch < BATCHES; ++nBatch) {
+            std::vector<HashJob> vChecks(BATCH_SIZE);
+            for (size_t x = 0; x < BATCH_SIZE; ++x)
+                vChecks[x].data[0] = (unsigned char)(nBatch + x);
+            control.Add(vChecks);
+        }
+        control.Wait();
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+static void CCheckQueueScaling1(benchmark::State& state) { CCheckQueueScaling<1>(state); }
+static void CCheckQueueScaling2(benchmark::State& state) { CCheckQueueScaling<2>(state); }
+static void CCheckQueueScaling4(benchmark::State& state) { CCheckQueueScaling<4>(state); }
+static void CCheckQueueScaling8(benchmark::State& state) { CCheckQueueScaling<8>(state); }
+static void CCheckQueueScaling16(benchmark::State& state) { CCheckQueueScaling<16>(state); }
+static void CCheckQueueScaling32(benchmark::State& state) { CCheckQueueScaling<32>(state); }
+static void CCheckQueueScaling64(benchmark::State& state) { CCheckQueueScaling<64>(state); }
+
 BENCHMARK(CCheckQueueSpeed);
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
+BENCHMARK(CCheckQueueScaling1);
+BENCHMARK(CCheckQueueScaling2);
+BENCHMARK(CCheckQueueScaling4);
+BENCHMARK(CCheckQueueScaling8);
+BENCHMARK(CCheckQueueScaling16);
+BENCHMARK(CCheckQueueScaling32);
+BENCHMARK(CCheckQueueScaling64);
@@ -6,7 +6,9 @@
 
 #include "bench.h"
 #include "bloom.h"
+#include "chainparams.h"
 #include "hash.h"
+#include "primitives/block.h"
 #include "uint256.h"
 #include "utiltime.h"
 #include "crypto/ripemd160.h"
@@ -51,6 +53,36 @@ static void SHA256_32b(benchmark::State& state)
     }
 }
 
+static void SHA256D64_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(64 * 1024);
+    while (state.KeepRunning())
+        SHA256D64(in.data(), in.data(), 1024);
+}
+
+// The same hashes with each of the implementations SHA256AutoDetect may pick,
+// falling back to the generic one where the CPU lacks the instructions
+static void SHA256Using(benchmark::State& state, sha256_implementation::UseImplementation implementation)
+{
+    SHA256AutoDetect(implementation);
+    SHA256(state);
+    SHA256AutoDetect();
+}
+
+static void SHA256D64Using(benchmark::State& state, sha256_implementation::UseImplementation implementation)
+{
+    SHA256AutoDetect(implementation);
+    SHA256D64_1024(state);
+    SHA256AutoDetect();
+}
+
+static void SHA256_STANDARD(benchmark::State& state) { SHA256Using(state, sha256_implementation::STANDARD); }
+static void SHA256_SHANI(benchmark::State& state) { SHA256Using(state, sha256_implementation::USE_SHANI); }
+static void SHA256D64_1024_STANDARD(benchmark::State& state) { SHA256D64Using(state, sha256_implementation::STANDARD); }
+static void SHA256D64_1024_SSE41(benchmark::State& state) { SHA256D64Using(state, sha256_implementation::USE_SSE41); }
+static void SHA256D64_1024_AVX2(benchmark::State& state) { SHA256D64Using(state, sha256_implementation::USE_AVX2); }
+static void SHA256D64_1024_SHANI(benchmark::State& state) { SHA256D64Using(state, sha256_implementation::USE_SHANI); }
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -69,10 +101,38 @@ static void SipHash_32b(benchmark::State& state)
     }
 }
 
+// PoW hashes of a chain of headers on top of the mainnet genesis block, so the
+// order of the algorithms taken from the previous block hash varies as on the chain
+static void HashX16RV2_Header(benchmark::State& state)
+{
+    const CBlock& genesis = Params(CBaseChainParams::MAIN).GenesisBlock();
+    std::vector<CBlockHeader> headers(16, genesis.GetBlockHeader());
+    uint256 hashPrevBlock = genesis.GetHash();
+    for (size_t i = 0; i < headers.size(); i++) {
+        headers[i].hashPrevBlock = hashPrevBlock;
+        headers[i].nTime += (i + 1) * 300;
+        headers[i].nNonce = i;
+        hashPrevBlock = headers[i].GetHash();
+    }
+
+    while (state.KeepRunning()) {
+        for (const CBlockHeader& header : headers)
+            header.GetPoWHash();
+    }
+}
+
 BENCHMARK(RIPEMD160);
 BENCHMARK(SHA1);
 BENCHMARK(SHA256);
 BENCHMARK(SHA512);
 
 BENCHMARK(SHA256_32b);
+BENCHMARK(SHA256D64_1024);
+BENCHMARK(SHA256_STANDARD);
+BENCHMARK(SHA256_SHANI);
+BENCHMARK(SHA256D64_1024_STANDARD);
+BENCHMARK(SHA256D64_1024_SSE41);
+BENCHMARK(SHA256D64_1024_AVX2);
+BENCHMARK(SHA256D64_1024_SHANI);
 BENCHMARK(SipHash_32b);
+BENCHMARK(HashX16RV2_Header);
@@ -0,0 +1,71 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "evo/deterministicmns.h"
+#include "hash.h"
+#include "pubkey.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+const size_t BENCH_MN_COUNT = 1000;
+
+uint256 BenchHash(const std::string& tag, size_t i)
+{
+    CHashWriter hasher(SER_GETHASH, 0);
+    hasher << tag << (uint64_t)i;
+    return hasher.GetHash();
+}
+
+/** A list of confirmed masternodes, the same on every run */
+CDeterministicMNList BenchMNList(size_t count)
+{
+    CDeterministicMNList mnList(BenchHash("dmn bench block", 0), 1, count);
+    for (size_t i = 0; i < count; i++) {
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = BenchHash("dmn bench protx", i);
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(dmn->proTxHash, 0);
+        dmn->nOperatorReward = 0;
+
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        dmnState->nRegisteredHeight = 1;
+        dmnState->keyIDOwner = CKeyID(Hash160(dmn->proTxHash.begin(), dmn->proTxHash.end()));
+        dmnState->UpdateConfirmedHash(dmn->proTxHash, BenchHash("dmn bench confirmed", i));
+        dmn->pdmnState = dmnState;
+
+        mnList.AddMN(dmn);
+    }
+    return mnList;
+}
+
+void CalculateQuorum(benchmark::State& state, size_t quorumSize)
+{
+    CDeterministicMNList mnList = BenchMNList(BENCH_MN_COUNT);
+    uint256 modifier = BenchHash("dmn bench modifier", 0);
+
+    while (state.KeepRunning()) {
+        mnList.CalculateQuorum(quorumSize, modifier);
+    }
+}
+
+} // namespace
+
+// Selection of the members of a LLMQ_50_60 and a LLMQ_400_60 quorum out of the masternode list
+static void DeterministicMNList_CalculateQuorum50(benchmark::State& state)
+{
+    CalculateQuorum(state, 50);
+}
+
+static void DeterministicMNList_CalculateQuorum400(benchmark::State& state)
+{
+    CalculateQuorum(state, 400);
+}
+
+BENCHMARK(DeterministicMNList_CalculateQuorum50);
+BENCHMARK(DeterministicMNList_CalculateQuorum400);
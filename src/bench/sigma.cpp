@@ -0,0 +1,196 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "ctpl.h"
+#include "sigma.h"
+#include "sigma/coin.h"
+#include "sigma/sigmaplus_prover.h"
+#include "sigma/sigmaplus_verifier.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <vector>
+
+static std::vector<sigma::PublicCoin> RandomMints(size_t count)
+{
+    std::vector<sigma::PublicCoin> mints;
+    mints.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        secp_primitives::GroupElement value;
+        value.randomize();
+        mints.emplace_back(value, sigma::CoinDenomination::SIGMA_DENOM_1);
+    }
+    return mints;
+}
+
+// Sorting of mints of a mint-heavy block
+static void SigmaTxInfoComplete(benchmark::State& state)
+{
+    std::vector<sigma::PublicCoin> mints = RandomMints(1000);
+
+    while (state.KeepRunning()) {
+        sigma::CSigmaTxInfo info;
+        info.mints = mints;
+        info.Complete();
+    }
+}
+
+static void SigmaPublicCoinHash(benchmark::State& state)
+{
+    std::vector<sigma::PublicCoin> mints = RandomMints(1000);
+    sigma::CPublicCoinHash hasher;
+    size_t sum = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& mint : mints) {
+            sigma::PublicCoin coin(mint.getValue(), mint.getDenomination());
+            sum += hasher(coin);
+        }
+    }
+}
+
+// Copying an anonymity set, which costs one allocation per element unless points are stored inline
+static void SigmaAnonymitySetCopy(benchmark::State& state)
+{
+    std::vector<secp_primitives::GroupElement> set(10000);
+    for (auto& element : set)
+        element.randomize();
+
+    while (state.KeepRunning()) {
+        std::vector<secp_primitives::GroupElement> copy(set);
+        copy.swap(set);
+    }
+}
+
+namespace {
+
+typedef secp_primitives::Scalar Scalar;
+typedef secp_primitives::GroupElement GroupElement;
+
+/** Random generators and an anonymity set of N commitments, one of which can be spent */
+struct SigmaProofSetup
+{
+    const int n, m;
+    const std::size_t index;
+    const bool fPadding;
+    GroupElement g;
+    std::vector<GroupElement> h_gens;
+    std::vector<GroupElement> commits;
+    Scalar r;
+
+    SigmaProofSetup(int nIn, int mIn, std::size_t N)
+        : n(nIn), m(mIn), index(N / 3), fPadding(N != std::pow(nIn, mIn)), h_gens(nIn * mIn), commits(N)
+    {
+        g.randomize();
+        for (auto& h : h_gens)
+            h.randomize();
+
+        r.randomize();
+        for (std::size_t i = 0; i < N; i++) {
+            if (i == index)
+                commits[i] = sigma::SigmaPrimitives<Scalar, GroupElement>::commit(g, Scalar(uint64_t(0)), h_gens[0], r);
+            else
+                commits[i].randomize();
+        }
+    }
+
+    sigma::SigmaPlusProof<Scalar, GroupElement> Prove() const
+    {
+        sigma::SigmaPlusProver<Scalar, GroupElement> prover(g, h_gens, n, m);
+        sigma::SigmaPlusProof<Scalar, GroupElement> proof(n, m);
+        prover.proof(commits, index, r, fPadding, proof);
+        return proof;
+    }
+};
+
+void SigmaProofVerify(benchmark::State& state, int n, int m, std::size_t N)
+{
+    SigmaProofSetup setup(n, m, N);
+    sigma::SigmaPlusProof<Scalar, GroupElement> proof = setup.Prove();
+
+    sigma::SigmaPlusVerifier<Scalar, GroupElement> verifier(setup.g, setup.h_gens, n, m);
+    assert(verifier.verify(setup.commits, proof, setup.fPadding));
+
+    while (state.KeepRunning()) {
+        verifier.verify(setup.commits, proof, setup.fPadding);
+    }
+}
+
+/** The multiexp of a full anonymity set, as done by proof verification */
+void SigmaMultiExponent(benchmark::State& state, std::size_t nTasks)
+{
+    std::vector<GroupElement> points(16384);
+    std::vector<Scalar> scalars(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        points[i].randomize();
+        scalars[i].randomize();
+    }
+
+    ctpl::thread_pool pool(nTasks);
+    RenameThreadPool(pool, "bench-multiexp");
+    secp_primitives::MultiExponent::TaskRunner runner = [&pool](const std::vector<std::function<void()>>& tasks) {
+        std::vector<std::future<void>> futures;
+        for (const auto& task : tasks)
+            futures.push_back(pool.push([&task](int) { task(); }));
+        for (auto& future : futures)
+            future.get();
+    };
+
+    secp_primitives::MultiExponent mult(points.data(), scalars.data(), points.size());
+    while (state.KeepRunning()) {
+        if (nTasks > 1)
+            mult.get_multiple(runner, nTasks);
+        else
+            mult.get_multiple();
+    }
+}
+
+} // namespace
+
+// Verification of a proof over a small anonymity set, dominated by scalar and point temporaries
+static void SigmaProofVerifySmall(benchmark::State& state)
+{
+    SigmaProofVerify(state, 4, 4, 256);
+}
+
+// Verification over a padded set of a few thousand coins, where the exponents of the set take a noticeable part
+static void SigmaProofVerifyPadded(benchmark::State& state)
+{
+    SigmaProofVerify(state, 16, 3, 4000);
+}
+
+static void SigmaProofCreate(benchmark::State& state)
+{
+    SigmaProofSetup setup(16, 3, 4000);
+
+    while (state.KeepRunning()) {
+        setup.Prove();
+    }
+}
+
+static void SigmaMultiExponentSerial(benchmark::State& state)
+{
+    SigmaMultiExponent(state, 1);
+}
+
+// Split between as many tasks as there are cores
+static void SigmaMultiExponentParallel(benchmark::State& state)
+{
+    SigmaMultiExponent(state, std::max(2, GetNumCores()));
+}
+
+BENCHMARK(SigmaTxInfoComplete);
+BENCHMARK(SigmaPublicCoinHash);
+BENCHMARK(SigmaAnonymitySetCopy);
+BENCHMARK(SigmaProofVerifySmall);
+BENCHMARK(SigmaProofVerifyPadded);
+BENCHMARK(SigmaProofCreate);
+BENCHMARK(SigmaMultiExponentSerial);
+BENCHMARK(SigmaMultiExponentParallel);
@@ -0,0 +1,241 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "hash.h"
+#include "primitives/transaction.h"
+#include "primitives/zerocoin.h"
+#include "sigma.h"
+#include "sigma/coinspend.h"
+#include "streams.h"
+#include "version.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sigma_bench {
+#include "bench/data/sigma_spend_1000.raw.h"
+#include "bench/data/sigma_spend_8000.raw.h"
+#include "bench/data/sigma_spend_16000.raw.h"
+}
+
+namespace {
+
+typedef secp_primitives::Scalar Scalar;
+typedef secp_primitives::GroupElement GroupElement;
+
+const sigma::CoinDenomination BENCH_DENOMINATION = sigma::CoinDenomination::SIGMA_DENOM_1;
+const int BENCH_GROUP_ID = 1;
+const uint32_t BENCH_MINTS_PER_BLOCK = 100;
+
+/**
+ * A sigma spend of one coin out of an anonymity set of nSetSize mints, loaded
+ * from one of the bench/data/sigma_spend_*.raw fixtures.
+ *
+ * A fixture holds, serialized with SER_NETWORK, the set size, the position of
+ * the spent coin in the set, the serial, randomness and ecdsa key of the coin
+ * and the spend transaction. The other mints of the set are derived from the
+ * set size and their position. The proofs use the generators of
+ * sigma::Params::get_default() outside of testnet.
+ *
+ * The set is in the order CSigmaState hands it out, by CheckSigmaTransaction
+ * and GetCoinSetForSpend: the mints of the last block first, going back to
+ * the first block. The spend refers to the last block, and the hashes of the
+ * blocks are derived from the set size and their height in the group. The
+ * fixtures are made by contrib/testgen/gen_sigma_spend_bench_fixtures.cpp.
+ */
+struct SigmaSpendFixture
+{
+    const sigma::Params* params;
+    uint32_t nSetSize;
+    uint32_t nCoinIndex;
+    std::unique_ptr<sigma::PrivateCoin> coin;
+    std::vector<sigma::PublicCoin> anonymitySet;
+    std::unique_ptr<CTransaction> tx;
+    std::unique_ptr<sigma::CoinSpend> spend;
+    std::unique_ptr<sigma::SpendMetaData> metaData;
+
+    SigmaSpendFixture(const unsigned char* data, size_t size) : params(sigma::Params::get_default())
+    {
+        CDataStream stream((const char*)data, (const char*)data + size, SER_NETWORK, PROTOCOL_VERSION);
+
+        Scalar serial, randomness;
+        uint256 ecdsaSeckey;
+        CMutableTransaction mtx;
+        stream >> nSetSize >> nCoinIndex >> serial >> randomness >> ecdsaSeckey >> mtx;
+        tx.reset(new CTransaction(mtx));
+
+        coin.reset(new sigma::PrivateCoin(params, BENCH_DENOMINATION, ZEROCOIN_TX_VERSION_3_1));
+        coin->setSerialNumber(serial);
+        coin->setRandomness(randomness);
+        coin->setEcdsaSeckey(ecdsaSeckey);
+
+        anonymitySet.reserve(nSetSize);
+        for (uint32_t i = 0; i < nSetSize; i++) {
+            if (i == nCoinIndex)
+                anonymitySet.emplace_back(sigma::SigmaPrimitives<Scalar, GroupElement>::commit(
+                    params->get_g(), serial, params->get_h0(), randomness), BENCH_DENOMINATION);
+            else
+                anonymitySet.emplace_back(DeriveMint(nSetSize, i), BENCH_DENOMINATION);
+        }
+        coin->setPublicCoin(anonymitySet[nCoinIndex]);
+
+        std::tie(spend, std::ignore) = sigma::ParseSigmaSpend(tx->vin[0]);
+
+        // the spend is bound to the transaction without its spend scripts
+        CMutableTransaction txUnsigned(*tx);
+        txUnsigned.vin[0].scriptSig.clear();
+        metaData.reset(new sigma::SpendMetaData(BENCH_GROUP_ID, GetBlockHash(GetBlockCount() - 1), txUnsigned.GetHash()));
+
+        assert(spend->getAccumulatorBlockHash() == metaData->blockHash);
+        assert(spend->Verify(anonymitySet, *metaData, true));
+    }
+
+    uint32_t GetBlockCount() const
+    {
+        return (nSetSize + BENCH_MINTS_PER_BLOCK - 1) / BENCH_MINTS_PER_BLOCK;
+    }
+
+    /** The positions in the set of the mints of block nBlock of the group, counted from the first block */
+    std::pair<uint32_t, uint32_t> GetBlockMints(uint32_t nBlock) const
+    {
+        uint32_t nFromLast = GetBlockCount() - 1 - nBlock;
+        return std::make_pair(nFromLast * BENCH_MINTS_PER_BLOCK, std::min((nFromLast + 1) * BENCH_MINTS_PER_BLOCK, nSetSize));
+    }
+
+    uint256 GetBlockHash(uint32_t nBlock) const
+    {
+        CHashWriter hasher(SER_GETHASH, 0);
+        hasher << std::string("sigma bench block") << nSetSize << nBlock;
+        return hasher.GetHash();
+    }
+
+    static GroupElement DeriveMint(uint32_t nSetSize, uint32_t i)
+    {
+        CHashWriter hasher(SER_GETHASH, 0);
+        hasher << std::string("sigma bench mint") << nSetSize << i;
+        uint256 hash = hasher.GetHash();
+
+        GroupElement mint;
+        mint.generate(hash.begin());
+        return mint;
+    }
+};
+
+/** The blocks minting the anonymity set of a fixture, added to the sigma state for as long as it lives */
+struct SigmaSpendChain
+{
+    std::vector<uint256> hashes;
+    std::vector<std::unique_ptr<CBlockIndex>> blocks;
+
+    SigmaSpendChain(const SigmaSpendFixture& fixture, int nStartHeight)
+    {
+        sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+        sigmaState->Reset();
+
+        hashes.reserve(fixture.GetBlockCount());
+        for (uint32_t i = 0; i < fixture.GetBlockCount(); i++) {
+            hashes.push_back(fixture.GetBlockHash(i));
+
+            CBlockIndex* pindex = new CBlockIndex();
+            pindex->nHeight = nStartHeight + i;
+            pindex->phashBlock = &hashes.back();
+            pindex->pprev = blocks.empty() ? NULL : blocks.back().get();
+
+            std::pair<uint32_t, uint32_t> mints = fixture.GetBlockMints(i);
+            pindex->sigmaMintedPubCoins[std::make_pair(BENCH_DENOMINATION, BENCH_GROUP_ID)].assign(
+                fixture.anonymitySet.begin() + mints.first, fixture.anonymitySet.begin() + mints.second);
+
+            blocks.emplace_back(pindex);
+            sigmaState->AddBlock(pindex);
+        }
+    }
+
+    ~SigmaSpendChain()
+    {
+        sigma::CSigmaState::GetState()->Reset();
+    }
+};
+
+void SigmaSpendVerify(benchmark::State& state, const unsigned char* data, size_t size)
+{
+    SigmaSpendFixture fixture(data, size);
+
+    while (state.KeepRunning()) {
+        fixture.spend->Verify(fixture.anonymitySet, *fixture.metaData, true);
+    }
+}
+
+void SigmaSpendCreate(benchmark::State& state, const unsigned char* data, size_t size)
+{
+    SigmaSpendFixture fixture(data, size);
+
+    while (state.KeepRunning()) {
+        sigma::CoinSpend spend(fixture.params, *fixture.coin, fixture.anonymitySet, *fixture.metaData, true);
+    }
+}
+
+} // namespace
+
+// Verification of the spend of a coin, mostly SigmaPlusVerifier::verify, for sets
+// of a few blocks of mints, of half a group and of a full group
+static void SigmaSpendVerify1000(benchmark::State& state)
+{
+    SigmaSpendVerify(state, sigma_bench::sigma_spend_1000, sizeof(sigma_bench::sigma_spend_1000));
+}
+
+static void SigmaSpendVerify8000(benchmark::State& state)
+{
+    SigmaSpendVerify(state, sigma_bench::sigma_spend_8000, sizeof(sigma_bench::sigma_spend_8000));
+}
+
+static void SigmaSpendVerify16000(benchmark::State& state)
+{
+    SigmaSpendVerify(state, sigma_bench::sigma_spend_16000, sizeof(sigma_bench::sigma_spend_16000));
+}
+
+// Creation of the spend by the wallet, mostly SigmaPlusProver::proof
+static void SigmaSpendCreate1000(benchmark::State& state)
+{
+    SigmaSpendCreate(state, sigma_bench::sigma_spend_1000, sizeof(sigma_bench::sigma_spend_1000));
+}
+
+static void SigmaSpendCreate16000(benchmark::State& state)
+{
+    SigmaSpendCreate(state, sigma_bench::sigma_spend_16000, sizeof(sigma_bench::sigma_spend_16000));
+}
+
+// Contextual check of the spend transaction of a full group, as done for a transaction
+// of a new block, including building the anonymity set from the block index
+static void SigmaCheckSpendTransaction(benchmark::State& state)
+{
+    SigmaSpendFixture fixture(sigma_bench::sigma_spend_16000, sizeof(sigma_bench::sigma_spend_16000));
+
+    const Consensus::Params& consensus = Params().GetConsensus();
+    int nStartHeight = std::max(consensus.nSigmaStartBlock, consensus.nSigmaPaddingBlock);
+    SigmaSpendChain chain(fixture, nStartHeight);
+    int nHeight = nStartHeight + fixture.GetBlockCount();
+
+    while (state.KeepRunning()) {
+        CValidationState validationState;
+        sigma::CSigmaTxInfo sigmaTxInfo;
+        bool fValid = sigma::CheckSigmaTransaction(*fixture.tx, validationState, fixture.tx->GetHash(), false, nHeight, false, true, &sigmaTxInfo);
+        assert(fValid);
+    }
+}
+
+BENCHMARK(SigmaSpendVerify1000);
+BENCHMARK(SigmaSpendVerify8000);
+BENCHMARK(SigmaSpendVerify16000);
+BENCHMARK(SigmaSpendCreate1000);
+BENCHMARK(SigmaSpendCreate16000);
+BENCHMARK(SigmaCheckSpendTransaction);
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "libzerocoin/Zerocoin.h"
+#include "zerocoin.h"
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// The mint, accumulate, spend and verify sequence of libzerocoin/Benchmark.cpp
+// on the parameters of the current zerocoin version
+struct ZerocoinSpendSetup
+{
+    const libzerocoin::Params* params;
+    std::vector<std::unique_ptr<libzerocoin::PrivateCoin>> coins;
+    libzerocoin::Accumulator accumulator;
+    libzerocoin::AccumulatorWitness witness;
+    libzerocoin::SpendMetaData metaData;
+    std::unique_ptr<libzerocoin::CoinSpend> spend;
+
+    ZerocoinSpendSetup(size_t nCoins) :
+        params(ZCParamsV2),
+        accumulator(&params->accumulatorParams, libzerocoin::ZQ_LOVELACE),
+        witness(params, accumulator, Mint(params, coins)),
+        metaData(arith_uint256(0), uint256())
+    {
+        for (size_t i = 1; i < nCoins; i++) {
+            coins.emplace_back(new libzerocoin::PrivateCoin(params, libzerocoin::ZQ_LOVELACE, ZEROCOIN_TX_VERSION_2));
+            witness += coins.back()->getPublicCoin();
+        }
+        for (const auto& coin : coins)
+            accumulator += coin->getPublicCoin();
+
+        spend.reset(new libzerocoin::CoinSpend(params, *coins.front(), accumulator, witness, metaData));
+    }
+
+    // The coin the witness is for, minted ahead of the witness member
+    static libzerocoin::PublicCoin Mint(const libzerocoin::Params* params, std::vector<std::unique_ptr<libzerocoin::PrivateCoin>>& coins)
+    {
+        coins.emplace_back(new libzerocoin::PrivateCoin(params, libzerocoin::ZQ_LOVELACE, ZEROCOIN_TX_VERSION_2));
+        return coins.back()->getPublicCoin();
+    }
+};
+
+} // namespace
+
+static void ZerocoinAccumulate(benchmark::State& state)
+{
+    ZerocoinSpendSetup setup(10);
+
+    while (state.KeepRunning()) {
+        libzerocoin::Accumulator accumulator(&setup.params->accumulatorParams, libzerocoin::ZQ_LOVELACE);
+        for (const auto& coin : setup.coins)
+            accumulator += coin->getPublicCoin();
+    }
+}
+
+static void ZerocoinSpendVerify(benchmark::State& state)
+{
+    ZerocoinSpendSetup setup(10);
+
+    while (state.KeepRunning()) {
+        bool fValid = setup.spend->Verify(setup.accumulator, setup.metaData);
+        assert(fValid);
+    }
+}
+
+// Exponentiations of the generator of the serial number group, with the
+// precomputed table and with a plain modular exponentiation
+static void ZerocoinGroupPowFixedBase(benchmark::State& state)
+{
+    const libzerocoin::IntegerGroupParams& group = ZCParamsV2->serialNumberSoKCommitmentGroup;
+    CBigNum exponent = CBigNum::randBignum(group.groupOrder);
+
+    while (state.KeepRunning()) {
+        group.powG(exponent);
+    }
+}
+
+static void ZerocoinGroupPowPlain(benchmark::State& state)
+{
+    const libzerocoin::IntegerGroupParams& group = ZCParamsV2->serialNumberSoKCommitmentGroup;
+    CBigNum exponent = CBigNum::randBignum(group.groupOrder);
+
+    while (state.KeepRunning()) {
+        group.g.pow_mod(exponent, group.modulus);
+    }
+}
+
+BENCHMARK(ZerocoinAccumulate);
+BENCHMARK(ZerocoinSpendVerify);
+BENCHMARK(ZerocoinGroupPowFixedBase);
+BENCHMARK(ZerocoinGroupPowPlain);
@@ -0,0 +1,98 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockprefetch.h"
+
+#include "chain.h"
+#include "util.h"
+#include "validation.h"
+
+#include <algorithm>
+
+namespace {
+
+std::shared_ptr<CPrefetchedBlock> ReadPrefetchedBlock(CBlockIndex* pindex, const CDiskBlockPos& pos, const CDiskBlockPos& undoPos, const uint256& hashPrev,
+                                                      const Consensus::Params& consensusParams, const CBlockPrefetcher::ProcessFn& process)
+{
+    auto result = std::make_shared<CPrefetchedBlock>(pindex);
+    if (!ReadBlockFromDisk(*result->block, pos, pindex->nHeight, consensusParams))
+        return result;
+    if (result->block->GetHash() != pindex->GetBlockHash()) {
+        error("%s: GetHash() doesn't match index for %s at %s", __func__, pindex->ToString(), pos.ToString());
+        return result;
+    }
+    result->fRead = true;
+
+    if (!undoPos.IsNull())
+        result->fUndoRead = UndoReadFromDisk(result->undo, undoPos, hashPrev);
+
+    if (process)
+        process(*result);
+    return result;
+}
+
+} // namespace
+
+CBlockPrefetcher::CBlockPrefetcher(const Consensus::Params& consensusParamsIn, CBlockIndex* pindexFirst, NextFn nextIn, const char* threadName,
+                                   int nThreadsIn, bool fReadUndoIn, ProcessFn processIn) :
+    consensusParams(consensusParamsIn),
+    next(nextIn),
+    process(processIn),
+    fReadUndo(fReadUndoIn),
+    nThreads(nThreadsIn > 0 ? nThreadsIn : std::max(1, (int)GetArg("-blockprefetchthreads", DEFAULT_BLOCK_PREFETCH_THREADS))),
+    pindexPrefetch(pindexFirst),
+    workerPool(nThreads)
+{
+    RenameThreadPool(workerPool, threadName);
+    Fill();
+}
+
+CBlockPrefetcher::~CBlockPrefetcher()
+{
+    // The futures of reads in flight do not wait for them, the pool does
+    workerPool.stop(true);
+}
+
+void CBlockPrefetcher::Fill()
+{
+    while (pindexPrefetch && prefetched.size() < (size_t)MAX_BLOCK_PREFETCH_BLOCKS) {
+        CBlockIndex* pindexRead = pindexPrefetch;
+        CDiskBlockPos pos = pindexRead->GetBlockPos();
+        CDiskBlockPos undoPos;
+        uint256 hashPrev;
+        if (fReadUndo && pindexRead->pprev) {
+            undoPos = pindexRead->GetUndoPos();
+            hashPrev = pindexRead->pprev->GetBlockHash();
+        }
+        const Consensus::Params& params = consensusParams;
+        const ProcessFn& processRef = process;
+        prefetched.emplace_back(pindexRead, workerPool.push([pindexRead, pos, undoPos, hashPrev, &params, &processRef](int) {
+            return ReadPrefetchedBlock(pindexRead, pos, undoPos, hashPrev, params, processRef);
+        }));
+        pindexPrefetch = next(pindexPrefetch);
+    }
+}
+
+std::shared_ptr<CPrefetchedBlock> CBlockPrefetcher::Next()
+{
+    if (prefetched.empty())
+        return nullptr;
+
+    std::shared_ptr<CPrefetchedBlock> result = prefetched.front().second.get();
+    prefetched.pop_front();
+    Fill();
+    return result;
+}
+
+std::shared_ptr<CPrefetchedBlock> CBlockPrefetcher::Take(const CBlockIndex* pindex)
+{
+    if (prefetched.empty() || prefetched.front().first != pindex)
+        return nullptr;
+    return Next();
+}
+
+CBlockIndex* CBlockPrefetcher::Peek() const
+{
+    return prefetched.empty() ? nullptr : prefetched.front().first;
+}
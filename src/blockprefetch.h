@@ -0,0 +1,116 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKPREFETCH_H
+#define BITCOIN_BLOCKPREFETCH_H
+
+#include "coins.h"
+#include "ctpl.h"
+#include "primitives/block.h"
+#include "undo.h"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+class CBlockIndex;
+
+namespace Consensus { struct Params; }
+
+//! Number of threads reading blocks ahead of -reindex-chainstate, verifychain and similar long scans
+static const int DEFAULT_BLOCK_PREFETCH_THREADS = 4;
+//! Max number of blocks read ahead of the consumer
+static const int MAX_BLOCK_PREFETCH_BLOCKS = 64;
+//! Min number of blocks to connect for ActivateBestChain to read them ahead
+static const int MIN_BLOCK_PREFETCH_DISTANCE = 16;
+
+/** A block, and optionally its undo data, read ahead of its consumer */
+struct CPrefetchedBlock
+{
+    CBlockIndex* pindex;
+    std::shared_ptr<CBlock> block;
+    bool fRead;
+    //! Left empty when no undo data was asked for or the block has none
+    CBlockUndo undo;
+    bool fUndoRead;
+    //! Per transaction flags, for the process function to pass its results to the consumer
+    std::vector<bool> vTxFlags;
+
+    CPrefetchedBlock(CBlockIndex* pindexIn) : pindex(pindexIn), block(std::make_shared<CBlock>()), fRead(false), fUndoRead(false) {}
+};
+
+/**
+ * Reads blocks from disk on a pool of worker threads ahead of a consumer that
+ * goes through them one at a time, like a rescan, verifychain or connecting
+ * the blocks of a -reindex-chainstate. A -reindex gains nothing from it, its
+ * blocks are handed to ActivateBestChain as they are loaded, so there are
+ * hardly ever enough of them to read ahead. The workers deserialize and check
+ * the blocks (and read their undo data if asked to), and can run a function of
+ * the consumer on them, while the consumer gets them in its order with Next().
+ *
+ * The order is given by a function that returns the block to read after the
+ * given one, or NULL at the end. It is only called from the consumer's thread,
+ * in the constructor and in Next(), so it can rely on locks the consumer
+ * holds, cs_main in particular; the positions of the block and undo data on
+ * disk are taken there too. The workers do not lock anything.
+ *
+ * A consumer stopping early just destroys the prefetcher, which waits for the
+ * blocks being read.
+ */
+class CBlockPrefetcher
+{
+public:
+    typedef std::function<CBlockIndex*(const CBlockIndex*)> NextFn;
+    typedef std::function<void(CPrefetchedBlock&)> ProcessFn;
+
+    /**
+     * @param pindexFirst the first block to hand out, NULL for none
+     * @param nThreads    number of worker threads, -blockprefetchthreads if not positive
+     * @param fReadUndo   read the undo data of the blocks as well
+     * @param process     run on every block that was read, on a worker thread
+     */
+    CBlockPrefetcher(const Consensus::Params& consensusParams, CBlockIndex* pindexFirst, NextFn next, const char* threadName,
+                     int nThreads = 0, bool fReadUndo = false, ProcessFn process = ProcessFn());
+    ~CBlockPrefetcher();
+
+    CBlockPrefetcher(const CBlockPrefetcher&) = delete;
+    CBlockPrefetcher& operator=(const CBlockPrefetcher&) = delete;
+
+    /** The next block in order, waiting for it to be read if needed; NULL after the last one */
+    std::shared_ptr<CPrefetchedBlock> Next();
+
+    /**
+     * The block after the previous one if it is pindex, NULL otherwise; for
+     * consumers that know which block they want, and read it themselves when
+     * the prefetcher went a different way. A block that does not match is
+     * handed out again by the next call.
+     */
+    std::shared_ptr<CPrefetchedBlock> Take(const CBlockIndex* pindex);
+
+    /** The block that Next() will hand out, NULL after the last one */
+    CBlockIndex* Peek() const;
+
+    int GetThreads() const { return nThreads; }
+
+private:
+    const Consensus::Params& consensusParams;
+    const NextFn next;
+    const ProcessFn process;
+    const bool fReadUndo;
+    const int nThreads;
+
+    //! Blocks being read, in order
+    std::deque<std::pair<CBlockIndex*, std::future<std::shared_ptr<CPrefetchedBlock>>>> prefetched;
+    //! The next block to start reading
+    CBlockIndex* pindexPrefetch;
+
+    //! Declared last, so the workers are done before anything they use goes away
+    ctpl::thread_pool workerPool;
+
+    void Fill();
+};
+
+#endif // BITCOIN_BLOCKPREFETCH_H
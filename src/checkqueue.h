@@ -6,6 +6,9 @@
 #define BITCOIN_CHECKQUEUE_H
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include <boost/foreach.hpp>
@@ -16,6 +19,9 @@
 template <typename T>
 class CCheckQueueControl;
 
+/** Default number of per-worker deques a CCheckQueue distributes work over. */
+static const unsigned int DEFAULT_CHECKQUEUE_SLOTS = 65;
+
 /** 
  * Queue for verifications that have to be performed.
   * The verifications are represented by a type T, which must provide an
@@ -25,12 +31,25 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Every worker owns a deque of its own (the master uses slot 0). Added
+  * checks are spread over the deques of the registered workers, a worker
+  * pops batches from the back of its own deque and, once that runs dry,
+  * steals half of another worker's deque from the front. The shared mutex
+  * is only taken to sleep and to wake up, so cheap checks no longer
+  * serialize on it.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! A per-worker deque, guarded by its own (rarely contended) mutex
+    struct Slot {
+        boost::mutex mutex;
+        std::deque<T> queue;
+    };
+
+    //! Mutex to protect the sleeping/waking state
     boost::mutex mutex;
 
     //! Worker threads block on this when out of work
@@ -39,25 +58,33 @@ private:
     //! Master thread blocks on this when out of work
     boost::condition_variable condMaster;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue;
+    //! The per-worker deques. Slot 0 belongs to whichever thread is the master.
+    std::vector<std::unique_ptr<Slot>> vSlots;
+
+    //! The number of worker threads that ever registered, used to pick their slot.
+    std::atomic<unsigned int> nWorkers;
+
+    //! Round-robin cursor used by Add to pick the next slot (master only).
+    unsigned int nNextSlot;
 
     //! The number of workers (including the master) that are idle.
-    int nIdle;
+    std::atomic<int> nIdle;
 
     //! The total number of workers (including the master).
-    int nTotal;
+    std::atomic<int> nTotal;
 
     //! The temporary evaluation result.
-    bool fAllOk;
+    std::atomic<bool> fAllOk;
 
     /**
      * Number of verifications that haven't completed yet.
      * This includes elements that are no longer queued, but still in the
      * worker's own batches.
      */
-    unsigned int nTodo;
+    std::atomic<unsigned int> nTodo;
+
+    //! Number of verifications still sitting in one of the deques.
+    std::atomic<unsigned int> nQueued;
 
     //! Whether we're shutting down.
     bool fQuit;
@@ -65,30 +92,70 @@ private:
     //! The maximum number of elements to be processed in one batch
     unsigned int nBatchSize;
 
+    //! Number of slots work is currently spread over: the master plus every registered worker.
+    unsigned int ActiveSlots() const
+    {
+        return std::min((unsigned int)vSlots.size(), nWorkers.load() + 1);
+    }
+
+    /**
+     * Move the next batch of checks for the worker owning nSlot into vChecks.
+     * Returns the number of checks taken, 0 if every deque was empty.
+     */
+    unsigned int Take(unsigned int nSlot, std::vector<T>& vChecks)
+    {
+        {
+            Slot& own = *vSlots[nSlot];
+            boost::unique_lock<boost::mutex> lock(own.mutex);
+            if (!own.queue.empty()) {
+                // Decide how many work units to process now.
+                // * Do not try to do everything at once, but aim for increasingly smaller batches
+                //   (relative to all work still queued) so all workers finish approximately simultaneously.
+                // * Try to account for idle jobs which will instantly start helping.
+                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize or what we own.
+                unsigned int nNow = std::max(1U, std::min({nBatchSize, (unsigned int)own.queue.size(), nQueued.load() / (nTotal + nIdle + 1)}));
+                vChecks.resize(nNow);
+                for (unsigned int i = 0; i < nNow; i++) {
+                    // Swap jobs out of the deque instead of copying them, to keep the lock short.
+                    vChecks[i].swap(own.queue.back());
+                    own.queue.pop_back();
+                }
+                nQueued -= nNow;
+                return nNow;
+            }
+        }
+        // Our own deque is empty: steal half of the first non-empty one, oldest work first.
+        const unsigned int nSlots = ActiveSlots();
+        for (unsigned int n = 1; n < nSlots; n++) {
+            Slot& victim = *vSlots[(nSlot + n) % nSlots];
+            boost::unique_lock<boost::mutex> lock(victim.mutex);
+            if (victim.queue.empty())
+                continue;
+            unsigned int nNow = std::max(1U, std::min(nBatchSize, (unsigned int)(victim.queue.size() + 1) / 2));
+            vChecks.resize(nNow);
+            for (unsigned int i = 0; i < nNow; i++) {
+                vChecks[i].swap(victim.queue.front());
+                victim.queue.pop_front();
+            }
+            nQueued -= nNow;
+            return nNow;
+        }
+        return 0;
+    }
+
     /** Internal function that does bulk of the verification work. */
     bool Loop(bool fMaster = false)
     {
         boost::condition_variable& cond = fMaster ? condMaster : condWorker;
+        const unsigned int nSlot = fMaster ? 0 : 1 + (nWorkers++ % (vSlots.size() - 1));
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
+        nTotal++;
         do {
-            {
+            unsigned int nNow = Take(nSlot, vChecks);
+            if (nNow == 0) {
                 boost::unique_lock<boost::mutex> lock(mutex);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        condMaster.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty()) {
+                while (nQueued == 0) {
                     if ((fMaster || fQuit) && nTodo == 0) {
                         nTotal--;
                         bool fRet = fAllOk;
@@ -102,27 +169,29 @@ private:
                     cond.wait(lock); // wait
                     nIdle--;
                 }
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                vChecks.resize(nNow);
-                for (unsigned int i = 0; i < nNow; i++) {
-                    // We want the lock on the mutex to be as short as possible, so swap jobs from the global
-                    // queue to the local batch vector instead of copying.
-                    vChecks[i].swap(queue.back());
-                    queue.pop_back();
-                }
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+                // Something got queued (or is about to be), go and find it.
+                continue;
+            }
+            if (nQueued > 0 && nIdle > 0) {
+                // There is more than we took; get another worker to steal it.
+                boost::unique_lock<boost::mutex> lock(mutex);
+                condWorker.notify_one();
             }
+            // Check whether we need to do work at all
+            bool fOk = fAllOk;
             // execute work
             BOOST_FOREACH (T& check, vChecks)
                 if (fOk)
                     fOk = check();
+            // Destroy the checks before they are reported as done.
             vChecks.clear();
+            if (!fOk)
+                fAllOk = false;
+            if (nTodo.fetch_sub(nNow) == nNow && !fMaster) {
+                // We processed the last element; inform the master it can exit and return the result
+                boost::unique_lock<boost::mutex> lock(mutex);
+                condMaster.notify_one();
+            }
         } while (true);
     }
 
@@ -131,7 +200,13 @@ public:
     boost::mutex ControlMutex;
 
     //! Create a new check queue
-    CCheckQueue(unsigned int nBatchSizeIn) : nIdle(0), nTotal(0), fAllOk(true), nTodo(0), fQuit(false), nBatchSize(nBatchSizeIn) {}
+    CCheckQueue(unsigned int nBatchSizeIn, unsigned int nSlotsIn = DEFAULT_CHECKQUEUE_SLOTS) : nWorkers(0), nNextSlot(0), nIdle(0), nTotal(0), fAllOk(true), nTodo(0), nQueued(0), fQuit(false), nBatchSize(nBatchSizeIn)
+    {
+        // The master always has slot 0, workers need at least one more.
+        vSlots.resize(std::max(2U, nSlotsIn));
+        for (auto& slot : vSlots)
+            slot.reset(new Slot());
+    }
 
     //! Worker thread
     void Thread()
@@ -148,16 +223,28 @@ public:
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
-        boost::unique_lock<boost::mutex> lock(mutex);
-        BOOST_FOREACH (T& check, vChecks) {
-            queue.push_back(T());
-            check.swap(queue.back());
-        }
+        if (vChecks.empty())
+            return;
+        // Account for the checks before anybody can take them, so nTodo never underflows.
         nTodo += vChecks.size();
-        if (vChecks.size() == 1)
+        // Small batches go to a single deque in turn, large ones are spread over all active deques.
+        const unsigned int nSlots = ActiveSlots();
+        const size_t nChunk = std::max((size_t)1, (vChecks.size() + nSlots - 1) / nSlots);
+        unsigned int nChunks = 0;
+        for (size_t nPos = 0; nPos < vChecks.size(); nPos += nChunk, nChunks++) {
+            Slot& slot = *vSlots[nNextSlot++ % nSlots];
+            boost::unique_lock<boost::mutex> lock(slot.mutex);
+            size_t nEnd = std::min(vChecks.size(), nPos + nChunk);
+            for (size_t i = nPos; i < nEnd; i++) {
+                slot.queue.push_back(T());
+                vChecks[i].swap(slot.queue.back());
+            }
+            nQueued += nEnd - nPos;
+        }
+        // Wake one worker per filled deque; workers that find more work left wake up the next one.
+        boost::unique_lock<boost::mutex> lock(mutex);
+        for (unsigned int i = 0; i < nChunks && (int)i < nIdle; i++)
             condWorker.notify_one();
-        else if (vChecks.size() > 1)
-            condWorker.notify_all();
     }
 
     ~CCheckQueue()
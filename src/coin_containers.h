@@ -24,6 +24,21 @@ struct CMintedCoinInfo {
     int nHeight;
 
     static CMintedCoinInfo make(CoinDenomination denomination,  int coinGroupId, int nHeight);
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        int64_t tmp = int64_t(denomination);
+        s << tmp;
+        s << coinGroupId;
+        s << nHeight;
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        int64_t tmp;
+        s >> tmp; denomination = CoinDenomination(tmp);
+        s >> coinGroupId;
+        s >> nHeight;
+    }
 };
 
 struct CSpendCoinInfo {
@@ -11,6 +11,7 @@
 #include "hash.h"
 #include "memusage.h"
 #include "serialize.h"
+#include "support/allocators/pool.h"
 #include "uint256.h"
 
 #include <assert.h>
@@ -125,7 +126,18 @@ struct CCoinsCacheEntry
     explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+/**
+ * The nodes of the coins cache come from a pool rather than one heap
+ * allocation each. Blocks up to this size are pooled, which covers the map
+ * node (the entry plus the bucket link and cached hash) with some slack for
+ * other standard library implementations.
+ */
+static const size_t COINS_MAP_POOL_BLOCK_SIZE = sizeof(std::pair<const COutPoint, CCoinsCacheEntry>) + 4 * sizeof(void*);
+
+typedef PoolAllocator<std::pair<const COutPoint, CCoinsCacheEntry>, COINS_MAP_POOL_BLOCK_SIZE, alignof(void*)> CCoinsMapAllocator;
+typedef CCoinsMapAllocator::ResourceType CCoinsMapMemoryResource;
+
+typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher, std::equal_to<COutPoint>, CCoinsMapAllocator> CCoinsMap;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -203,6 +215,8 @@ protected:
      * declared as "const".  
      */
     mutable uint256 hashBlock;
+    //! Backs the nodes of cacheCoins, so it has to be declared (and constructed) first
+    mutable CCoinsMapMemoryResource cacheCoinsMemoryResource;
     mutable CCoinsMap cacheCoins;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
@@ -280,6 +294,12 @@ public:
 private:
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
 
+    /**
+     * Give the memory of an empty cache back to the system. The pool keeps
+     * freed nodes for reuse, so clearing the map alone does not shrink it.
+     */
+    void ReallocateCache();
+
     /**
      * By making the copy constructor private, we prevent accidentally using it when one intends to create a cache on top of a base cache.
      */
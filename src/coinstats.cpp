@@ -0,0 +1,105 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinstats.h"
+
+#include "coins.h"
+#include "crypto/chacha20.h"
+#include "crypto/sha256.h"
+#include "primitives/transaction.h"
+#include "streams.h"
+#include "version.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const CBigNum& MuHashModulus()
+{
+    static const CBigNum modulus = (CBigNum(1) << 3072) - CBigNum(1103717);
+    return modulus;
+}
+
+/** Map arbitrary data to a number modulo the MuHash prime */
+CBigNum ToMuHashElement(const unsigned char* data, size_t size)
+{
+    unsigned char key[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data, size).Finalize(key);
+
+    // little endian, with a trailing zero byte so the number is not read as negative
+    std::vector<unsigned char> vch(CMuHash3072::BYTE_SIZE + 1, 0);
+    ChaCha20(key, sizeof(key)).Output(vch.data(), CMuHash3072::BYTE_SIZE);
+    // mul_mod() reduces, the rare value above the modulus needs no special care
+    return CBigNum(vch);
+}
+
+}
+
+CMuHash3072::CMuHash3072() : numerator(1), denominator(1)
+{
+}
+
+void CMuHash3072::Insert(const unsigned char* data, size_t size)
+{
+    numerator = numerator.mul_mod(ToMuHashElement(data, size), MuHashModulus());
+}
+
+void CMuHash3072::Remove(const unsigned char* data, size_t size)
+{
+    denominator = denominator.mul_mod(ToMuHashElement(data, size), MuHashModulus());
+}
+
+CMuHash3072& CMuHash3072::operator*=(const CMuHash3072& other)
+{
+    numerator = numerator.mul_mod(other.numerator, MuHashModulus());
+    denominator = denominator.mul_mod(other.denominator, MuHashModulus());
+    return *this;
+}
+
+CMuHash3072& CMuHash3072::operator/=(const CMuHash3072& other)
+{
+    numerator = numerator.mul_mod(other.denominator, MuHashModulus());
+    denominator = denominator.mul_mod(other.numerator, MuHashModulus());
+    return *this;
+}
+
+uint256 CMuHash3072::Finalize() const
+{
+    CBigNum value = numerator.mul_mod(denominator.inverse(MuHashModulus()), MuHashModulus());
+
+    // fixed size little endian encoding, getvch() may add a sign byte or drop leading zeroes
+    std::vector<unsigned char> vch = value.getvch();
+    vch.resize(BYTE_SIZE, 0);
+
+    uint256 result;
+    CSHA256().Write(vch.data(), vch.size()).Finalize(result.begin());
+    return result;
+}
+
+static CDataStream SerializeCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    uint32_t code = (coin.nHeight << 2) + (coin.fCoinBase ? 1 : 0) + (coin.fCoinStake ? 2 : 0);
+    ss << outpoint;
+    ss << code;
+    ss << coin.out;
+    return ss;
+}
+
+void CUTXOStats::AddCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    CDataStream ss = SerializeCoin(outpoint, coin);
+    muhash.Insert((const unsigned char*)ss.data(), ss.size());
+    nTransactionOutputs++;
+    nTotalAmount += coin.out.nValue;
+}
+
+void CUTXOStats::RemoveCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    CDataStream ss = SerializeCoin(outpoint, coin);
+    muhash.Remove((const unsigned char*)ss.data(), ss.size());
+    nTransactionOutputs--;
+    nTotalAmount -= coin.out.nValue;
+}
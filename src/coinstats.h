@@ -0,0 +1,85 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COINSTATS_H
+#define BITCOIN_COINSTATS_H
+
+#include "amount.h"
+#include "libzerocoin/bitcoin_bignum/bignum.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <stdint.h>
+
+class COutPoint;
+class Coin;
+
+/**
+ * Order independent hash of a multiset (MuHash). Every element is mapped to a
+ * number modulo the prime 2^3072 - 1103717; insertions are multiplied into the
+ * numerator and removals into the denominator, so the same set of elements
+ * gives the same hash whatever the order it was built in.
+ */
+class CMuHash3072
+{
+private:
+    CBigNum numerator;
+    CBigNum denominator;
+
+public:
+    static const size_t BYTE_SIZE = 384;
+
+    /** The hash of the empty set */
+    CMuHash3072();
+
+    void Insert(const unsigned char* data, size_t size);
+    void Remove(const unsigned char* data, size_t size);
+
+    /** Combine with the elements of another hash, or take them out again */
+    CMuHash3072& operator*=(const CMuHash3072& other);
+    CMuHash3072& operator/=(const CMuHash3072& other);
+
+    /** The 256 bit digest of the set; this needs a modular inversion, so it is slow compared to updates */
+    uint256 Finalize() const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(numerator);
+        READWRITE(denominator);
+    }
+};
+
+/**
+ * Statistics about the UTXO set as of a block, kept up to date as blocks are
+ * connected and disconnected so gettxoutsetinfo does not have to scan the
+ * chainstate. One entry per height of the active chain lives in the block
+ * tree database.
+ */
+class CUTXOStats
+{
+public:
+    uint256 hashBlock;
+    uint64_t nTransactionOutputs;
+    CAmount nTotalAmount;
+    CMuHash3072 muhash;
+
+    CUTXOStats() : nTransactionOutputs(0), nTotalAmount(0) {}
+
+    void AddCoin(const COutPoint& outpoint, const Coin& coin);
+    void RemoveCoin(const COutPoint& outpoint, const Coin& coin);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashBlock);
+        READWRITE(nTransactionOutputs);
+        READWRITE(nTotalAmount);
+        READWRITE(muhash);
+    }
+};
+
+#endif // BITCOIN_COINSTATS_H
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string>
 
 /** A hasher class for SHA-256. */
 class CSHA256
@@ -25,4 +26,30 @@ public:
     CSHA256& Reset();
 };
 
+namespace sha256_implementation {
+/** The implementations SHA256AutoDetect may pick from, on top of the generic one */
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE41 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_SHANI = 1 << 2,
+    USE_ALL = USE_SSE41 | USE_AVX2 | USE_SHANI,
+};
+}
+
+/**
+ * Select the fastest SHA256 implementations the CPU supports, out of the ones
+ * allowed, and return a description of them. Not thread safe: call it at
+ * startup, before anything is hashed on other threads.
+ */
+std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implementation = sha256_implementation::USE_ALL);
+
+/**
+ * Compute the double SHA256 of each of blocks 64 byte inputs, like the inner
+ * nodes of a Merkle tree, several at a time when the CPU allows.
+ * output: blocks * 32 bytes, may be the same as input
+ * input:  blocks * 64 bytes
+ */
+void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
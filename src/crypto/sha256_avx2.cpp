@@ -0,0 +1,153 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// The double SHA256 of eight 64 byte inputs at once, one input per 32 bit
+// lane of the AVX registers. Only built with AVX2 enabled, and only
+// called after SHA256AutoDetect checked that the CPU supports it.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace sha256d64_avx2 {
+namespace {
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/** The round constants plus the message schedule of the padding block of a 64 byte message */
+const uint32_t KW_PADDING[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76,
+};
+
+const uint32_t IV[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+__m256i inline Set(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w) { return Add(Add(x, y), Add(z, w)); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline ShR(__m256i x, int n) { return _mm256_srli_epi32(x, n); }
+__m256i inline ShL(__m256i x, int n) { return _mm256_slli_epi32(x, n); }
+__m256i inline RotR(__m256i x, int n) { return Or(ShR(x, n), ShL(x, 32 - n)); }
+
+__m256i inline Ch(__m256i x, __m256i y, __m256i z) { return Xor(z, And(x, Xor(y, z))); }
+__m256i inline Maj(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), And(z, Or(x, y))); }
+__m256i inline Sigma0(__m256i x) { return Xor(RotR(x, 2), RotR(x, 13), RotR(x, 22)); }
+__m256i inline Sigma1(__m256i x) { return Xor(RotR(x, 6), RotR(x, 11), RotR(x, 25)); }
+__m256i inline sigma0(__m256i x) { return Xor(RotR(x, 7), RotR(x, 18), ShR(x, 3)); }
+__m256i inline sigma1(__m256i x) { return Xor(RotR(x, 17), RotR(x, 19), ShR(x, 10)); }
+
+/** Round i on the working variables v, with the round constant and message word added up in kw */
+void inline Round(__m256i* v, int i, __m256i kw)
+{
+    __m256i& a = v[(8 - i) & 7];
+    __m256i& b = v[(9 - i) & 7];
+    __m256i& c = v[(10 - i) & 7];
+    __m256i& d = v[(11 - i) & 7];
+    __m256i& e = v[(12 - i) & 7];
+    __m256i& f = v[(13 - i) & 7];
+    __m256i& g = v[(14 - i) & 7];
+    __m256i& h = v[(15 - i) & 7];
+    __m256i t1 = Add(h, Sigma1(e), Ch(e, f, g), kw);
+    __m256i t2 = Add(Sigma0(a), Maj(a, b, c));
+    d = Add(d, t1);
+    h = Add(t1, t2);
+}
+
+/** Compress a block of 16 message words w, expanded in place, into the state s */
+void inline Compress(__m256i* s, __m256i* w)
+{
+    __m256i v[8] = {s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]};
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16)
+            w[i & 15] = Add(sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15]), w[i & 15]);
+        Round(v, i, Add(Set(K[i]), w[i & 15]));
+    }
+    for (int i = 0; i < 8; i++)
+        s[i] = Add(s[i], v[i]);
+}
+
+/** Compress the padding block of a 64 byte message into the state s */
+void inline CompressPadding(__m256i* s)
+{
+    __m256i v[8] = {s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7]};
+    for (int i = 0; i < 64; i++)
+        Round(v, i, Set(KW_PADDING[i]));
+    for (int i = 0; i < 8; i++)
+        s[i] = Add(s[i], v[i]);
+}
+
+__m256i inline Read(const unsigned char* in)
+{
+    return _mm256_set_epi32(ReadBE32(in + 448), ReadBE32(in + 384), ReadBE32(in + 320), ReadBE32(in + 256),
+                            ReadBE32(in + 192), ReadBE32(in + 128), ReadBE32(in + 64), ReadBE32(in));
+}
+
+void inline Write(unsigned char* out, __m256i v)
+{
+    WriteBE32(out, _mm256_extract_epi32(v, 0));
+    WriteBE32(out + 32, _mm256_extract_epi32(v, 1));
+    WriteBE32(out + 64, _mm256_extract_epi32(v, 2));
+    WriteBE32(out + 96, _mm256_extract_epi32(v, 3));
+    WriteBE32(out + 128, _mm256_extract_epi32(v, 4));
+    WriteBE32(out + 160, _mm256_extract_epi32(v, 5));
+    WriteBE32(out + 192, _mm256_extract_epi32(v, 6));
+    WriteBE32(out + 224, _mm256_extract_epi32(v, 7));
+}
+
+} // namespace
+
+void Transform_8way(unsigned char* out, const unsigned char* in)
+{
+    // all of the input is read before anything is written, so out may be in
+    __m256i w[16];
+    for (int i = 0; i < 16; i++)
+        w[i] = Read(in + 4 * i);
+
+    __m256i s[8];
+    for (int i = 0; i < 8; i++)
+        s[i] = Set(IV[i]);
+    Compress(s, w);
+    CompressPadding(s);
+
+    // the second hash, of the 32 byte first one
+    for (int i = 0; i < 8; i++)
+        w[i] = s[i];
+    w[8] = Set(0x80000000);
+    for (int i = 9; i < 15; i++)
+        w[i] = Set(0);
+    w[15] = Set(0x100);
+    for (int i = 0; i < 8; i++)
+        s[i] = Set(IV[i]);
+    Compress(s, w);
+
+    for (int i = 0; i < 8; i++)
+        Write(out + 4 * i, s[i]);
+}
+
+} // namespace sha256d64_avx2
+
+#endif
@@ -2,11 +2,21 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
 #include "dbwrapper.h"
 
 #include "util.h"
+#include "utiltime.h"
 #include "random.h"
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+
 #include <boost/filesystem.hpp>
 
 #include <leveldb/cache.h>
@@ -15,14 +25,108 @@
 #include <memenv.h>
 #include <stdint.h>
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+/**
+ * On 64-bit systems LevelDB maps up to 1000 table files per process and closes
+ * their descriptors, beyond that every open table holds a descriptor. The open
+ * file limits below add up to less than that for the databases of a node:
+ * 384 + 128 + 64 + 64 for the chainstate, block index, evodb and llmq, and
+ * 8 * 32 for the Elysium databases, 896 in all. The chainstate is read
+ * randomly and benefits most from keeping its tables open; the block index and
+ * the indexes stored next to it are mostly written and compress well.
+ */
+static const std::map<std::string, CDBProfile> mapDBProfiles = {
+    //                 cache  wbuf   files bloom compress
+    {"default",       {0.5,   0.25,  64,   10,   false}},
+    {"chainstate",    {0.5,   0.25,  384,  10,   false}},
+    {"blockindex",    {0.25,  0.375, 128,  10,   true}},
+    {"evodb",         {0.5,   0.25,  64,   10,   true}},
+    {"llmq",          {0.5,   0.25,  64,   10,   false}},
+    {"elysium",       {0.5,   0.25,  32,   10,   true}},
+};
+
+const CDBProfile& GetDBProfile(const std::string& strName)
+{
+    auto it = mapDBProfiles.find(strName);
+    if (it == mapDBProfiles.end())
+        it = mapDBProfiles.find("default");
+    return it->second;
+}
+
+bool DBProfileUsesCompression(const CDBProfile& profile)
+{
+#ifdef USE_SNAPPY
+    return profile.fCompress && GetBoolArg("-dbcompression", DEFAULT_DB_COMPRESSION);
+#else
+    return false;
+#endif
+}
+
+int DBProfileMaxOpenFiles(const CDBProfile& profile)
+{
+    if (sizeof(void*) < 8) {
+        // Without mmap every open table file holds a descriptor
+        return std::min(profile.nMaxOpenFiles, DB_MAX_OPEN_FILES_UNMAPPED);
+    }
+    return profile.nMaxOpenFiles;
+}
+
+namespace {
+
+/** Forwards to an LRU cache, counting hits and misses */
+class CCountingCache : public leveldb::Cache
+{
+private:
+    leveldb::Cache* base;
+    std::atomic<uint64_t>& nHits;
+    std::atomic<uint64_t>& nMisses;
+
+public:
+    CCountingCache(size_t nCapacity, std::atomic<uint64_t>& nHitsIn, std::atomic<uint64_t>& nMissesIn)
+        : base(leveldb::NewLRUCache(nCapacity)), nHits(nHitsIn), nMisses(nMissesIn) {}
+    ~CCountingCache() { delete base; }
+
+    Handle* Insert(const leveldb::Slice& key, void* value, size_t charge, void (*deleter)(const leveldb::Slice& key, void* value)) override
+    {
+        return base->Insert(key, value, charge, deleter);
+    }
+
+    Handle* Lookup(const leveldb::Slice& key) override
+    {
+        Handle* handle = base->Lookup(key);
+        (handle ? nHits : nMisses).fetch_add(1, std::memory_order_relaxed);
+        return handle;
+    }
+
+    void Release(Handle* handle) override { base->Release(handle); }
+    void* Value(Handle* handle) override { return base->Value(handle); }
+    void Erase(const leveldb::Slice& key) override { base->Erase(key); }
+    uint64_t NewId() override { return base->NewId(); }
+    void Prune() override { base->Prune(); }
+    size_t TotalCharge() const override { return base->TotalCharge(); }
+};
+
+std::mutex& DBRegistryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<const void*, std::function<CDBStats()>>& DBRegistry()
+{
+    static std::map<const void*, std::function<CDBStats()>> registry;
+    return registry;
+}
+
+}
+
+static leveldb::Options GetOptions(size_t nCacheSize, const CDBProfile& profile)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
-    options.max_open_files = 64;
+    options.write_buffer_size = nCacheSize * profile.dWriteBufferShare; // up to two write buffers may be held in memory simultaneously
+    if (profile.nBloomBits > 0)
+        options.filter_policy = leveldb::NewBloomFilterPolicy(profile.nBloomBits);
+    options.compression = DBProfileUsesCompression(profile) ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+    options.max_open_files = DBProfileMaxOpenFiles(profile);
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
         // on corruption in later versions.
@@ -31,14 +135,20 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const std::string& profile)
+    : strProfile(profile), strPath(path.string()), nBlockCacheSize(0),
+      nCacheHits(0), nCacheMisses(0),
+      nWriteBatches(0), nSyncWrites(0), nWriteMicros(0), nMaxWriteMicros(0), nSlowWrites(0)
 {
     penv = NULL;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    const CDBProfile& dbprofile = GetDBProfile(profile);
+    options = GetOptions(nCacheSize, dbprofile);
+    nBlockCacheSize = nCacheSize * dbprofile.dBlockCacheShare;
+    options.block_cache = new CCountingCache(nBlockCacheSize, nCacheHits, nCacheMisses);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -54,7 +164,8 @@ CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, b
     }
     leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
     dbwrapper_private::HandleError(status);
-    LogPrintf("Opened LevelDB successfully\n");
+    LogPrintf("Opened LevelDB successfully (profile %s, max open files %d, compression %s)\n", profile,
+        options.max_open_files, options.compression == leveldb::kSnappyCompression ? "snappy" : "none");
 
     // The base-case obfuscation key, which is a noop.
     obfuscate_key = std::vector<unsigned char>(OBFUSCATE_KEY_NUM_BYTES, '\000');
@@ -74,10 +185,13 @@ CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, b
     }
 
     LogPrintf("Using obfuscation key for %s: %s\n", path.string(), HexStr(obfuscate_key));
+
+    RegisterDBStats(this, [this]() { return GetStats(); });
 }
 
 CDBWrapper::~CDBWrapper()
 {
+    UnregisterDBStats(this);
     delete pdb;
     pdb = NULL;
     delete options.filter_policy;
@@ -90,11 +204,85 @@ CDBWrapper::~CDBWrapper()
 
 bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 {
+    int64_t nStart = GetTimeMicros();
     leveldb::Status status = pdb->Write(fSync ? syncoptions : writeoptions, &batch.batch);
+    uint64_t nMicros = std::max<int64_t>(GetTimeMicros() - nStart, 0);
+
+    nWriteBatches++;
+    if (fSync)
+        nSyncWrites++;
+    nWriteMicros += nMicros;
+    if (nMicros >= DBWRAPPER_SLOW_WRITE_MICROS)
+        nSlowWrites++;
+    uint64_t nMax = nMaxWriteMicros.load();
+    while (nMicros > nMax && !nMaxWriteMicros.compare_exchange_weak(nMax, nMicros)) {}
+
     dbwrapper_private::HandleError(status);
     return true;
 }
 
+CDBStats CDBWrapper::GetStats() const
+{
+    CDBStats stats;
+    stats.strProfile = strProfile;
+    stats.strPath = strPath;
+    stats.fCompression = options.compression == leveldb::kSnappyCompression;
+    stats.fCounters = true;
+    stats.nBlockCacheSize = nBlockCacheSize;
+    stats.nBlockCacheUsage = options.block_cache->TotalCharge();
+    stats.nBlockCacheHits = nCacheHits;
+    stats.nBlockCacheMisses = nCacheMisses;
+    stats.nWriteBatches = nWriteBatches;
+    stats.nSyncWrites = nSyncWrites;
+    stats.nWriteMicros = nWriteMicros;
+    stats.nMaxWriteMicros = nMaxWriteMicros;
+    stats.nSlowWrites = nSlowWrites;
+    GetLevelDBStats(*pdb, stats);
+    return stats;
+}
+
+void GetLevelDBStats(leveldb::DB& db, CDBStats& stats)
+{
+    std::string strValue;
+    stats.nMemoryUsage = 0;
+    if (db.GetProperty("leveldb.approximate-memory-usage", &strValue))
+        stats.nMemoryUsage = atoi64(strValue);
+
+    // Rows of "level files size(MB) time(sec) read(MB) write(MB)" after a three line header
+    if (db.GetProperty("leveldb.stats", &strValue)) {
+        std::istringstream in(strValue);
+        std::string strLine;
+        while (std::getline(in, strLine)) {
+            CDBStats::Level level;
+            if (sscanf(strLine.c_str(), "%d %d %lf %lf %lf %lf", &level.nLevel, &level.nFiles, &level.dSizeMB,
+                    &level.dCompactionSeconds, &level.dCompactionReadMB, &level.dCompactionWriteMB) == 6) {
+                stats.vLevels.push_back(level);
+            }
+        }
+    }
+}
+
+void RegisterDBStats(const void* owner, std::function<CDBStats()> getStats)
+{
+    std::lock_guard<std::mutex> lock(DBRegistryMutex());
+    DBRegistry()[owner] = std::move(getStats);
+}
+
+void UnregisterDBStats(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(DBRegistryMutex());
+    DBRegistry().erase(owner);
+}
+
+std::vector<CDBStats> GetAllDBStats()
+{
+    std::vector<CDBStats> result;
+    std::lock_guard<std::mutex> lock(DBRegistryMutex());
+    for (const auto& entry : DBRegistry())
+        result.push_back(entry.second());
+    return result;
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -12,6 +12,9 @@
 #include "utilstrencodings.h"
 #include "version.h"
 
+#include <atomic>
+#include <functional>
+
 #include <boost/filesystem/path.hpp>
 
 #include <leveldb/db.h>
@@ -19,6 +22,12 @@
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
+//! Default for -dbcompression, off so that the data directory does not depend on how the node was built
+static const bool DEFAULT_DB_COMPRESSION = false;
+//! Open table files per database where LevelDB does not map them, each holds a file descriptor
+static const int DB_MAX_OPEN_FILES_UNMAPPED = 16;
+//! Writes taking longer than this are counted as slow, LevelDB blocks writers while compaction catches up
+static const int64_t DBWRAPPER_SLOW_WRITE_MICROS = 100 * 1000;
 
 class dbwrapper_error : public std::runtime_error
 {
@@ -28,6 +37,76 @@ public:
 
 class CDBWrapper;
 
+/** LevelDB tuning for one kind of database, see GetDBProfile() */
+struct CDBProfile
+{
+    //! Share of the cache size given to the block cache
+    double dBlockCacheShare;
+    //! Share of the cache size given to each write buffer, up to two may be held in memory simultaneously
+    double dWriteBufferShare;
+    //! Table files kept open, on 64-bit systems LevelDB maps them rather than holding descriptors
+    int nMaxOpenFiles;
+    //! Bits per key of the Bloom filter, 0 for none
+    int nBloomBits;
+    //! Whether the data is worth compressing with Snappy, if LevelDB was built with it
+    bool fCompress;
+};
+
+/**
+ * The tuning profile for a database: "chainstate", "blockindex" (which also
+ * holds the address, spent and timestamp indexes), "evodb", "llmq" or
+ * "elysium". Unknown names get the default profile.
+ */
+const CDBProfile& GetDBProfile(const std::string& strName);
+
+/** Whether a database with this profile is stored compressed */
+bool DBProfileUsesCompression(const CDBProfile& profile);
+
+/** The open file limit of a database with this profile on this system */
+int DBProfileMaxOpenFiles(const CDBProfile& profile);
+
+/** Statistics about an open database, see GetAllDBStats() */
+struct CDBStats
+{
+    struct Level
+    {
+        int nLevel;
+        int nFiles;
+        double dSizeMB;
+        double dCompactionSeconds;
+        double dCompactionReadMB;
+        double dCompactionWriteMB;
+    };
+
+    std::string strProfile;
+    std::string strPath;
+    bool fCompression;
+    //! whether the block cache and write counters below are kept, only CDBWrapper keeps them
+    bool fCounters;
+    size_t nBlockCacheSize;
+    size_t nBlockCacheUsage;
+    uint64_t nBlockCacheHits;
+    uint64_t nBlockCacheMisses;
+    uint64_t nMemoryUsage;
+    //! compaction statistics per level, as reported by LevelDB
+    std::vector<Level> vLevels;
+    uint64_t nWriteBatches;
+    uint64_t nSyncWrites;
+    uint64_t nWriteMicros;
+    uint64_t nMaxWriteMicros;
+    uint64_t nSlowWrites;
+};
+
+/** Statistics of every database currently open */
+std::vector<CDBStats> GetAllDBStats();
+
+/** Adds an open database to GetAllDBStats(), until UnregisterDBStats() is called with the same owner */
+void RegisterDBStats(const void* owner, std::function<CDBStats()> getStats);
+void UnregisterDBStats(const void* owner);
+
+/** Fills in the statistics LevelDB reports itself: memory usage and compactions per level */
+void GetLevelDBStats(leveldb::DB& db, CDBStats& stats);
+
 /** These should be considered an implementation detail of the specific database.
  */
 namespace dbwrapper_private {
@@ -225,6 +304,22 @@ private:
     //! the database itself
     leveldb::DB* pdb;
 
+    //! the tuning profile the database was opened with, and where it lives
+    std::string strProfile;
+    std::string strPath;
+    size_t nBlockCacheSize;
+
+    //! block cache lookups, counted by the cache wrapper in options.block_cache
+    std::atomic<uint64_t> nCacheHits;
+    std::atomic<uint64_t> nCacheMisses;
+
+    //! write counters, all writes go through WriteBatch()
+    std::atomic<uint64_t> nWriteBatches;
+    std::atomic<uint64_t> nSyncWrites;
+    std::atomic<uint64_t> nWriteMicros;
+    std::atomic<uint64_t> nMaxWriteMicros;
+    std::atomic<uint64_t> nSlowWrites;
+
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
@@ -244,8 +339,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] profile     Name of the tuning profile, see GetDBProfile().
      */
-    CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const std::string& profile = "default");
     ~CDBWrapper();
 
     template <typename K>
@@ -396,7 +492,8 @@ public:
     {
         pdb->CompactRange(nullptr, nullptr);
     }
-    
+
+    CDBStats GetStats() const;
 };
 
 template<typename CDBTransaction>
@@ -575,6 +672,7 @@ protected:
         ValueHolder(size_t _memoryUsage) : memoryUsage(_memoryUsage) {}
         virtual ~ValueHolder() = default;
         virtual void Write(const CDataStream& ssKey, CommitTarget &parent) = 0;
+        virtual void Copy(const CDataStream& ssKey, CommitTarget &parent) const = 0;
     };
     typedef std::unique_ptr<ValueHolder> ValueHolderPtr;
 
@@ -587,6 +685,9 @@ protected:
             // ValueHolderImpl instance. Commit() clears the write maps, so this ok.
             commitTarget.Write(ssKey, std::move(value));
         }
+        virtual void Copy(const CDataStream& ssKey, CommitTarget &commitTarget) const {
+            commitTarget.Write(ssKey, value);
+        }
         V value;
     };
 
@@ -701,6 +802,20 @@ public:
         Clear();
     }
 
+    /**
+     * Write the changes to the commit target like Commit(), but leave them in
+     * place. The transaction is not modified, so it may still be read from
+     * other threads while this runs.
+     */
+    void CopyTo(CommitTarget& target) const {
+        for (const auto &k : deletes) {
+            target.Erase(k);
+        }
+        for (const auto &p : writes) {
+            p.second->Copy(p.first, target);
+        }
+    }
+
     bool IsClean() {
         return writes.empty() && deletes.empty();
     }
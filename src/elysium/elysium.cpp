@@ -29,6 +29,7 @@
 #include "wallettxs.h"
 
 #include "../base58.h"
+#include "../blockprefetch.h"
 #include "../chainparams.h"
 #include "../wallet/coincontrol.h"
 #include "../coins.h"
@@ -1159,6 +1160,11 @@ static int elysium_initial_scan(int nFirstBlock)
     // used to print the progress to the console and notifies the UI
     ProgressReporter progressReporter(chainActive[nFirstBlock], chainActive[nLastBlock]);
 
+    // blocks are read and deserialized ahead of the parsing by worker threads
+    CBlockPrefetcher prefetcher(Params().GetConsensus(), chainActive[nFirstBlock], [nLastBlock](const CBlockIndex* pindexPrev) {
+        return pindexPrev->nHeight < nLastBlock ? chainActive.Next(pindexPrev) : NULL;
+    }, "index-elyscan");
+
     for (nBlock = nFirstBlock; nBlock <= nLastBlock; ++nBlock)
     {
         if (ShutdownRequested()) {
@@ -1179,11 +1185,11 @@ static int elysium_initial_scan(int nFirstBlock)
         }
 
         // Get block to parse.
-        CBlock block;
-
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
+        std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher.Take(pblockindex);
+        if (!prefetchedBlock || !prefetchedBlock->fRead) {
             break;
         }
+        const CBlock& block = *prefetchedBlock->block;
 
         // Parse block.
         unsigned parsed = 0;
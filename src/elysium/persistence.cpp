@@ -23,7 +23,12 @@ leveldb::Status CDBBase::Open(const boost::filesystem::path& path, bool fWipe)
     TryCreateDirectory(path);
     if (elysium_debug_persistence) PrintToLog("Opening LevelDB in %s\n", path.string());
 
-    return leveldb::DB::Open(options, path.string(), &pdb);
+    leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
+    if (status.ok()) {
+        strPath = path.string();
+        RegisterDBStats(this, [this]() { return GetStats(); });
+    }
+    return status;
 }
 
 /**
@@ -53,12 +58,27 @@ void CDBBase::Clear()
             n, status.ToString(), (n > 0 ? (0.001 * nTime / n) : 0), 0.001 * nTime);
 }
 
+/**
+ * Returns the statistics LevelDB keeps about the open database.
+ */
+CDBStats CDBBase::GetStats() const
+{
+    CDBStats stats = CDBStats();
+    stats.strProfile = "elysium";
+    stats.strPath = strPath;
+    stats.fCompression = options.compression == leveldb::kSnappyCompression;
+    stats.fCounters = false;
+    GetLevelDBStats(*pdb, stats);
+    return stats;
+}
+
 /**
  * Deinitializes and closes the database.
  */
 void CDBBase::Close()
 {
     if (pdb) {
+        UnregisterDBStats(this);
         delete pdb;
         pdb = NULL;
     }
@@ -1,6 +1,8 @@
 #ifndef ELYSIUM_PERSISTENCE_H
 #define ELYSIUM_PERSISTENCE_H
 
+#include "../dbwrapper.h"
+
 #include "leveldb/db.h"
 
 #include <boost/filesystem/path.hpp>
@@ -8,6 +10,8 @@
 #include <assert.h>
 #include <stddef.h>
 
+#include <string>
+
 /** Base class for LevelDB based storage.
  */
 class CDBBase
@@ -16,6 +20,9 @@ private:
     //! Options used when iterating over values of the database
     leveldb::ReadOptions iteroptions;
 
+    //! Where the database lives, while it is open
+    std::string strPath;
+
 protected:
     //! Database options used
     leveldb::Options options;
@@ -42,8 +49,9 @@ protected:
     {
         options.paranoid_checks = true;
         options.create_if_missing = true;
-        options.compression = leveldb::kNoCompression;
-        options.max_open_files = 64;
+        const CDBProfile& profile = GetDBProfile("elysium");
+        options.compression = DBProfileUsesCompression(profile) ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+        options.max_open_files = DBProfileMaxOpenFiles(profile);
         readoptions.verify_checksums = true;
         iteroptions.verify_checksums = true;
         iteroptions.fill_cache = false;
@@ -91,6 +99,11 @@ public:
      * Deletes all entries of the database, and resets the counters.
      */
     void Clear();
+
+    /**
+     * Returns the statistics LevelDB keeps about the open database, as shown by getdbstats.
+     */
+    CDBStats GetStats() const;
 };
 
 
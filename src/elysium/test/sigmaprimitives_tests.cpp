@@ -22,6 +22,17 @@ BOOST_AUTO_TEST_CASE(params)
     BOOST_CHECK_EQUAL(params.h.size(), 7 * 4);
 }
 
+BOOST_AUTO_TEST_CASE(default_params_generators)
+{
+    // The generators are consensus critical, every existing proof was made with them
+    BOOST_CHECK_EQUAL(DefaultSigmaParams.g, secp_primitives::GroupElement().set_base_g());
+    BOOST_CHECK_EQUAL(DefaultSigmaParams.h.size(), 7 * 4);
+    BOOST_CHECK_EQUAL(DefaultSigmaParams.h.front().GetHex(),
+        "(d75bfd6797e108484944bf16246ecbac54cf25d39c537ba91aced24f70fcc238,188d9e4b0f5e4d6c8c02bb314342d61a64b6ecc69d6c109ab04aad8bf7bf6d7d)");
+    BOOST_CHECK_EQUAL(DefaultSigmaParams.h.back().GetHex(),
+        "(6625b9ddde26e77f214deb0e0223bc67931db144d11e49b737dd0df97bf72139,a0fbd68ab1ed3a777d2c036a48cd555f66aaef66c157ba0a9af69cbbe7bb3c13)");
+}
+
 BOOST_AUTO_TEST_CASE(params_validation)
 {
     BOOST_CHECK_THROW(SigmaParams(secp_primitives::GroupElement().set_base_g(), 0, 1), std::invalid_argument);
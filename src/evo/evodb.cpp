@@ -7,18 +7,37 @@
 CEvoDB* evoDb;
 
 CEvoDB::CEvoDB(size_t nCacheSize, bool fMemory, bool fWipe) :
-    db(fMemory ? "" : (GetDataDir() / "evodb"), nCacheSize, fMemory, fWipe),
+    db(fMemory ? "" : (GetDataDir() / "evodb"), nCacheSize, fMemory, fWipe, false, "evodb"),
     rootBatch(db),
-    rootDBTransaction(db, rootBatch),
+    pendingDBTransaction(db, rootBatch),
+    rootDBTransaction(pendingDBTransaction, pendingDBTransaction),
     curDBTransaction(rootDBTransaction, rootDBTransaction)
 {
 }
 
 bool CEvoDB::CommitRootTransaction()
+{
+    BeginRootCommit();
+    bool ret = WritePendingCommit();
+    LOCK(cs);
+    pendingDBTransaction.Clear();
+    return ret;
+}
+
+void CEvoDB::BeginRootCommit()
 {
     LOCK(cs);
     assert(curDBTransaction.IsClean());
+    // Everything in the pending layer is on disk by now
+    pendingDBTransaction.Clear();
     rootDBTransaction.Commit();
+}
+
+bool CEvoDB::WritePendingCommit()
+{
+    // No lock: the pending layer does not change until the next BeginRootCommit(), and
+    // rootBatch is only used here
+    pendingDBTransaction.CopyTo(rootBatch);
     bool ret = db.WriteBatch(rootBatch);
     rootBatch.Clear();
     return ret;
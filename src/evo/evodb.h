@@ -19,11 +19,15 @@ private:
     CCriticalSection cs;
     CDBWrapper db;
 
-    typedef CDBTransaction<CDBWrapper, CDBBatch> RootTransaction;
+    typedef CDBTransaction<CDBWrapper, CDBBatch> PendingTransaction;
+    typedef CDBTransaction<PendingTransaction, PendingTransaction> RootTransaction;
     typedef CDBTransaction<RootTransaction, RootTransaction> CurTransaction;
     typedef CScopedDBTransaction<RootTransaction, RootTransaction, CEvoDB> ScopedTransaction;
 
     CDBBatch rootBatch;
+    // Changes that are being written to disk, possibly by the background flush of the chainstate.
+    // Only BeginRootCommit() modifies it, so it can be read while WritePendingCommit() runs.
+    PendingTransaction pendingDBTransaction;
     RootTransaction rootDBTransaction;
     CurTransaction curDBTransaction;
 
@@ -82,6 +86,15 @@ public:
 
     bool CommitRootTransaction();
 
+    /**
+     * Move the changes of the root transaction into the pending layer, where
+     * they stay readable until the next call. The previous WritePendingCommit()
+     * must have finished.
+     */
+    void BeginRootCommit();
+    //! Write the pending layer to disk, can run on another thread than the one updating the database
+    bool WritePendingCommit();
+
     bool VerifyBestBlock(const uint256& hash);
     void WriteBestBlock(const uint256& hash);
 
@@ -14,6 +14,7 @@
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
 #include "keystore.h"
+#include "ctpl.h"
 #include <boost/optional.hpp>
 #include "indexnodesync-interface.h"
 
@@ -132,7 +133,8 @@ std::pair<uint256,uint256> CHDMintWallet::RegenerateMintPoolEntry(CWalletDB& wal
  * only runs if the current mintpool is exhausted and we need new mints (ie. the next mint to
  * generate is the same as the one last used)
  * Generates 20 mints at a time.
- * Makes the appropriate database entries.
+ * Mint seeds are derived in order as it may extend the HD chain, commitments are then computed
+ * in parallel and all the entries are written to the database in a single transaction.
  *
  * @param nIndex The number of mints to generate. Defaults to 20 if no param passed.
  */
@@ -152,27 +154,59 @@ void CHDMintWallet::GenerateMintPool(CWalletDB& walletdb, int32_t nIndex)
     if(nIndex > 0 && nIndex >= nLastCount)
         nStop = nIndex + 20;
     LogPrintf("%s : nLastCount=%d nStop=%d\n", __func__, nLastCount, nStop - 1);
+
+    struct MintPoolSeed {
+        int32_t nCount;
+        CKeyID seedId;
+        uint512 mintSeed;
+        GroupElement commitmentValue;
+        uint256 hashSerial;
+    };
+
+    std::vector<MintPoolSeed> seeds;
+    seeds.reserve(nStop - nLastCount + 1);
     for (; nLastCount <= nStop; ++nLastCount) {
         if (ShutdownRequested())
             return;
 
-        CKeyID seedId;
-        uint512 mintSeed;
-        if(!CreateMintSeed(walletdb, mintSeed, nLastCount, seedId, false))
+        MintPoolSeed seed;
+        seed.nCount = nLastCount;
+        if(!CreateMintSeed(walletdb, seed.mintSeed, nLastCount, seed.seedId, false))
             continue;
+        seeds.push_back(seed);
+    }
 
-        GroupElement commitmentValue;
-        sigma::PrivateCoin coin(sigma::Params::get_default(), sigma::CoinDenomination::SIGMA_DENOM_1);
-        if(!SeedToMint(mintSeed, commitmentValue, coin))
+    std::vector<std::future<bool>> futures;
+    futures.reserve(seeds.size());
+    {
+        // Params are lazily initialized, get them before going parallel
+        const sigma::Params* params = sigma::Params::get_default();
+        ctpl::thread_pool workerPool(std::max(1, std::min(GetNumCores(), (int)seeds.size())));
+        for (MintPoolSeed& seed : seeds) {
+            futures.push_back(workerPool.push([this, params, &seed](int) {
+                sigma::PrivateCoin coin(params, sigma::CoinDenomination::SIGMA_DENOM_1);
+                if (!SeedToMint(seed.mintSeed, seed.commitmentValue, coin))
+                    return false;
+                seed.hashSerial = primitives::GetSerialHash(coin.getSerialNumber());
+                return true;
+            }));
+        }
+    }
+
+    // Don't start a transaction if the caller already has one
+    bool fTxn = walletdb.TxnBegin();
+    for (size_t i = 0; i < seeds.size(); i++) {
+        if (!futures[i].get())
             continue;
 
-        uint256 hashPubcoin = primitives::GetPubCoinValueHash(commitmentValue);
+        const MintPoolSeed& seed = seeds[i];
+        uint256 hashPubcoin = primitives::GetPubCoinValueHash(seed.commitmentValue);
 
-        MintPoolEntry mintPoolEntry(hashSeedMaster, seedId, nLastCount);
+        MintPoolEntry mintPoolEntry(hashSeedMaster, seed.seedId, seed.nCount);
         mintPool.Add(make_pair(hashPubcoin, mintPoolEntry));
-        walletdb.WritePubcoin(primitives::GetSerialHash(coin.getSerialNumber()), commitmentValue);
+        walletdb.WritePubcoin(seed.hashSerial, seed.commitmentValue);
         walletdb.WriteMintPoolPair(hashPubcoin, mintPoolEntry);
-        LogPrintf("%s : hashSeedMaster=%s hashPubcoin=%s seedId=%d count=%d\n", __func__, hashSeedMaster.GetHex(), hashPubcoin.GetHex(), seedId.GetHex(), nLastCount);
+        LogPrintf("%s : hashSeedMaster=%s hashPubcoin=%s seedId=%d count=%d\n", __func__, hashSeedMaster.GetHex(), hashPubcoin.GetHex(), seed.seedId.GetHex(), seed.nCount);
     }
 
     // write hdchain back to database
@@ -183,6 +217,8 @@ void CHDMintWallet::GenerateMintPool(CWalletDB& walletdb, int32_t nIndex)
     nCountNextGenerate = nLastCount;
     walletdb.WriteMintSeedCount(nCountNextGenerate);
 
+    if (fTxn && !walletdb.TxnCommit())
+        throw std::runtime_error(std::string(__func__) + ": Writing mint pool failed");
 }
 
 /**
@@ -265,6 +301,16 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             listMints = list<pair<uint256, MintPoolEntry>>();
             mintPool.List(listMints.get());
         }
+
+        // Look up all the unchecked mints on chain at once rather than scanning the state for each of them
+        std::set<uint256> setToLookup;
+        for (const pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
+            if (!setChecked.count(pMint.first) && !tracker.HasPubcoinHash(pMint.first))
+                setToLookup.insert(pMint.first);
+        }
+        std::map<uint256, sigma::PublicCoin> mapChainCoins;
+        sigma::CSigmaState::GetState()->GetCoinsByHash(setToLookup, mapChainCoins);
+
         for (pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
             if (setChecked.count(pMint.first))
                 continue;
@@ -280,8 +326,12 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             if (tracker.HasPubcoinHash(pMint.first))
                 continue;
 
+            auto chainCoin = mapChainCoins.find(pMint.first);
+            if (chainCoin == mapChainCoins.end())
+                continue;
+
             COutPoint outPoint;
-            if (sigma::GetOutPoint(outPoint, pMint.first)) {
+            if (sigma::GetOutPoint(outPoint, chainCoin->second)) {
                 const uint256& txHash = outPoint.hash;
                 //this mint has already occurred on the chain, increment counter's state to reflect this
                 LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
@@ -8,6 +8,7 @@
 #include "chainparams.h"
 #include "httpserver.h"
 #include "mbstring.h"
+#include "rpc/jsonstream.h"
 #include "rpc/protocol.h"
 #include "rpc/server.h"
 #include "random.h"
@@ -151,6 +152,69 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return multiUserAuthorized(strUserPass);
 }
 
+/**
+ * Reply to a singleton request through the streaming actor of its method, as a
+ * chunked reply whose body is byte for byte what JSONRPCReply() would produce.
+ * Returns false if the method has no streaming actor, nothing was written then.
+ *
+ * The reply only starts with the first full chunk, and the actors check their
+ * parameters and look up what they reply with before writing anything, so
+ * their errors still get the regular error reply. An error after that can only
+ * cut the reply short by closing the connection.
+ */
+static bool HTTPReq_JSONRPCStreaming(HTTPRequest* req, const JSONRPCRequest& jreq)
+{
+    bool fStarted = false;
+    //! Whether the output goes nowhere, because of an error or because the client went away
+    bool fDiscard = false;
+
+    // The writer only ever cuts its output after a complete JSON token, which ends in
+    // ASCII, so sanitizing chunk by chunk gives the same result as sanitizing it all.
+    CJSONStreamWriter writer([req, &fStarted, &fDiscard](const char* data, size_t size) {
+        if (fDiscard)
+            return;
+        if (!fStarted) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReplyStart(HTTP_OK);
+            fStarted = true;
+        }
+        bool fSent;
+        if (fSanitizeResponse) {
+            std::string strChunk = SanitizeInvalidUTF8(std::string(data, size));
+            fSent = req->WriteReplyChunk(strChunk.data(), strChunk.size());
+        } else {
+            fSent = req->WriteReplyChunk(data, size);
+        }
+        fDiscard = !fSent;
+    });
+
+    try {
+        writer.BeginObject();
+        writer.Key("result");
+        if (!tableRPC.executeStreaming(jreq, writer)) {
+            assert(!fStarted);
+            fDiscard = true;
+            return false;
+        }
+        writer.Key("error");
+        writer.Value(NullUniValue);
+        writer.Key("id");
+        writer.Value(jreq.id);
+        writer.EndObject();
+        writer.Raw("\n");
+        writer.Flush();
+    } catch (...) {
+        fDiscard = true;
+        if (!fStarted)
+            throw;
+        LogPrintf("%s: %s failed after its reply started, reply cut short\n", __func__, SanitizeString(jreq.strMethod));
+        return true;
+    }
+
+    req->WriteReplyEnd();
+    return true;
+}
+
 static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
 {
     // JSONRPC handles only POST
@@ -194,6 +258,10 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
+            // Large results are written into the reply as they are produced
+            if (HTTPReq_JSONRPCStreaming(req, jreq))
+                return true;
+
             UniValue result = tableRPC.execute(jreq);
 
             // Send reply
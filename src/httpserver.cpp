@@ -19,6 +19,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <signal.h>
+#include <chrono>
 #include <future>
 
 #include <event2/event.h>
@@ -181,6 +182,8 @@ static WorkQueue<HTTPClosure>* workQueue = 0;
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
 std::vector<evhttp_bound_socket *> boundSockets;
+//! Seconds a worker waits for a client to take a chunk of a reply
+static int nHTTPServerTimeout = DEFAULT_HTTP_SERVER_TIMEOUT;
 
 /** Check if a network address is allowed to access the HTTP server */
 static bool ClientAllowed(const CNetAddr& netaddr)
@@ -419,7 +422,8 @@ bool InitHTTPServer()
         return false;
     }
 
-    evhttp_set_timeout(http, GetArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT));
+    nHTTPServerTimeout = GetArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT);
+    evhttp_set_timeout(http, nHTTPServerTimeout);
     evhttp_set_max_headers_size(http, MAX_HEADERS_SIZE);
     evhttp_set_max_body_size(http, MAX_SIZE);
     evhttp_set_gencb(http, http_request_cb, NULL);
@@ -540,12 +544,28 @@ void HTTPEvent::trigger(struct timeval* tv)
         evtimer_add(ev, tv); // trigger after timeval passed
 }
 HTTPRequest::HTTPRequest(struct evhttp_request* _req) : req(_req),
-                                                       replySent(false)
+                                                       replySent(false),
+                                                       replyStarted(false)
 {
 }
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (replyStarted && !replySent) {
+        // The status is out already, all that tells the client is closing the connection
+        LogPrintf("%s: Unfinished chunked reply\n", __func__);
+        struct evhttp_request* reqAbort = req;
+        std::shared_ptr<HTTPChunkedReply> reply = chunkedReply;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [reqAbort, reply]() {
+            struct evhttp_connection* evcon = evhttp_request_get_connection(reqAbort);
+            if (evcon) {
+                evhttp_connection_set_closecb(evcon, NULL, NULL);
+                evhttp_connection_free(evcon); // frees the request with it
+            } else {
+                evhttp_request_free(reqAbort);
+            }
+        });
+        ev->trigger(0);
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL, "Unhandled request");
@@ -598,7 +618,7 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
  */
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
-    assert(!replySent && req);
+    assert(!replySent && !replyStarted && req);
     // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
@@ -610,6 +630,130 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     req = 0; // transferred back to main thread
 }
 
+/** What a worker thread sending a chunked reply shares with the main http thread */
+struct HTTPChunkedReply
+{
+    std::mutex cs;
+    std::condition_variable cond;
+    //! Whether the last chunk is not written out to the client yet
+    bool fChunkPending;
+    //! Whether the connection went away
+    bool fClosed;
+
+    HTTPChunkedReply() : fChunkPending(false), fClosed(false) {}
+
+    void SetChunkWritten()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fChunkPending = false;
+        cond.notify_all();
+    }
+
+    void SetClosed()
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        fClosed = true;
+        cond.notify_all();
+    }
+};
+
+static void http_chunk_written_cb(struct evhttp_connection* evcon, void* arg)
+{
+    static_cast<HTTPChunkedReply*>(arg)->SetChunkWritten();
+}
+
+static void http_chunked_reply_close_cb(struct evhttp_connection* evcon, void* arg)
+{
+    static_cast<HTTPChunkedReply*>(arg)->SetClosed();
+}
+
+/* The chunks are handed to the main http thread in the same way as a whole
+ * reply. Events triggered from one thread run in the order they were
+ * triggered, so the chunks go out in order. Every event holds on to the shared
+ * state, which libevent calls back into, until the reply is ended. Should the
+ * client go away meanwhile, libevent detaches the request from the connection
+ * and frees the connection, and the request is left for us to free.
+ */
+void HTTPRequest::WriteReplyStart(int nStatus)
+{
+    assert(!replySent && !replyStarted && req);
+    chunkedReply = std::make_shared<HTTPChunkedReply>();
+    struct evhttp_request* reqStart = req;
+    std::shared_ptr<HTTPChunkedReply> reply = chunkedReply;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [reqStart, nStatus, reply]() {
+        struct evhttp_connection* evcon = evhttp_request_get_connection(reqStart);
+        if (evcon)
+            evhttp_connection_set_closecb(evcon, http_chunked_reply_close_cb, reply.get());
+        evhttp_send_reply_start(reqStart, nStatus, NULL);
+    });
+    ev->trigger(0);
+    replyStarted = true;
+}
+
+bool HTTPRequest::WriteReplyChunk(const char* data, size_t size)
+{
+    assert(!replySent && replyStarted && req);
+    std::shared_ptr<HTTPChunkedReply> reply = chunkedReply;
+    {
+        std::lock_guard<std::mutex> lock(reply->cs);
+        // libevent sends nothing, and reports nothing, for an empty chunk
+        if (reply->fClosed || size == 0)
+            return !reply->fClosed;
+        reply->fChunkPending = true;
+    }
+
+    struct evbuffer* evbChunk = evbuffer_new();
+    assert(evbChunk);
+    evbuffer_add(evbChunk, data, size);
+    struct evhttp_request* reqChunk = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [reqChunk, evbChunk, reply]() {
+        if (!evhttp_request_get_connection(reqChunk)) {
+            reply->SetClosed();
+        } else {
+#if LIBEVENT_VERSION_NUMBER >= 0x02010100
+            evhttp_send_reply_chunk_with_cb(reqChunk, evbChunk, http_chunk_written_cb, reply.get());
+            // Nothing was taken, and nothing will be reported, if the reply has no body, e.g. for HEAD
+            if (evbuffer_get_length(evbChunk) != 0)
+                reply->SetChunkWritten();
+#else
+            // Without the callback, settle for the chunk being handed to the connection
+            evhttp_send_reply_chunk(reqChunk, evbChunk);
+            reply->SetChunkWritten();
+#endif
+        }
+        evbuffer_free(evbChunk);
+    });
+    ev->trigger(0);
+
+    // Do not leave the worker to a client that stops reading, it is given up
+    // on like the connection timeout would, and the reply is aborted
+    std::unique_lock<std::mutex> lock(reply->cs);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(nHTTPServerTimeout);
+    while (reply->fChunkPending && !reply->fClosed) {
+        if (reply->cond.wait_until(lock, deadline) == std::cv_status::timeout && reply->fChunkPending) {
+            LogPrint("http", "Chunked reply timed out after %d seconds\n", nHTTPServerTimeout);
+            reply->fClosed = true;
+        }
+    }
+    return !reply->fClosed;
+}
+
+void HTTPRequest::WriteReplyEnd()
+{
+    assert(!replySent && replyStarted && req);
+    struct evhttp_request* reqEnd = req;
+    std::shared_ptr<HTTPChunkedReply> reply = chunkedReply;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [reqEnd, reply]() {
+        struct evhttp_connection* evcon = evhttp_request_get_connection(reqEnd);
+        if (evcon)
+            evhttp_connection_set_closecb(evcon, NULL, NULL);
+        evhttp_send_reply_end(reqEnd);
+    });
+    ev->trigger(0);
+    replySent = true;
+    req = 0; // transferred back to main thread
+}
+
 CService HTTPRequest::GetPeer()
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
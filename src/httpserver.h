@@ -8,6 +8,7 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <memory>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
@@ -17,6 +18,7 @@ struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+struct HTTPChunkedReply;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -55,6 +57,9 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    bool replyStarted;
+    //! State shared with the main http thread while a chunked reply is sent
+    std::shared_ptr<HTTPChunkedReply> chunkedReply;
 
 public:
     HTTPRequest(struct evhttp_request* req);
@@ -110,6 +115,24 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Send the status line and headers of a reply whose body follows in chunks,
+     * for replies too large to build in memory first. Use WriteReplyChunk for
+     * the body and finish with WriteReplyEnd, which is then subject to the same
+     * restrictions as WriteReply. WriteReply cannot be used for such a reply. A reply that is not finished when the request goes
+     * away ends by closing the connection, so the client cannot take it for
+     * complete.
+     */
+    void WriteReplyStart(int nStatus);
+    /**
+     * Send a chunk of the body. Returns once it is written out to the client,
+     * so no more than one chunk is held at a time however slow the client is,
+     * or false if the client went away or did not take the chunk within
+     * -rpcservertimeout seconds. Do not end the reply then.
+     */
+    bool WriteReplyChunk(const char* data, size_t size);
+    void WriteReplyEnd();
 };
 
 /** Event handler closure.
@@ -141,6 +141,8 @@ struct CompareByAddr
     }
 };
 
+SaltedZnodeKeyHasher::SaltedZnodeKeyHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
 void CZnodeIndex::RebuildIndex()
 {
     nSize = mapIndex.size();
@@ -180,6 +182,9 @@ bool CZnodeMan::Add(CZnode &mn)
         LogPrint("indexnode", "CZnodeMan::Add -- Adding new Znode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
         vIndexnodes.push_back(mn);
         indexIndexnodes.AddZnodeVIN(mn.vin);
+        // appending keeps the positions of other entries, but may move them in memory
+        IndexZnode(vIndexnodes.size() - 1);
+        ClearRankCache();
         fIndexnodesAdded = true;
         return true;
     }
@@ -187,6 +192,58 @@ bool CZnodeMan::Add(CZnode &mn)
     return false;
 }
 
+void CZnodeMan::IndexZnode(size_t nIndex)
+{
+    const CZnode& mn = vIndexnodes[nIndex];
+    mapIndexnodeByOutpoint[mn.vin.prevout] = nIndex;
+    mapIndexnodeByPubKey[mn.pubKeyZnode] = nIndex;
+    mapIndexnodeByCollateral[mn.pubKeyCollateralAddress.GetID()] = nIndex;
+}
+
+void CZnodeMan::RebuildZnodeIndexes()
+{
+    LOCK(cs);
+    mapIndexnodeByOutpoint.clear();
+    mapIndexnodeByPubKey.clear();
+    mapIndexnodeByCollateral.clear();
+    for(size_t i = 0; i < vIndexnodes.size(); ++i) {
+        IndexZnode(i);
+    }
+    ClearRankCache();
+}
+
+void CZnodeMan::ClearRankCache()
+{
+    mapRankCache.clear();
+    listRankCacheOrder.clear();
+}
+
+const std::vector<std::pair<int64_t, CZnode*> >& CZnodeMan::GetSortedScores(const uint256& blockHash)
+{
+    std::map<uint256, std::vector<std::pair<int64_t, CZnode*> > >::iterator it = mapRankCache.find(blockHash);
+    if(it != mapRankCache.end()) {
+        return it->second;
+    }
+
+    if(listRankCacheOrder.size() >= MAX_RANK_CACHE_BLOCKS) {
+        mapRankCache.erase(listRankCacheOrder.front());
+        listRankCacheOrder.pop_front();
+    }
+
+    std::vector<std::pair<int64_t, CZnode*> >& vecZnodeScores = mapRankCache[blockHash];
+    listRankCacheOrder.push_back(blockHash);
+
+    vecZnodeScores.reserve(vIndexnodes.size());
+    BOOST_FOREACH(CZnode& mn, vIndexnodes) {
+        int64_t nScore = mn.CalculateScore(blockHash).GetCompact(false);
+        vecZnodeScores.push_back(std::make_pair(nScore, &mn));
+    }
+
+    sort(vecZnodeScores.rbegin(), vecZnodeScores.rend(), CompareScoreMN());
+
+    return vecZnodeScores;
+}
+
 void CZnodeMan::AskForMN(CNode* pnode, const CTxIn &vin)
 {
     if(!pnode) return;
@@ -245,6 +302,7 @@ void CZnodeMan::CheckAndRemove()
         std::vector<std::pair<int, CZnode> > vecZnodeRanks;
         // ask for up to MNB_RECOVERY_MAX_ASK_ENTRIES indexnode entries at a time
         int nAskForMnbRecovery = MNB_RECOVERY_MAX_ASK_ENTRIES;
+        bool fRemoved = false;
         while(it != vIndexnodes.end()) {
             CZnodeBroadcast mnb = CZnodeBroadcast(*it);
             uint256 hash = mnb.GetHash();
@@ -259,7 +317,9 @@ void CZnodeMan::CheckAndRemove()
                 // and finally remove it from the list
 //                it->FlagGovernanceItemsAsDirty();
                 it = vIndexnodes.erase(it);
+                ClearRankCache();
                 fIndexnodesRemoved = true;
+                fRemoved = true;
             } else {
                 bool fAsk = pCurrentBlockIndex &&
                             (nAskForMnbRecovery > 0) &&
@@ -296,6 +356,11 @@ void CZnodeMan::CheckAndRemove()
             }
         }
 
+        // erasing shifted the remaining entries
+        if(fRemoved) {
+            RebuildZnodeIndexes();
+        }
+
         // proces replies for INDEXNODE_NEW_START_REQUIRED indexnodes
         LogPrint("indexnode", "CZnodeMan::CheckAndRemove -- mMnbRecoveryGoodReplies size=%d\n", (int)mMnbRecoveryGoodReplies.size());
         std::map<uint256, std::vector<CZnodeBroadcast> >::iterator itMnbReplies = mMnbRecoveryGoodReplies.begin();
@@ -428,6 +493,10 @@ void CZnodeMan::Clear()
     nLastWatchdogVoteTime = 0;
     indexIndexnodes.Clear();
     indexIndexnodesOld.Clear();
+    mapIndexnodeByOutpoint.clear();
+    mapIndexnodeByPubKey.clear();
+    mapIndexnodeByCollateral.clear();
+    ClearRankCache();
 }
 
 int CZnodeMan::CountIndexnodes(int nProtocolVersion)
@@ -500,14 +569,16 @@ CZnode* CZnodeMan::Find(const std::string &txHash, const std::string &outputInde
 {
     LOCK(cs);
 
-    BOOST_FOREACH(CZnode& mn, vIndexnodes)
-    {
-        COutPoint outpoint = mn.vin.prevout;
+    COutPoint outpoint(uint256S(txHash), (uint32_t)atoi64(outputIndex));
+    std::unordered_map<COutPoint, size_t, SaltedOutpointHasher>::const_iterator it = mapIndexnodeByOutpoint.find(outpoint);
+    if(it == mapIndexnodeByOutpoint.end())
+        return NULL;
 
-        if(txHash==outpoint.hash.ToString().substr(0,64) &&
-           outputIndex==to_string(outpoint.n))
-            return &mn;
-    }
+    // only accept the exact textual form, as matching against ToString() used to
+    CZnode& mn = vIndexnodes[it->second];
+    if(txHash==mn.vin.prevout.hash.ToString().substr(0,64) &&
+       outputIndex==to_string(mn.vin.prevout.n))
+        return &mn;
     return NULL;
 }
 
@@ -515,11 +586,21 @@ CZnode* CZnodeMan::Find(const CScript &payee)
 {
     LOCK(cs);
 
-    BOOST_FOREACH(CZnode& mn, vIndexnodes)
-    {
-        if(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()) == payee)
-            return &mn;
-    }
+    // indexnodes are only ever paid to the P2PKH script of their collateral key
+    CTxDestination dest;
+    if(!ExtractDestination(payee, dest))
+        return NULL;
+    const CKeyID *keyID = boost::get<CKeyID>(&dest);
+    if(!keyID)
+        return NULL;
+
+    std::unordered_map<CKeyID, size_t, SaltedZnodeKeyHasher>::const_iterator it = mapIndexnodeByCollateral.find(*keyID);
+    if(it == mapIndexnodeByCollateral.end())
+        return NULL;
+
+    CZnode& mn = vIndexnodes[it->second];
+    if(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()) == payee)
+        return &mn;
     return NULL;
 }
 
@@ -527,23 +608,24 @@ CZnode* CZnodeMan::Find(const CTxIn &vin)
 {
     LOCK(cs);
 
-    BOOST_FOREACH(CZnode& mn, vIndexnodes)
-    {
-        if(mn.vin.prevout == vin.prevout)
-            return &mn;
-    }
-    return NULL;
+    std::unordered_map<COutPoint, size_t, SaltedOutpointHasher>::const_iterator it = mapIndexnodeByOutpoint.find(vin.prevout);
+    if(it == mapIndexnodeByOutpoint.end())
+        return NULL;
+    return &vIndexnodes[it->second];
 }
 
 CZnode* CZnodeMan::Find(const CPubKey &pubKeyZnode)
 {
     LOCK(cs);
 
-    BOOST_FOREACH(CZnode& mn, vIndexnodes)
-    {
-        if(mn.pubKeyZnode == pubKeyZnode)
-            return &mn;
-    }
+    std::unordered_map<CPubKey, size_t, SaltedZnodeKeyHasher>::const_iterator it = mapIndexnodeByPubKey.find(pubKeyZnode);
+    if(it == mapIndexnodeByPubKey.end())
+        return NULL;
+
+    // the key may be stale if the indexnode changed its key since it was indexed
+    CZnode& mn = vIndexnodes[it->second];
+    if(mn.pubKeyZnode == pubKeyZnode)
+        return &mn;
     return NULL;
 }
 
@@ -799,8 +881,6 @@ CZnode* CZnodeMan::FindRandomNotInVec(const std::vector<CTxIn> &vecToExclude, in
 
 int CZnodeMan::GetZnodeRank(const CTxIn& vin, int nBlockHeight, int nMinProtocol, bool fOnlyActive)
 {
-    std::vector<std::pair<int64_t, CZnode*> > vecZnodeScores;
-
     //make sure we know about this block
     uint256 blockHash = uint256();
     if(!GetBlockHash(blockHash, nBlockHeight)) return -1;
@@ -808,7 +888,9 @@ int CZnodeMan::GetZnodeRank(const CTxIn& vin, int nBlockHeight, int nMinProtocol
     LOCK(cs);
 
     // scan for winner
-    BOOST_FOREACH(CZnode& mn, vIndexnodes) {
+    int nRank = 0;
+    BOOST_FOREACH (const PAIRTYPE(int64_t, CZnode*)& scorePair, GetSortedScores(blockHash)) {
+        CZnode& mn = *scorePair.second;
         if(mn.nProtocolVersion < nMinProtocol) continue;
         if(fOnlyActive) {
             if(!mn.IsEnabled()) continue;
@@ -816,17 +898,8 @@ int CZnodeMan::GetZnodeRank(const CTxIn& vin, int nBlockHeight, int nMinProtocol
         else {
             if(!mn.IsValidForPayment()) continue;
         }
-        int64_t nScore = mn.CalculateScore(blockHash).GetCompact(false);
-
-        vecZnodeScores.push_back(std::make_pair(nScore, &mn));
-    }
-
-    sort(vecZnodeScores.rbegin(), vecZnodeScores.rend(), CompareScoreMN());
-
-    int nRank = 0;
-    BOOST_FOREACH (PAIRTYPE(int64_t, CZnode*)& scorePair, vecZnodeScores) {
         nRank++;
-        if(scorePair.second->vin.prevout == vin.prevout) return nRank;
+        if(mn.vin.prevout == vin.prevout) return nRank;
     }
 
     return -1;
@@ -834,7 +907,6 @@ int CZnodeMan::GetZnodeRank(const CTxIn& vin, int nBlockHeight, int nMinProtocol
 
 std::vector<std::pair<int, CZnode> > CZnodeMan::GetZnodeRanks(int nBlockHeight, int nMinProtocol)
 {
-    std::vector<std::pair<int64_t, CZnode*> > vecZnodeScores;
     std::vector<std::pair<int, CZnode> > vecZnodeRanks;
 
     //make sure we know about this block
@@ -844,19 +916,9 @@ std::vector<std::pair<int, CZnode> > CZnodeMan::GetZnodeRanks(int nBlockHeight,
     LOCK(cs);
 
     // scan for winner
-    BOOST_FOREACH(CZnode& mn, vIndexnodes) {
-
-        if(mn.nProtocolVersion < nMinProtocol || !mn.IsEnabled()) continue;
-
-        int64_t nScore = mn.CalculateScore(blockHash).GetCompact(false);
-
-        vecZnodeScores.push_back(std::make_pair(nScore, &mn));
-    }
-
-    sort(vecZnodeScores.rbegin(), vecZnodeScores.rend(), CompareScoreMN());
-
     int nRank = 0;
-    BOOST_FOREACH (PAIRTYPE(int64_t, CZnode*)& s, vecZnodeScores) {
+    BOOST_FOREACH (const PAIRTYPE(int64_t, CZnode*)& s, GetSortedScores(blockHash)) {
+        if(s.second->nProtocolVersion < nMinProtocol || !s.second->IsEnabled()) continue;
         nRank++;
         vecZnodeRanks.push_back(std::make_pair(nRank, *s.second));
     }
@@ -866,8 +928,6 @@ std::vector<std::pair<int, CZnode> > CZnodeMan::GetZnodeRanks(int nBlockHeight,
 
 CZnode* CZnodeMan::GetZnodeByRank(int nRank, int nBlockHeight, int nMinProtocol, bool fOnlyActive)
 {
-    std::vector<std::pair<int64_t, CZnode*> > vecZnodeScores;
-
     LOCK(cs);
 
     uint256 blockHash;
@@ -876,21 +936,10 @@ CZnode* CZnodeMan::GetZnodeByRank(int nRank, int nBlockHeight, int nMinProtocol,
         return NULL;
     }
 
-    // Fill scores
-    BOOST_FOREACH(CZnode& mn, vIndexnodes) {
-
-        if(mn.nProtocolVersion < nMinProtocol) continue;
-        if(fOnlyActive && !mn.IsEnabled()) continue;
-
-        int64_t nScore = mn.CalculateScore(blockHash).GetCompact(false);
-
-        vecZnodeScores.push_back(std::make_pair(nScore, &mn));
-    }
-
-    sort(vecZnodeScores.rbegin(), vecZnodeScores.rend(), CompareScoreMN());
-
     int rank = 0;
-    BOOST_FOREACH (PAIRTYPE(int64_t, CZnode*)& s, vecZnodeScores){
+    BOOST_FOREACH (const PAIRTYPE(int64_t, CZnode*)& s, GetSortedScores(blockHash)){
+        if(s.second->nProtocolVersion < nMinProtocol) continue;
+        if(fOnlyActive && !s.second->IsEnabled()) continue;
         rank++;
         if(rank == nRank) {
             return s.second;
@@ -1579,6 +1628,7 @@ void CZnodeMan::UpdateZnodeList(CZnodeBroadcast mnb)
         } else {
             CZnodeBroadcast mnbOld = mapSeenZnodeBroadcast[CZnodeBroadcast(*pmn).GetHash()].second;
             if (pmn->UpdateFromNewBroadcast(mnb)) {
+                IndexZnode(pmn - &vIndexnodes[0]);
                 indexnodeSync.AddedZnodeList();
                 mapSeenZnodeBroadcast.erase(mnbOld.GetHash());
             }
@@ -1647,6 +1697,8 @@ bool CZnodeMan::CheckMnbAndUpdateZnodeList(CNode* pfrom, CZnodeBroadcast mnb, in
                 LogPrint("indexnode", "CZnodeMan::CheckMnbAndUpdateZnodeList -- Update() failed, indexnode=%s\n", mnb.vin.prevout.ToStringShort());
                 return false;
             }
+            // the indexnode key may have changed
+            IndexZnode(pmn - &vIndexnodes[0]);
             if (hash != mnbOld.GetHash()) {
                 mapSeenZnodeBroadcast.erase(mnbOld.GetHash());
             }
@@ -8,6 +8,9 @@
 #include "indexnode.h"
 #include "sync.h"
 
+#include <list>
+#include <unordered_map>
+
 using namespace std;
 
 class CZnodeMan;
@@ -78,6 +81,28 @@ private:
 
 };
 
+/**
+ * Salted hasher for the key types CZnodeMan indexes its nodes by. The keys come
+ * from the network, so they are run through SipHash to keep the buckets balanced.
+ */
+class SaltedZnodeKeyHasher
+{
+private:
+    /** Salt */
+    const uint64_t k0, k1;
+
+public:
+    SaltedZnodeKeyHasher();
+
+    size_t operator()(const CPubKey& pubKey) const {
+        return CSipHasher(k0, k1).Write(pubKey.begin(), pubKey.size()).Finalize();
+    }
+
+    size_t operator()(const CKeyID& keyID) const {
+        return CSipHasher(k0, k1).Write(keyID.begin(), keyID.size()).Finalize();
+    }
+};
+
 class CZnodeMan
 {
 public:
@@ -110,6 +135,8 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    /// Number of block hashes to keep sorted indexnode scores for
+    static const size_t MAX_RANK_CACHE_BLOCKS = 8;
 
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -119,6 +146,15 @@ private:
 
     // map to hold all MNs
     std::vector<CZnode> vIndexnodes;
+    // positions in vIndexnodes by collateral outpoint, indexnode key and collateral key id,
+    // rebuilt whenever entries are removed (lookups verify the entry they land on)
+    std::unordered_map<COutPoint, size_t, SaltedOutpointHasher> mapIndexnodeByOutpoint;
+    std::unordered_map<CPubKey, size_t, SaltedZnodeKeyHasher> mapIndexnodeByPubKey;
+    std::unordered_map<CKeyID, size_t, SaltedZnodeKeyHasher> mapIndexnodeByCollateral;
+    // all indexnodes sorted by score (best first) for recently ranked block hashes,
+    // dropped whenever vIndexnodes is modified
+    std::map<uint256, std::vector<std::pair<int64_t, CZnode*> > > mapRankCache;
+    std::list<uint256> listRankCacheOrder;
     // who's asked for the Znode list and the last time
     std::map<CNetAddr, int64_t> mAskedUsForZnodeList;
     // who we asked for the Znode list and the last time
@@ -156,6 +192,15 @@ private:
 
     friend class CZnodeSync;
 
+    /// (Re)insert the entry at nIndex into the lookup indexes
+    void IndexZnode(size_t nIndex);
+    /// Rebuild the lookup indexes from scratch and drop cached ranks, after vIndexnodes changed
+    void RebuildZnodeIndexes();
+    /// Drop cached ranks, they point into vIndexnodes
+    void ClearRankCache();
+    /// All indexnodes sorted by their score for blockHash, best first
+    const std::vector<std::pair<int64_t, CZnode*> >& GetSortedScores(const uint256& blockHash);
+
 public:
     // Keep track of all broadcasts I've seen
     std::map<uint256, std::pair<int64_t, CZnodeBroadcast> > mapSeenZnodeBroadcast;
@@ -196,6 +241,9 @@ public:
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if(ser_action.ForRead()) {
+            RebuildZnodeIndexes();
+        }
     }
 
     CZnodeMan();
@@ -11,11 +11,13 @@
 
 #include "addrman.h"
 #include "amount.h"
+#include "blockprefetch.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
+#include "crypto/sha256.h"
 #include "httpserver.h"
 #include "httprpc.h"
 #include "key.h"
@@ -130,7 +132,9 @@ static CDSNotificationInterface* pdsNotificationInterface = NULL;
 // anyway.
 #define MIN_CORE_FILEDESCRIPTORS 0
 #else
-#define MIN_CORE_FILEDESCRIPTORS 150
+// Includes the LevelDB databases: their logs and manifests, and on 32-bit systems
+// up to DB_MAX_OPEN_FILES_UNMAPPED table files each, as tables are not mapped there
+#define MIN_CORE_FILEDESCRIPTORS 350
 #endif
 
 /** Used to pass flags to the Bind() function */
@@ -282,6 +286,7 @@ void PrepareShutdown()
     UnregisterValidationInterface(peerLogic.get());
     peerLogic.reset();
     g_connman.reset();
+    StopHeaderCheckThreads();
 
    if (!fLiteMode) {
         // STORE DATA CACHES INTO SERIALIZED DAT FILES
@@ -324,6 +329,8 @@ void PrepareShutdown()
         }
         delete pcoinsTip;
         pcoinsTip = NULL;
+        delete pcoinsFlushBuffer;
+        pcoinsFlushBuffer = NULL;
         delete pcoinscatcher;
         pcoinscatcher = NULL;
         delete pcoinsdbview;
@@ -473,7 +480,11 @@ std::string HelpMessage(HelpMessageMode mode)
 #endif
     }
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
+    strUsage += HelpMessageOpt("-asyncflush", strprintf(_("Write the database cache to disk in the background, memory use can reach twice -dbcache while a write runs (default: %u)"), DEFAULT_ASYNC_FLUSH));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+#ifdef USE_SNAPPY
+    strUsage += HelpMessageOpt("-dbcompression", strprintf(_("Compress the block index, evodb and elysium databases with Snappy; once written they cannot be opened by builds without Snappy support, so keep using a build with it or reindex (default: %u)"), DEFAULT_DB_COMPRESSION));
+#endif
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file on startup"));
@@ -483,6 +494,8 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
+    strUsage += HelpMessageOpt("-parheaders=<n>", strprintf(_("Set the number of threads checking the proof of work of received headers (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
+        -GetNumCores(), MAX_HEADERCHECK_THREADS, DEFAULT_HEADERCHECK_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), BITCOIN_PID_FILENAME));
 #endif
@@ -496,6 +509,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
     strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"), DEFAULT_TXINDEX));
+    strUsage += HelpMessageOpt("-utxostats", strprintf(_("Maintain UTXO set statistics for every block, used by gettxoutsetinfo with hash_type muhash (default: %u)"), DEFAULT_UTXOSTATS));
 
     strUsage += HelpMessageGroup(_("Connection options:"));
     strUsage += HelpMessageOpt("-addnode=<ip>", _("Add a node to connect to and attempt to keep the connection open"));
@@ -557,6 +571,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-uacomment=<cmt>", _("Append comment to the user agent string"));
     if (showDebug)
     {
+        strUsage += HelpMessageOpt("-blockprefetchthreads=<n>", strprintf("Number of threads reading blocks ahead of -reindex-chainstate, the wallet rescan, -checkblocks and the Elysium scan (default: %u)", DEFAULT_BLOCK_PREFETCH_THREADS));
         strUsage += HelpMessageOpt("-checkblocks=<n>", strprintf(_("How many blocks to check at startup (default: %u, 0 = all)"), DEFAULT_CHECKBLOCKS));
         strUsage += HelpMessageOpt("-checklevel=<n>", strprintf(_("How thorough the block verification of -checkblocks is (0-4, default: %u)"), DEFAULT_CHECKLEVEL));
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", Params(CBaseChainParams::MAIN).DefaultConsistencyChecks()));
@@ -1464,6 +1479,10 @@ bool AppInitSanityChecks()
 {
     // ********************************************************* Step 4: sanity checks
 
+    // Pick the fastest SHA256 implementations the CPU supports
+    std::string sha256_algo = SHA256AutoDetect();
+    LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+
     // Initialize elliptic curve code
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1515,6 +1534,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    // -parheaders=0 means autodetect, as for -par
+    int nHeaderCheckThreads = GetArg("-parheaders", DEFAULT_HEADERCHECK_THREADS);
+    if (nHeaderCheckThreads <= 0)
+        nHeaderCheckThreads += GetNumCores();
+    nHeaderCheckThreads = std::min(nHeaderCheckThreads, MAX_HEADERCHECK_THREADS);
+    LogPrintf("Using %d threads for header proof of work checks\n", std::max(nHeaderCheckThreads, 1));
+    StartHeaderCheckThreads(nHeaderCheckThreads);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1803,6 +1830,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             try {
                 UnloadBlockIndex();
                 delete pcoinsTip;
+                delete pcoinsFlushBuffer;
                 delete pcoinsdbview;
                 delete pcoinscatcher;
                 llmq::DestroyLLMQSystem();
@@ -1826,7 +1854,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
                 pcoinsdbview = new CCoinsViewDB(nCoinDBCache, false, fReindex || fReindexChainState);
                 pcoinscatcher = new CCoinsViewErrorCatcher(pcoinsdbview);
-                pcoinsTip = new CCoinsViewCache(pcoinscatcher);
+                pcoinsFlushBuffer = GetBoolArg("-asyncflush", DEFAULT_ASYNC_FLUSH) ? new CCoinsViewFlushBuffer(pcoinscatcher) : NULL;
+                pcoinsTip = new CCoinsViewCache(pcoinsFlushBuffer ? static_cast<CCoinsView*>(pcoinsFlushBuffer) : pcoinscatcher);
                 llmq::InitLLMQSystem(*evoDb, &scheduler, false, fReindex || fReindexChainState);
 
                 if (fReindex) {
@@ -1882,6 +1911,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
+                // Check for changed -utxostats state
+                if (fUTXOStats != GetBoolArg("-utxostats", DEFAULT_UTXOSTATS)) {
+                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -utxostats");
+                    break;
+                }
+
                 // Check for changed -prune state.  What we are concerned about is a user who has pruned blocks
                 // in the past, but is now trying to run unpruned.
                 if (fHavePruned && !fPruneMode) {
@@ -58,7 +58,7 @@ void Accumulator::accumulate(const PublicCoin& coin, bool validateCoin) {
 
 	if(!validateCoin || coin.validate()) {
 		// Compute new accumulator = "old accumulator"^{element} mod N
-		this->value = this->value.pow_mod(coin.getValue(), this->params->accumulatorModulus);
+		this->value = this->params->powAccumulator(this->value, coin.getValue());
 	} else {
 		throw ZerocoinException("Coin is not valid");
 	}
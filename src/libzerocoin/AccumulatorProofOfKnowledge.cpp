@@ -144,37 +144,26 @@ namespace libzerocoin {
 
         Bignum c = Bignum(hasher.GetHash()); //this hash should be of length k_prime bits
 
-        Bignum st_1_prime = (valueOfCommitmentToCoin.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) *
-                             sg.pow_mod(s_alpha, params->accumulatorPoKCommitmentGroup.modulus) *
-                             sh.pow_mod(s_phi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
-        Bignum st_2_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * ((valueOfCommitmentToCoin *
-                                                                                              sg.inverse(
-                                                                                                      params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(
-                s_gamma, params->accumulatorPoKCommitmentGroup.modulus)) *
-                             sh.pow_mod(s_psi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
-        Bignum st_3_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) *
-                             (sg * valueOfCommitmentToCoin).pow_mod(s_sigma,
-                                                                    params->accumulatorPoKCommitmentGroup.modulus) *
-                             sh.pow_mod(s_xi, params->accumulatorPoKCommitmentGroup.modulus)) %
-                            params->accumulatorPoKCommitmentGroup.modulus;
-
-        Bignum t_1_prime =
-                (C_r.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_zeta, params->accumulatorModulus) *
-                 g_n.pow_mod(s_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
-        Bignum t_2_prime =
-                (C_e.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_eta, params->accumulatorModulus) *
-                 g_n.pow_mod(s_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
-
-        Bignum t_3_prime = ((a.getValue()).pow_mod(c, params->accumulatorModulus) *
-                            C_u.pow_mod(s_alpha, params->accumulatorModulus) *
-                            ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) %
+        const IntegerGroupParams& pokGroup = params->accumulatorPoKCommitmentGroup;
+
+        Bignum st_1_prime = (pokGroup.pow(valueOfCommitmentToCoin, c) * pokGroup.powG(s_alpha) * pokGroup.powH(s_phi)) %
+                            pokGroup.modulus;
+        Bignum st_2_prime = (pokGroup.powG(c) *
+                             pokGroup.pow(valueOfCommitmentToCoin * sg.inverse(pokGroup.modulus), s_gamma) *
+                             pokGroup.powH(s_psi)) % pokGroup.modulus;
+        Bignum st_3_prime = (pokGroup.powG(c) * pokGroup.pow(sg * valueOfCommitmentToCoin, s_sigma) * pokGroup.powH(s_xi)) %
+                            pokGroup.modulus;
+
+        // (h_n^-1)^s is h_n^-s, the tables of the generators take negative exponents
+        Bignum t_1_prime = (params->powAccumulator(C_r, c) * params->powQRNH(s_zeta) * params->powQRNG(s_epsilon)) %
                            params->accumulatorModulus;
+        Bignum t_2_prime = (params->powAccumulator(C_e, c) * params->powQRNH(s_eta) * params->powQRNG(s_alpha)) %
+                           params->accumulatorModulus;
+
+        Bignum t_3_prime = (params->powAccumulator(a.getValue(), c) * params->powAccumulator(C_u, s_alpha) *
+                            params->powQRNH(-s_beta)) % params->accumulatorModulus;
 
-        Bignum t_4_prime = (C_r.pow_mod(s_alpha, params->accumulatorModulus) *
-                            ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_delta, params->accumulatorModulus)) *
-                            ((g_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) %
+        Bignum t_4_prime = (params->powAccumulator(C_r, s_alpha) * params->powQRNH(-s_delta) * params->powQRNG(-s_beta)) %
                            params->accumulatorModulus;
 
         bool result = false;
@@ -35,11 +35,77 @@ IntegerGroupParams::IntegerGroupParams() {
 	this->initialized = false;
 }
 
+GroupPrecomputation::GroupPrecomputation(const CBigNum& g, const CBigNum& h, const CBigNum& modulus, int maxExponentBits)
+	: mont(modulus), gTable(g, mont, maxExponentBits), hTable(h, mont, maxExponentBits) {
+}
+
+bool GroupPrecomputation::matches(const CBigNum& g, const CBigNum& h, const CBigNum& modulus) const {
+	return mont.getModulus() == modulus && gTable.getBase() == g && hTable.getBase() == h;
+}
+
+std::shared_ptr<const GroupPrecomputation> GetGroupPrecomputation(std::shared_ptr<const GroupPrecomputation>& cache,
+		const CBigNum& g, const CBigNum& h, const CBigNum& modulus, int maxExponentBits) {
+	// The parameters are public members that may be filled in or deserialized
+	// after the first use, so the cached tables are checked against them. Two
+	// threads racing to build them both do, one of the results is kept.
+	std::shared_ptr<const GroupPrecomputation> result = std::atomic_load(&cache);
+	if (!result || !result->matches(g, h, modulus)) {
+		result = std::make_shared<const GroupPrecomputation>(g, h, modulus, maxExponentBits);
+		std::atomic_store(&cache, result);
+	}
+	return result;
+}
+
+std::shared_ptr<const GroupPrecomputation> IntegerGroupParams::getPrecomputation() const {
+	return GetGroupPrecomputation(this->precomputation, this->g, this->h, this->modulus, this->groupOrder.bitSize());
+}
+
+CBigNum IntegerGroupParams::reduceExponent(const CBigNum& e) const {
+	// g and h have order groupOrder, so only the exponent mod groupOrder matters
+	if (e >= 0 && e < this->groupOrder)
+		return e;
+	CBigNum result = e % this->groupOrder;
+	if (result < 0)
+		result += this->groupOrder;
+	return result;
+}
+
+CBigNum IntegerGroupParams::powG(const CBigNum& e) const {
+	return getPrecomputation()->gTable.pow_mod(reduceExponent(e));
+}
+
+CBigNum IntegerGroupParams::powH(const CBigNum& e) const {
+	return getPrecomputation()->hTable.pow_mod(reduceExponent(e));
+}
+
+CBigNum IntegerGroupParams::pow(const CBigNum& base, const CBigNum& e) const {
+	return base.pow_mod(e, getPrecomputation()->mont);
+}
+
+std::shared_ptr<const GroupPrecomputation> AccumulatorAndProofParams::getPrecomputation() const {
+	// The exponents of the accumulator proof are up to k_prime + k_dprime bits
+	// longer than the modulus, the few even longer ones fall back to pow_mod
+	return GetGroupPrecomputation(this->precomputation, this->accumulatorQRNCommitmentGroup.g, this->accumulatorQRNCommitmentGroup.h,
+			this->accumulatorModulus, this->accumulatorModulus.bitSize() + this->k_prime + this->k_dprime);
+}
+
+CBigNum AccumulatorAndProofParams::powQRNG(const CBigNum& e) const {
+	return getPrecomputation()->gTable.pow_mod(e);
+}
+
+CBigNum AccumulatorAndProofParams::powQRNH(const CBigNum& e) const {
+	return getPrecomputation()->hTable.pow_mod(e);
+}
+
+CBigNum AccumulatorAndProofParams::powAccumulator(const CBigNum& base, const CBigNum& e) const {
+	return base.pow_mod(e, getPrecomputation()->mont);
+}
+
 Bignum IntegerGroupParams::randomElement() const {
 	// The generator of the group raised
 	// to a random number less than the order of the group
 	// provides us with a uniformly distributed random number.
-	return this->g.pow_mod(Bignum::randBignum(this->groupOrder),this->modulus);
+	return this->powG(Bignum::randBignum(this->groupOrder));
 }
 
 } /* namespace libzerocoin */
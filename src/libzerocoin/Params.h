@@ -13,8 +13,35 @@
 #define PARAMS_H_
 #include "Zerocoin.h"
 
+#include <memory>
+
 namespace libzerocoin {
 
+/**
+ * Montgomery context of the modulus of a group and fixed-base exponentiation
+ * tables of its two generators. Building it takes a few hundred modular
+ * multiplications, so it is done on first use and then shared by every proof
+ * made or verified with the parameters.
+ */
+class GroupPrecomputation {
+public:
+	GroupPrecomputation(const CBigNum& g, const CBigNum& h, const CBigNum& modulus, int maxExponentBits);
+
+	/** Whether it was built for these generators and modulus */
+	bool matches(const CBigNum& g, const CBigNum& h, const CBigNum& modulus) const;
+
+	const CBigNumMontCtx mont;
+	const CBigNumFixedBase gTable;
+	const CBigNumFixedBase hTable;
+};
+
+/**
+ * The precomputation in cache if it matches g, h and modulus, otherwise a new
+ * one, stored in cache. Safe to call concurrently on the same cache.
+ */
+std::shared_ptr<const GroupPrecomputation> GetGroupPrecomputation(std::shared_ptr<const GroupPrecomputation>& cache,
+		const CBigNum& g, const CBigNum& h, const CBigNum& modulus, int maxExponentBits);
+
 class IntegerGroupParams {
 public:
 	/** @brief Integer group class, default constructor
@@ -52,6 +79,18 @@ public:
 	 */
     CBigNum groupOrder;
 
+	/**
+	 * g^e mod modulus with the precomputed table of g. The exponent is reduced
+	 * modulo the order of the group first, so any exponent takes the table.
+	 */
+	CBigNum powG(const CBigNum& e) const;
+
+	/** h^e mod modulus with the precomputed table of h */
+	CBigNum powH(const CBigNum& e) const;
+
+	/** base^e mod modulus with the Montgomery context of the modulus */
+	CBigNum pow(const CBigNum& base, const CBigNum& e) const;
+
 	ADD_SERIALIZE_METHODS;
 
 	template <typename Stream, typename Operation>
@@ -63,6 +102,12 @@ public:
 		READWRITE(groupOrder);
 	};
 
+private:
+	mutable std::shared_ptr<const GroupPrecomputation> precomputation;
+
+	std::shared_ptr<const GroupPrecomputation> getPrecomputation() const;
+	CBigNum reduceExponent(const CBigNum& e) const;
+
 };
 
 class AccumulatorAndProofParams {
@@ -138,6 +183,16 @@ public:
 	 * The statistical zero-knowledgeness of the accumulator proof.
 	 */
 	uint32_t k_dprime;
+
+	/**
+	 * g^e and h^e mod accumulatorModulus for the generators of the
+	 * accumulator QRN commitment group, with their precomputed tables
+	 */
+	CBigNum powQRNG(const CBigNum& e) const;
+	CBigNum powQRNH(const CBigNum& e) const;
+
+	/** base^e mod accumulatorModulus with its Montgomery context */
+	CBigNum powAccumulator(const CBigNum& base, const CBigNum& e) const;
 	ADD_SERIALIZE_METHODS;
 
 	template <typename Stream, typename Operation>
@@ -152,6 +207,11 @@ public:
 		READWRITE(k_prime);
 		READWRITE(k_dprime);
 	};
+
+private:
+	mutable std::shared_ptr<const GroupPrecomputation> precomputation;
+
+	std::shared_ptr<const GroupPrecomputation> getPrecomputation() const;
 };
 
 class Params {
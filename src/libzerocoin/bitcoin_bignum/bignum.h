@@ -48,6 +48,8 @@ public:
 };
 
 
+class CBigNumMontCtx;
+
 /** C++ wrapper for BIGNUM (OpenSSL bignum) */class CBigNum
 {
 protected:
@@ -549,6 +551,14 @@ public:
         return ret;
     }
 
+    /**
+     * modular exponentiation: this^e mod the modulus of mont, reusing its
+     * Montgomery context instead of setting one up for every call
+     * @param e exponent
+     * @param mont Montgomery context of the modulus
+     */
+    CBigNum pow_mod(const CBigNum& e, const CBigNumMontCtx& mont) const;
+
     /**
      * Calculates the inverse of this element mod m.
      * i.e. i such this*i = 1 mod m
@@ -797,6 +807,158 @@ inline bool operator<(const CBigNum& a, const CBigNum& b)  { return (BN_cmp(&a,
 inline bool operator>(const CBigNum& a, const CBigNum& b)  { return (BN_cmp(&a, &b) > 0); }
 inline std::ostream& operator<<(std::ostream &strm, const CBigNum &b) { return strm << b.ToString(10); }
 
+/**
+ * RAII encapsulated BN_MONT_CTX (OpenSSL Montgomery context) of a fixed odd
+ * modulus. Setting one up costs about as much as a modular inversion, which
+ * every BN_mod_exp call does again; parameters with fixed moduli keep one and
+ * share it between threads, it is only read once set up.
+ */
+class CBigNumMontCtx
+{
+private:
+    BN_MONT_CTX* mont;
+    const CBigNum modulus;
+
+public:
+    explicit CBigNumMontCtx(const CBigNum& m) : mont(BN_MONT_CTX_new()), modulus(m)
+    {
+        CAutoBN_CTX pctx;
+        if (mont == NULL || !BN_is_odd(&m) || !BN_MONT_CTX_set(mont, &m, pctx)) {
+            BN_MONT_CTX_free(mont);
+            throw bignum_error("CBigNumMontCtx : BN_MONT_CTX_set failed");
+        }
+    }
+
+    ~CBigNumMontCtx()
+    {
+        BN_MONT_CTX_free(mont);
+    }
+
+    CBigNumMontCtx(const CBigNumMontCtx&) = delete;
+    CBigNumMontCtx& operator=(const CBigNumMontCtx&) = delete;
+
+    BN_MONT_CTX* get() const { return mont; }
+    const CBigNum& getModulus() const { return modulus; }
+
+    /** a * b mod the modulus, all of them in Montgomery form */
+    void mul(CBigNum& r, const CBigNum& a, const CBigNum& b, BN_CTX* pctx) const
+    {
+        if (!BN_mod_mul_montgomery(&r, &a, &b, mont, pctx))
+            throw bignum_error("CBigNumMontCtx::mul : BN_mod_mul_montgomery failed");
+    }
+
+    CBigNum toMontgomery(const CBigNum& a, BN_CTX* pctx) const
+    {
+        CBigNum r;
+        if (!BN_nnmod(&r, &a, &modulus, pctx) || !BN_to_montgomery(&r, &r, mont, pctx))
+            throw bignum_error("CBigNumMontCtx::toMontgomery : BN_to_montgomery failed");
+        return r;
+    }
+
+    CBigNum fromMontgomery(const CBigNum& a, BN_CTX* pctx) const
+    {
+        CBigNum r;
+        if (!BN_from_montgomery(&r, &a, mont, pctx))
+            throw bignum_error("CBigNumMontCtx::fromMontgomery : BN_from_montgomery failed");
+        return r;
+    }
+};
+
+inline CBigNum CBigNum::pow_mod(const CBigNum& e, const CBigNumMontCtx& mont) const {
+    if (e < 0)
+        return pow_mod(e, mont.getModulus());
+
+    CAutoBN_CTX pctx;
+    CBigNum ret;
+    if (!BN_mod_exp_mont(&ret, bn, &e, &mont.getModulus(), pctx, mont.get()))
+        throw bignum_error("CBigNum::pow_mod : BN_mod_exp_mont failed");
+    return ret;
+}
+
+/**
+ * Exponentiation of a fixed base mod a fixed modulus with a precomputed table
+ * of base^(d * 2^(WINDOW_BITS * i)) for every digit d and window i of the
+ * exponent, kept in Montgomery form. An exponentiation then takes one
+ * Montgomery multiplication per window instead of a squaring per bit and a
+ * multiplication per window, about four times less work for the exponents of
+ * the zerocoin proofs. A negative exponent takes an inversion of the result,
+ * exponents longer than the table fall back to pow_mod with the Montgomery
+ * context.
+ */
+class CBigNumFixedBase
+{
+private:
+    static const int WINDOW_BITS = 4;
+    static const int WINDOW_DIGITS = (1 << WINDOW_BITS) - 1;
+
+    const CBigNum base;
+    const CBigNumMontCtx& mont;
+    const int maxBits;
+    //! Entry i * WINDOW_DIGITS + d - 1 is base^(d * 2^(WINDOW_BITS * i))
+    std::vector<CBigNum> table;
+
+public:
+    /**
+     * @param base the base
+     * @param mont Montgomery context of the modulus, must outlive the table
+     * @param maxBits bit length of the longest exponent the table covers
+     */
+    CBigNumFixedBase(const CBigNum& baseIn, const CBigNumMontCtx& montIn, int maxBitsIn)
+        : base(baseIn), mont(montIn), maxBits(maxBitsIn)
+    {
+        CAutoBN_CTX pctx;
+        const int windows = (maxBits + WINDOW_BITS - 1) / WINDOW_BITS;
+        table.resize(windows * WINDOW_DIGITS);
+
+        CBigNum windowBase = mont.toMontgomery(base, pctx);
+        for (int i = 0; i < windows; i++) {
+            const int first = i * WINDOW_DIGITS;
+            table[first] = windowBase;
+            for (int d = 1; d < WINDOW_DIGITS; d++)
+                mont.mul(table[first + d], table[first + d - 1], windowBase, pctx);
+            // base^(2^(WINDOW_BITS * (i + 1))) = base^(15 * 2^(WINDOW_BITS * i)) * base^(2^(WINDOW_BITS * i))
+            mont.mul(windowBase, table[first + WINDOW_DIGITS - 1], windowBase, pctx);
+        }
+    }
+
+    CBigNumFixedBase(const CBigNumFixedBase&) = delete;
+    CBigNumFixedBase& operator=(const CBigNumFixedBase&) = delete;
+
+    /** base^e mod the modulus */
+    CBigNum pow_mod(const CBigNum& e) const
+    {
+        if (e < 0)
+            return pow_mod(-e).inverse(mont.getModulus());
+        if (e.bitSize() > maxBits)
+            return base.pow_mod(e, mont);
+
+        CAutoBN_CTX pctx;
+        CBigNum acc;
+        bool fStarted = false;
+        const int windows = (e.bitSize() + WINDOW_BITS - 1) / WINDOW_BITS;
+        for (int i = 0; i < windows; i++) {
+            int d = 0;
+            for (int bit = WINDOW_BITS - 1; bit >= 0; bit--)
+                d = (d << 1) | BN_is_bit_set(&e, i * WINDOW_BITS + bit);
+            if (d == 0)
+                continue;
+            const CBigNum& entry = table[i * WINDOW_DIGITS + d - 1];
+            if (fStarted) {
+                mont.mul(acc, acc, entry, pctx);
+            } else {
+                acc = entry;
+                fStarted = true;
+            }
+        }
+
+        if (!fStarted)
+            return CBigNum(1) % mont.getModulus();
+        return mont.fromMontgomery(acc, pctx);
+    }
+
+    const CBigNum& getBase() const { return base; }
+};
+
 typedef CBigNum Bignum;
 
 #endif
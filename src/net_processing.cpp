@@ -2756,9 +2756,11 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         }
 
         const CBlockIndex *pindexLast = NULL;
+        bool fConnects;
         {
         LOCK(cs_main);
         CNodeState *nodestate = State(pfrom->GetId());
+        fConnects = mapBlockIndex.find(headers[0].hashPrevBlock) != mapBlockIndex.end();
 
         // If this looks like it could be a block announcement (nCount <
         // MAX_BLOCKS_TO_ANNOUNCE), use special logic for handling headers that
@@ -2768,7 +2770,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         //   don't connect before giving DoS points
         // - Once a headers message is received that is valid and does connect,
         //   nUnconnectingHeaders gets reset back to 0.
-        if (mapBlockIndex.find(headers[0].hashPrevBlock) == mapBlockIndex.end() && nCount < MAX_BLOCKS_TO_ANNOUNCE) {
+        if (!fConnects && nCount < MAX_BLOCKS_TO_ANNOUNCE) {
             nodestate->nUnconnectingHeaders++;
             connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::GETHEADERS, chainActive.GetLocator(pindexBestHeader), uint256()));
             LogPrint("net", "received header %s: missing prev block %s, sending getheaders (%d) to end (peer=%d, nUnconnectingHeaders=%d)\n",
@@ -2786,19 +2788,38 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             }
             return true;
         }
+        }
+
+        CValidationState state;
+        if (!fConnects) {
+            // Larger messages that do not connect are rejected on their first header, unless
+            // its parent arrived meanwhile. Only that header is hashed before it is known.
+            if (!ProcessNewBlockHeaders(std::vector<CBlockHeader>(1, headers[0]), state, chainparams)) {
+                int nDoS;
+                if (state.IsInvalid(nDoS)) {
+                    if (nDoS > 0) {
+                        LOCK(cs_main);
+                        Misbehaving(pfrom->GetId(), nDoS);
+                    }
+                    return error("invalid header received");
+                }
+            }
+        }
+
+        // Hash the headers and check their proofs of work in parallel, without cs_main
+        CBlockHeaderChecks checks = CheckBlockHeaders(headers, chainparams.GetConsensus());
 
         uint256 hashLastBlock;
-        for (const CBlockHeader& header : headers) {
-            if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (!hashLastBlock.IsNull() && headers[i].hashPrevBlock != hashLastBlock) {
+                LOCK(cs_main);
                 Misbehaving(pfrom->GetId(), 20);
                 return error("non-continuous headers sequence");
             }
-            hashLastBlock = header.GetHash();
-        }
+            hashLastBlock = checks.vChecks[i].hash;
         }
 
-        CValidationState state;
-        if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast)) {
+        if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast, &checks)) {
             int nDoS;
             if (state.IsInvalid(nDoS)) {
                 if (nDoS > 0) {
@@ -8,6 +8,9 @@
 /* Milliseconds between model updates */
 static const int MODEL_UPDATE_DELAY = 250;
 
+/* Transaction list -- wallet transactions decomposed per lock of the wallet while loading */
+static const int TRANSACTION_TABLE_PAGE_SIZE = 1000;
+
 /* AskPassphraseDialog -- Maximum passphrase length */
 static const int MAX_PASSPHRASE_SIZE = 1024;
 
@@ -25,6 +25,7 @@
 #include <QDebug>
 #include <QIcon>
 #include <QList>
+#include <QThread>
 
 #include <boost/foreach.hpp>
 
@@ -55,16 +56,110 @@ struct TxLessThan
     }
 };
 
+/* Decompose a wallet transaction, with its status filled in while the locks are held anyway */
+static QList<TransactionRecord> DecomposeWithStatus(const CWallet *wallet, const CWalletTx &wtx)
+{
+    AssertLockHeld(cs_main);
+    QList<TransactionRecord> records = TransactionRecord::decomposeTransaction(wallet, wtx);
+    for (QList<TransactionRecord>::iterator it = records.begin(); it != records.end(); ++it)
+        it->updateStatus(wtx);
+    return records;
+}
+
+/* Turn wallet transactions into TransactionRecords in a separate thread, so the
+   GUI thread never has to wait for cs_main and cs_wallet to fill the table.
+
+   The wallet is walked in hash order, TRANSACTION_TABLE_PAGE_SIZE transactions
+   per lock. The next page is queued behind the transaction notifications that
+   came in meanwhile, so a big wallet does not hold up other updates, and as
+   everything the model gets comes through this one thread it always arrives in
+   the order the wallet changed.
+*/
+class TransactionTableLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TransactionTableLoader(CWallet *_wallet) :
+        wallet(_wallet),
+        fStarted(false)
+    {
+    }
+
+public Q_SLOTS:
+    void loadPage();
+    void updateTransaction(const QString &hash, int status, bool showTransaction);
+
+Q_SIGNALS:
+    void pageLoaded(const QList<TransactionRecord> &records, bool finished);
+    void transactionUpdated(const QString &hash, int status, bool showTransaction, const QList<TransactionRecord> &records);
+
+private:
+    CWallet *wallet;
+    bool fStarted;
+    /* First transaction of the next page */
+    uint256 hashNext;
+};
+
+#include "transactiontablemodel.moc"
+
+void TransactionTableLoader::loadPage()
+{
+    QList<TransactionRecord> records;
+    bool finished;
+    {
+        LOCK2(cs_main, wallet->cs_wallet);
+        // Transactions added before the position we are at are not missed, they come with a notification
+        std::map<uint256, CWalletTx>::iterator it = fStarted ? wallet->mapWallet.lower_bound(hashNext) : wallet->mapWallet.begin();
+        fStarted = true;
+        for (int n = 0; it != wallet->mapWallet.end() && n < TRANSACTION_TABLE_PAGE_SIZE; ++it, ++n)
+        {
+            if(TransactionRecord::showTransaction(it->second))
+                records.append(DecomposeWithStatus(wallet, it->second));
+        }
+        finished = it == wallet->mapWallet.end();
+        if (!finished)
+            hashNext = it->first;
+    }
+
+    Q_EMIT pageLoaded(records, finished);
+    if (!finished)
+        QMetaObject::invokeMethod(this, "loadPage", Qt::QueuedConnection);
+}
+
+void TransactionTableLoader::updateTransaction(const QString &hash, int status, bool showTransaction)
+{
+    QList<TransactionRecord> records;
+    if (status != CT_DELETED && showTransaction)
+    {
+        uint256 updated;
+        updated.SetHex(hash.toStdString());
+
+        LOCK2(cs_main, wallet->cs_wallet);
+        std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(updated);
+        if (mi != wallet->mapWallet.end())
+            records = DecomposeWithStatus(wallet, mi->second);
+    }
+    Q_EMIT transactionUpdated(hash, status, showTransaction, records);
+}
+
 // Private implementation
 class TransactionTablePriv
 {
 public:
     TransactionTablePriv(CWallet *_wallet, TransactionTableModel *_parent) :
         wallet(_wallet),
-        parent(_parent)
+        parent(_parent),
+        loader(0)
     {
     }
 
+    ~TransactionTablePriv()
+    {
+        loaderThread.quit();
+        loaderThread.wait();
+    }
+
     CWallet *wallet;
     TransactionTableModel *parent;
 
@@ -74,28 +169,81 @@ public:
      */
     QList<TransactionRecord> cachedWallet;
 
-    /* Query entire wallet anew from core.
+    QThread loaderThread;
+    TransactionTableLoader *loader;
+
+    /* Start filling the cache from the wallet in the loader thread, the records
+       come back page by page through addPage().
      */
-    void refreshWallet()
+    void startLoader()
     {
-        qDebug() << "TransactionTablePriv::refreshWallet";
-        cachedWallet.clear();
+        qDebug() << "TransactionTablePriv::startLoader";
+        loader = new TransactionTableLoader(wallet);
+        loader->moveToThread(&loaderThread);
+
+        QObject::connect(loader, SIGNAL(pageLoaded(QList<TransactionRecord>,bool)),
+                         parent, SLOT(addPage(QList<TransactionRecord>,bool)));
+        QObject::connect(loader, SIGNAL(transactionUpdated(QString,int,bool,QList<TransactionRecord>)),
+                         parent, SLOT(applyTransactionUpdate(QString,int,bool,QList<TransactionRecord>)));
+        // make sure the loader is deleted in its own thread
+        QObject::connect(&loaderThread, SIGNAL(finished()), loader, SLOT(deleteLater()), Qt::DirectConnection);
+
+        loaderThread.start();
+        QMetaObject::invokeMethod(loader, "loadPage", Qt::QueuedConnection);
+    }
+
+    /* Merge a page of records, sorted by hash, into the cache.
+
+       Transactions that made it into the model through a notification before
+       their page was loaded are skipped. Everything else goes in with one
+       beginInsertRows() per run of records between two cached transactions,
+       which is a single append while nothing else is coming in.
+     */
+    void addPage(const QList<TransactionRecord> &records)
+    {
+        int i = 0;
+        while (i < records.size())
         {
-            LOCK2(cs_main, wallet->cs_wallet);
-            for(std::map<uint256, CWalletTx>::iterator it = wallet->mapWallet.begin(); it != wallet->mapWallet.end(); ++it)
+            QList<TransactionRecord>::iterator lower = qLowerBound(
+                cachedWallet.begin(), cachedWallet.end(), records[i].hash, TxLessThan());
+            int insertIndex = (lower - cachedWallet.begin());
+
+            int end = i;
+            while (end < records.size() && (insertIndex == cachedWallet.size() || records[end].hash < cachedWallet[insertIndex].hash))
+                end++;
+            if (end == i)
             {
-                if(TransactionRecord::showTransaction(it->second))
-                    cachedWallet.append(TransactionRecord::decomposeTransaction(wallet, it->second));
+                // already in model, skip all records of this transaction
+                const uint256 hash = records[i].hash;
+                while (i < records.size() && records[i].hash == hash)
+                    i++;
+                continue;
             }
+
+            parent->beginInsertRows(QModelIndex(), insertIndex, insertIndex+(end-i)-1);
+            if (insertIndex == cachedWallet.size())
+            {
+                cachedWallet.reserve(cachedWallet.size()+(end-i));
+                for (int j = i; j < end; j++)
+                    cachedWallet.append(records[j]);
+            }
+            else
+            {
+                for (int j = i; j < end; j++)
+                    cachedWallet.insert(insertIndex++, records[j]);
+            }
+            parent->endInsertRows();
+            i = end;
         }
     }
 
     /* Update our model of the wallet incrementally, to synchronize our model of the wallet
        with that of the core.
 
-       Call with transaction that was added, removed or changed.
+       Call with transaction that was added, removed or changed, and its records as
+       decomposed by the loader.
      */
-    void updateWallet(const uint256 &hash, int status, bool showTransaction)
+    void updateWallet(const uint256 &hash, int status, bool showTransaction, const QList<TransactionRecord> &records)
     {
         qDebug() << "TransactionTablePriv::updateWallet: " + QString::fromStdString(hash.ToString()) + " " + QString::number(status);
 
@@ -130,22 +278,12 @@ public:
             }
             if(showTransaction)
             {
-                LOCK2(cs_main, wallet->cs_wallet);
-                // Find transaction in wallet
-                std::map<uint256, CWalletTx>::iterator mi = wallet->mapWallet.find(hash);
-                if(mi == wallet->mapWallet.end())
-                {
-                    qWarning() << "TransactionTablePriv::updateWallet: Warning: Got CT_NEW, but transaction is not in wallet";
-                    break;
-                }
                 // Added -- insert at the right position
-                QList<TransactionRecord> toInsert =
-                        TransactionRecord::decomposeTransaction(wallet, mi->second);
-                if(!toInsert.isEmpty()) /* only if something to insert */
+                if(!records.isEmpty()) /* only if something to insert */
                 {
-                    parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+toInsert.size()-1);
+                    parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+records.size()-1);
                     int insert_idx = lowerIndex;
-                    Q_FOREACH(const TransactionRecord &rec, toInsert)
+                    Q_FOREACH(const TransactionRecord &rec, records)
                     {
                         cachedWallet.insert(insert_idx, rec);
                         insert_idx += 1;
@@ -166,8 +304,31 @@ public:
             parent->endRemoveRows();
             break;
         case CT_UPDATED:
-            // Miscellaneous updates -- nothing to do, status update will take care of this, and is only computed for
-            // visible transactions.
+            if(!inModel)
+                break; /* Not in model and not shown, nothing to update */
+            // Changed -- replace the records in place when the transaction still decomposes into as
+            // many rows, so views only repaint them; otherwise swap the rows out
+            if(records.size() == upperIndex - lowerIndex)
+            {
+                for(int i = 0; i < records.size(); i++)
+                    cachedWallet[lowerIndex+i] = records[i];
+                Q_EMIT parent->dataChanged(parent->index(lowerIndex, 0), parent->index(upperIndex-1, parent->columns.length()-1));
+                break;
+            }
+            parent->beginRemoveRows(QModelIndex(), lowerIndex, upperIndex-1);
+            cachedWallet.erase(lower, upper);
+            parent->endRemoveRows();
+            if(!records.isEmpty())
+            {
+                parent->beginInsertRows(QModelIndex(), lowerIndex, lowerIndex+records.size()-1);
+                int insert_idx = lowerIndex;
+                Q_FOREACH(const TransactionRecord &rec, records)
+                {
+                    cachedWallet.insert(insert_idx, rec);
+                    insert_idx += 1;
+                }
+                parent->endInsertRows();
+            }
             break;
         }
     }
@@ -250,7 +411,10 @@ TransactionTableModel::TransactionTableModel(const PlatformStyle *_platformStyle
     color_tx_status_danger = GetColorStyleValue("guiconstants/color-tx-status-danger", COLOR_TX_STATUS_DANGER);
     color_black = GetColorStyleValue("guiconstants/color-black", COLOR_BLACK);
     columns << QString() << QString() << tr("Date") << tr("Type") << tr("Label") << BitcoinUnits::getAmountColumnTitle(walletModel->getOptionsModel()->getDisplayUnit());
-    priv->refreshWallet();
+
+    // Needed to pass records from the loader thread through queued connections
+    qRegisterMetaType< QList<TransactionRecord> >("QList<TransactionRecord>");
+    priv->startLoader();
 
     connect(walletModel->getOptionsModel(), SIGNAL(displayUnitChanged(int)), this, SLOT(updateDisplayUnit()));
 
@@ -271,11 +435,32 @@ void TransactionTableModel::updateAmountColumnTitle()
 }
 
 void TransactionTableModel::updateTransaction(const QString &hash, int status, bool showTransaction)
+{
+    // The loader decomposes the transaction and comes back with applyTransactionUpdate()
+    QMetaObject::invokeMethod(priv->loader, "updateTransaction", Qt::QueuedConnection,
+                              Q_ARG(QString, hash),
+                              Q_ARG(int, status),
+                              Q_ARG(bool, showTransaction));
+}
+
+void TransactionTableModel::applyTransactionUpdate(const QString &hash, int status, bool showTransaction, const QList<TransactionRecord> &records)
 {
     uint256 updated;
     updated.SetHex(hash.toStdString());
 
-    priv->updateWallet(updated, status, showTransaction);
+    priv->updateWallet(updated, status, showTransaction, records);
+}
+
+void TransactionTableModel::addPage(const QList<TransactionRecord> &records, bool finished)
+{
+    // Rows of the initial load are not new transactions, no balloons for them
+    bool fWasProcessingQueued = fProcessingQueuedTransactions;
+    fProcessingQueuedTransactions = true;
+    priv->addPage(records);
+    fProcessingQueuedTransactions = fWasProcessingQueued;
+
+    if (finished)
+        qDebug() << "TransactionTableModel::addPage: loaded " + QString::number(priv->size()) + " records";
 }
 
 void TransactionTableModel::updateConfirmations()
@@ -120,6 +120,12 @@ public Q_SLOTS:
     /* Needed to update fProcessingQueuedTransactions through a QueuedConnection */
     void setProcessingQueuedTransactions(bool value) { fProcessingQueuedTransactions = value; }
 
+private Q_SLOTS:
+    /* Records of the initial load, a page at a time, from the loader thread */
+    void addPage(const QList<TransactionRecord> &records, bool finished);
+    /* Transaction added, removed or changed, decomposed by the loader thread */
+    void applyTransactionUpdate(const QString &hash, int status, bool showTransaction, const QList<TransactionRecord> &records);
+
     friend class TransactionTablePriv;
 };
 
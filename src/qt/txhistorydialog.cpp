@@ -35,8 +35,10 @@
 #include <boost/lexical_cast.hpp>
 
 #include <stdint.h>
+#include <algorithm>
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -387,6 +389,10 @@ void TXHistoryDialog::UpdateConfirmations()
         }
         int txBlockHeight = ui->txHistoryTable->item(row,1)->text().toInt();
         if (txBlockHeight>0) confirmations = (chainHeight+1) - txBlockHeight;
+        // only touch the cell when the icon changes, most rows stay confirmed from one block to the next
+        int iconKey = valid ? std::min(confirmations, 6) : -1;
+        QTableWidgetItem *currentCell = ui->txHistoryTable->item(row, 2);
+        if (currentCell && currentCell->data(Qt::UserRole).isValid() && currentCell->data(Qt::UserRole).toInt() == iconKey) continue;
         // setup the appropriate icon
         QIcon ic = QIcon(":/icons/transaction_0");
         switch(confirmations) {
@@ -401,6 +407,7 @@ void TXHistoryDialog::UpdateConfirmations()
         QTableWidgetItem *iconCell = new QTableWidgetItem;
 //        ic = platformStyle->SingleColorIcon(ic);
         iconCell->setIcon(ic);
+        iconCell->setData(Qt::UserRole, iconKey);
         ui->txHistoryTable->setItem(row, 2, iconCell);
     }
 }
@@ -416,16 +423,17 @@ void TXHistoryDialog::UpdateHistory()
     // were any transactions added?
     if(newTXCount > 0) { // there are new transactions (or a pending shifted to confirmed), refresh the table adding any that are in the map but not in the table
         ui->txHistoryTable->setSortingEnabled(false); // disable sorting temporarily while we update the table (leaving enabled gives unexpected results)
-        QAbstractItemModel* historyAbstractModel = ui->txHistoryTable->model(); // get a model to work with
+        ui->txHistoryTable->setUpdatesEnabled(false); // and repaint once when all new rows are in
+        // collect the transactions already in the table in one pass, rather than searching the table for every transaction in the map
+        std::set<uint256> tableTransactions;
+        for (int row = 0; row < ui->txHistoryTable->rowCount(); row++) {
+            uint256 tableTxid;
+            tableTxid.SetHex(ui->txHistoryTable->item(row,0)->text().toStdString());
+            tableTransactions.insert(tableTxid);
+        }
         for(HistoryMap::iterator it = txHistoryMap.begin(); it != txHistoryMap.end(); ++it) {
             uint256 txid = it->first; // grab txid
-            // search the history table for this transaction, here we're going to use a filter proxy because it's a little quicker
-            QSortFilterProxyModel historyProxy;
-            historyProxy.setSourceModel(historyAbstractModel);
-            historyProxy.setFilterKeyColumn(0);
-            historyProxy.setFilterFixedString(QString::fromStdString(txid.GetHex()));
-            QModelIndex rowIndex = historyProxy.mapToSource(historyProxy.index(0,0));
-            if(!rowIndex.isValid()) { // this transaction doesn't exist in the history table, add it
+            if(!tableTransactions.count(txid)) { // this transaction doesn't exist in the history table, add it
                 HistoryTXObject htxo = it->second; // grab the tranaaction
                 int workingRow = ui->txHistoryTable->rowCount();
                 ui->txHistoryTable->insertRow(workingRow); // append a new row (sorting will take care of ordering)
@@ -465,6 +473,7 @@ void TXHistoryDialog::UpdateHistory()
             }
         }
         ui->txHistoryTable->setSortingEnabled(true); // re-enable sorting
+        ui->txHistoryTable->setUpdatesEnabled(true);
     }
     UpdateConfirmations();
 }
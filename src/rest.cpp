@@ -12,7 +12,9 @@
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
+#include "txdb.h"
 #include "txmempool.h"
+#include "undo.h"
 #include "utilstrencodings.h"
 #include "version.h"
 
@@ -21,6 +23,7 @@
 #include <univalue.h>
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static const long MAX_REST_BLOCKS_COUNT = 500; //allow a max of 500 blocks to be streamed at once
 
 enum RetFormat {
     RF_UNDEF,
@@ -273,6 +276,131 @@ static bool rest_block_notxdetails(HTTPRequest* req, const std::string& strURIPa
     return rest_block(req, strURIPart, false);
 }
 
+/**
+ * The address and spent index entries the block adds, as ConnectBlock() computes
+ * them. The coins the block spends come from its undo data, so this works whether
+ * the indices are enabled or not.
+ */
+static bool GetBlockIndexDeltas(const std::vector<unsigned char>& rawBlock, const std::vector<unsigned char>& rawUndo, int nHeight, CDbIndexHelper& dbIndexHelper)
+{
+    CBlock block;
+    CBlockUndo blockUndo;
+    try {
+        CDataStream ssBlock(rawBlock, SER_DISK, CLIENT_VERSION);
+        ssBlock >> block;
+        if (!rawUndo.empty()) {
+            CDataStream ssUndo(rawUndo, SER_DISK, CLIENT_VERSION);
+            ssUndo >> blockUndo;
+        }
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error at height %d - %s", __func__, nHeight, e.what());
+    }
+
+    CCoinsView viewDummy;
+    CCoinsViewCache view(&viewDummy);
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        // coinbase has no undo entry, spends of zerocoin and sigma mints have no prevouts
+        if (i > 0 && i - 1 < blockUndo.vtxundo.size()) {
+            CTxUndo& txundo = blockUndo.vtxundo[i - 1];
+            if (txundo.vprevout.size() == tx.vin.size()) {
+                for (size_t j = 0; j < tx.vin.size(); j++)
+                    view.AddCoin(tx.vin[j].prevout, std::move(txundo.vprevout[j]), true);
+            }
+        }
+        dbIndexHelper.ConnectTransaction(tx, nHeight, i, view);
+    }
+    return true;
+}
+
+/**
+ * Stream a range of blocks of the active chain for replaying it elsewhere.
+ * Every block is a record of
+ *   int32                                       height
+ *   uint256                                     block hash
+ *   vector<unsigned char>                       the block as stored on disk
+ *   vector<unsigned char>                       its undo data as stored on disk, empty for the genesis block
+ * copied from the block files without deserializing them. With
+ * /rest/blocks/<start>/<count>/deltas.bin the records go on with
+ *   vector<pair<CAddressIndexKey, CAmount>>     the address index entries of the block
+ *   vector<pair<CSpentIndexKey, CSpentIndexValue>> the spent index entries of the block
+ * which takes decoding every block and its undo data.
+ * Every record is sent as one chunk of a chunked reply as soon as it is read,
+ * the next block being read once the client has received it. If a block cannot
+ * be read after the first one went out, the connection is closed without
+ * ending the reply.
+ */
+static bool rest_blocks(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2 && !(path.size() == 3 && path[2] == "deltas"))
+        return RESTERR(req, HTTP_BAD_REQUEST, "No block count specified. Use /rest/blocks/<start>/<count>.bin or /rest/blocks/<start>/<count>/deltas.bin.");
+    const bool fDeltas = path.size() == 3;
+    if (rf != RF_BINARY)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin)");
+
+    int32_t nStart;
+    if (!ParseInt32(path[0], &nStart) || nStart < 0)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid start height: " + path[0]);
+    long count = strtol(path[1].c_str(), NULL, 10);
+    if (count < 1 || count > MAX_REST_BLOCKS_COUNT)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Block count out of range: " + path[1]);
+
+    std::vector<const CBlockIndex *> blocks;
+    blocks.reserve(count);
+    {
+        LOCK(cs_main);
+        if (nStart > chainActive.Height())
+            return RESTERR(req, HTTP_NOT_FOUND, "Start height out of range: " + path[0]);
+        for (const CBlockIndex* pindex = chainActive[nStart]; pindex != NULL && blocks.size() < (unsigned long)count; pindex = chainActive.Next(pindex)) {
+            if (!(pindex->nStatus & BLOCK_HAVE_DATA) || (pindex->pprev && !(pindex->nStatus & BLOCK_HAVE_UNDO)))
+                return RESTERR(req, HTTP_NOT_FOUND, strprintf("Block at height %d not available (pruned data)", pindex->nHeight));
+            blocks.push_back(pindex);
+        }
+    }
+
+    bool fStarted = false;
+    for (const CBlockIndex* pindex : blocks) {
+        std::vector<unsigned char> rawBlock, rawUndo;
+        bool fRead;
+        {
+            // the lock keeps the files from being pruned while we read
+            LOCK(cs_main);
+            fRead = ReadRawBlockFromDisk(rawBlock, pindex->GetBlockPos(), Params().MessageStart()) &&
+                (!pindex->pprev || ReadRawUndoFromDisk(rawUndo, pindex->GetUndoPos(), pindex->pprev->GetBlockHash(), Params().MessageStart()));
+        }
+
+        CDbIndexHelper dbIndexHelper(true, true);
+        if (!fRead || (fDeltas && !GetBlockIndexDeltas(rawBlock, rawUndo, pindex->nHeight, dbIndexHelper))) {
+            if (!fStarted)
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, strprintf("Failed to read block at height %d", pindex->nHeight));
+            LogPrintf("%s: Failed to read block at height %d, reply cut short\n", __func__, pindex->nHeight);
+            return false;
+        }
+
+        CDataStream ssRecord(SER_NETWORK, PROTOCOL_VERSION);
+        ssRecord << (int32_t)pindex->nHeight << pindex->GetBlockHash() << rawBlock << rawUndo;
+        if (fDeltas)
+            ssRecord << dbIndexHelper.getAddressIndex() << dbIndexHelper.getSpentIndex();
+
+        if (!fStarted) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReplyStart(HTTP_OK);
+            fStarted = true;
+        }
+        if (!req->WriteReplyChunk(ssRecord.data(), ssRecord.size()))
+            return false; // the client went away
+    }
+    req->WriteReplyEnd();
+    return true;
+}
+
 // A bit of a hack - dependency on a function defined in rpc/blockchain.cpp
 UniValue getblockchaininfo(const JSONRPCRequest& request);
 
@@ -602,6 +730,7 @@ static const struct {
       {"/rest/mempool/info", rest_mempool_info},
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
+      {"/rest/blocks/", rest_blocks},
       {"/rest/getutxos", rest_getutxos},
 };
 
@@ -9,14 +9,18 @@
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "coins.h"
+#include "coinstats.h"
 #include "core_io.h"
+#include "dbwrapper.h"
 #include "consensus/validation.h"
 #include "validation.h"
 #include "policy/policy.h"
 #include "primitives/transaction.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
+#include "txdb.h"
 #include "txmempool.h"
 #include "util.h"
 #include "utilstrencodings.h"
@@ -169,9 +173,9 @@ UniValue getextrablockdata(const CBlock& block,const CBlockIndex* blockindex){
     return blockdata;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false)
+/** The members of the verbose block object that come before "tx" */
+static void blockHeadToJSON(const CBlock& block, const CBlockIndex* blockindex, UniValue& result)
 {
-    UniValue result(UniValue::VOBJ);
     result.push_back(Pair("hash", blockindex->GetBlockHash().GetHex()));
     int confirmations = -1;
     // Only report confirmations if the block is on the main chain
@@ -185,19 +189,11 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     result.push_back(Pair("version", block.nVersion));
     result.push_back(Pair("versionHex", strprintf("%08x", block.nVersion)));
     result.push_back(Pair("merkleroot", block.hashMerkleRoot.GetHex()));
-    UniValue txs(UniValue::VARR);
-    for(const auto& tx : block.vtx)
-    {
-        if(txDetails)
-        {
-            UniValue objTx(UniValue::VOBJ);
-            TxToJSON(*tx, uint256(), objTx);
-            txs.push_back(objTx);
-        }
-        else
-            txs.push_back(tx->GetHash().GetHex());
-    }
-    result.push_back(Pair("tx", txs));
+}
+
+/** The members of the verbose block object that come after "tx" */
+static void blockTailToJSON(const CBlock& block, const CBlockIndex* blockindex, UniValue& result)
+{
     if (!block.vtx[0]->vExtraPayload.empty()) {
         CbtxToJson(*block.vtx[0], result);
     }
@@ -215,9 +211,54 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     CBlockIndex *pnext = chainActive.Next(blockindex);
     if (pnext)
         result.push_back(Pair("nextblockhash", pnext->GetBlockHash().GetHex()));
+}
+
+static UniValue txToBlockJSON(const CTransaction& tx, bool txDetails)
+{
+    if (!txDetails)
+        return tx.GetHash().GetHex();
+    UniValue objTx(UniValue::VOBJ);
+    TxToJSON(tx, uint256(), objTx);
+    return objTx;
+}
+
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails = false)
+{
+    UniValue result(UniValue::VOBJ);
+    blockHeadToJSON(block, blockindex, result);
+    UniValue txs(UniValue::VARR);
+    for(const auto& tx : block.vtx)
+        txs.push_back(txToBlockJSON(*tx, txDetails));
+    result.push_back(Pair("tx", txs));
+    blockTailToJSON(block, blockindex, result);
     return result;
 }
 
+/**
+ * Same as above, but only one transaction at a time is held as a UniValue. As the
+ * writer may wait for the client, cs_main is only held for the members about the chain.
+ */
+void blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool txDetails, CJSONStreamWriter& writer)
+{
+    UniValue head(UniValue::VOBJ);
+    UniValue tail(UniValue::VOBJ);
+    {
+        LOCK(cs_main);
+        blockHeadToJSON(block, blockindex, head);
+        blockTailToJSON(block, blockindex, tail);
+    }
+
+    writer.BeginObject();
+    writer.Members(head);
+    writer.Key("tx");
+    writer.BeginArray();
+    for(const auto& tx : block.vtx)
+        writer.Value(txToBlockJSON(*tx, txDetails));
+    writer.EndArray();
+    writer.Members(tail);
+    writer.EndObject();
+}
+
 static UniValue getestimatedannualroi(const JSONRPCRequest& request)
 {
     LOCK(cs_main);
@@ -524,6 +565,51 @@ UniValue getrawmempool(const JSONRPCRequest& request)
     return mempoolToJSON(fVerbose);
 }
 
+bool getrawmempoolStream(const JSONRPCRequest& request, CJSONStreamWriter& writer)
+{
+    if (request.fHelp || request.params.size() > 1)
+        return false;
+
+    bool fVerbose = false;
+    if (request.params.size() > 0)
+        fVerbose = request.params[0].get_bool();
+
+    if (fVerbose)
+    {
+        // The entries are taken under one lock, so that they are a snapshot of the mempool
+        // as getrawmempool returns it, and written without it as the writer may wait for the client
+        vector<pair<uint256, UniValue>> vEntries;
+        {
+            LOCK(mempool.cs);
+            vEntries.reserve(mempool.mapTx.size());
+            BOOST_FOREACH(const CTxMemPoolEntry& e, mempool.mapTx)
+            {
+                vEntries.emplace_back(e.GetTx().GetHash(), UniValue(UniValue::VOBJ));
+                entryToJSON(vEntries.back().second, e);
+            }
+        }
+
+        writer.BeginObject();
+        BOOST_FOREACH(const PAIRTYPE(uint256, UniValue)& entry, vEntries)
+        {
+            writer.Key(entry.first.ToString());
+            writer.Value(entry.second);
+        }
+        writer.EndObject();
+    }
+    else
+    {
+        vector<uint256> vtxid;
+        mempool.queryHashes(vtxid);
+
+        writer.BeginArray();
+        BOOST_FOREACH(const uint256& hash, vtxid)
+            writer.Value(hash.ToString());
+        writer.EndArray();
+    }
+    return true;
+}
+
 UniValue clearmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 0)
@@ -832,6 +918,31 @@ UniValue getblockheader(const JSONRPCRequest& request)
     return blockheaderToJSON(pblockindex);
 }
 
+/** Look up a block by hash and read it from disk, throwing the errors getblock reports */
+static CBlockIndex* ReadBlockForRPC(const std::string& strHash, CBlock& block)
+{
+    AssertLockHeld(cs_main);
+
+    uint256 hash(uint256S(strHash));
+    if (mapBlockIndex.count(hash) == 0)
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+
+    CBlockIndex* pblockindex = mapBlockIndex[hash];
+
+    if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+
+    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+        // Block not found on disk. This could be because we have the block
+        // header in our index but don't have the block (for example if a
+        // non-whitelisted node sends us an unrequested long chain of valid
+        // blocks, we add the headers to our index, but don't accept the
+        // block).
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+
+    return pblockindex;
+}
+
 UniValue getblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
@@ -880,29 +991,12 @@ UniValue getblock(const JSONRPCRequest& request)
 
     LOCK(cs_main);
 
-    std::string strHash = request.params[0].get_str();
-    uint256 hash(uint256S(strHash));
-
     bool fVerbose = true;
     if (request.params.size() > 1)
         fVerbose = request.params[1].get_bool();
 
-    if (mapBlockIndex.count(hash) == 0)
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
-
     CBlock block;
-    CBlockIndex* pblockindex = mapBlockIndex[hash];
-
-    if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
-        throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
-
-    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
-        // Block not found on disk. This could be because we have the block
-        // header in our index but don't have the block (for example if a
-        // non-whitelisted node sends us an unrequested long chain of valid
-        // blocks, we add the headers to our index, but don't accept the
-        // block).
-        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    CBlockIndex* pblockindex = ReadBlockForRPC(request.params[0].get_str(), block);
 
     if (!fVerbose)
     {
@@ -915,6 +1009,25 @@ UniValue getblock(const JSONRPCRequest& request)
     return blockToJSON(block, pblockindex);
 }
 
+bool getblockStream(const JSONRPCRequest& request, CJSONStreamWriter& writer)
+{
+    // Help and the hex encoded form are left to getblock
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+        return false;
+    if (request.params.size() > 1 && !request.params[1].get_bool())
+        return false;
+
+    CBlock block;
+    CBlockIndex* pblockindex;
+    {
+        LOCK(cs_main);
+        pblockindex = ReadBlockForRPC(request.params[0].get_str(), block);
+    }
+
+    blockToJSON(block, pblockindex, false, writer);
+    return true;
+}
+
 struct CCoinsStats
 {
     int nHeight;
@@ -1033,28 +1146,66 @@ UniValue pruneblockchain(const JSONRPCRequest& request)
 
 UniValue gettxoutsetinfo(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 0)
+    if (request.fHelp || request.params.size() > 2)
         throw runtime_error(
-            "gettxoutsetinfo\n"
+            "gettxoutsetinfo ( \"hash_type\" height )\n"
             "\nReturns statistics about the unspent transaction output set.\n"
-            "Note this call may take some time.\n"
+            "Note this call may take some time, unless hash_type is muhash.\n"
+            "\nArguments:\n"
+            "1. \"hash_type\"  (string, optional, default=hash_serialized_2) Which UTXO set hash should be calculated.\n"
+            "                   hash_serialized_2 scans the whole chainstate, muhash uses the statistics kept\n"
+            "                   up to date as blocks are connected and needs -utxostats\n"
+            "2. height       (numeric, optional, default=tip) The block height of the statistics, only with muhash\n"
             "\nResult:\n"
             "{\n"
             "  \"height\":n,     (numeric) The current block height (index)\n"
             "  \"bestblock\": \"hex\",   (string) the best block hash hex\n"
-            "  \"transactions\": n,      (numeric) The number of transactions\n"
+            "  \"transactions\": n,      (numeric) The number of transactions, not with muhash\n"
             "  \"txouts\": n,            (numeric) The number of output transactions\n"
-            "  \"hash_serialized\": \"hash\",   (string) The serialized hash\n"
+            "  \"hash_serialized_2\": \"hash\",   (string) The serialized hash, only with hash_serialized_2\n"
+            "  \"muhash\": \"hash\",     (string) The order independent hash of the set, only with muhash\n"
             "  \"disk_size\": n,         (numeric) The estimated size of the chainstate on disk\n"
             "  \"total_amount\": x.xxx          (numeric) The total amount\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("gettxoutsetinfo", "")
+            + HelpExampleCli("gettxoutsetinfo", "muhash 1000")
             + HelpExampleRpc("gettxoutsetinfo", "")
         );
 
+    std::string strHashType = "hash_serialized_2";
+    if (request.params.size() > 0 && !request.params[0].isNull())
+        strHashType = request.params[0].get_str();
+
     UniValue ret(UniValue::VOBJ);
 
+    if (strHashType == "muhash") {
+        int nHeight = -1;
+        if (request.params.size() > 1 && !request.params[1].isNull())
+            nHeight = request.params[1].get_int();
+
+        if (!fUTXOStats)
+            throw JSONRPCError(RPC_MISC_ERROR, "UTXO stats are not maintained, restart with -utxostats -reindex-chainstate");
+
+        LOCK(cs_main);
+        CUTXOStats stats;
+        if (!GetUTXOStatsAtHeight(nHeight, stats))
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to get UTXO stats for this height");
+
+        ret.push_back(Pair("height", (int64_t)mapBlockIndex.find(stats.hashBlock)->second->nHeight));
+        ret.push_back(Pair("bestblock", stats.hashBlock.GetHex()));
+        ret.push_back(Pair("txouts", (int64_t)stats.nTransactionOutputs));
+        ret.push_back(Pair("muhash", stats.muhash.Finalize().GetHex()));
+        ret.push_back(Pair("disk_size", pcoinsTip->EstimateSize()));
+        ret.push_back(Pair("total_amount", ValueFromAmount(stats.nTotalAmount)));
+        return ret;
+    }
+
+    if (strHashType != "hash_serialized_2")
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown hash_type " + strHashType);
+    if (request.params.size() > 1 && !request.params[1].isNull())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "height is only supported with hash_type muhash");
+
     CCoinsStats stats;
     FlushStateToDisk();
     if (GetUTXOStats(pcoinsTip, stats)) {
@@ -1071,6 +1222,140 @@ UniValue gettxoutsetinfo(const JSONRPCRequest& request)
     return ret;
 }
 
+UniValue getdbstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw runtime_error(
+            "getdbstats\n"
+            "\nReturns LevelDB statistics for every open database.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"profile\": \"name\",          (string) the tuning profile (chainstate, blockindex, evodb, llmq, elysium, default)\n"
+            "    \"path\": \"dir\",              (string) the database directory\n"
+            "    \"compression\": true|false,  (boolean) whether new tables are compressed with Snappy\n"
+            "    \"memory_usage\": n,          (numeric) approximate memory used by the block cache and write buffers\n"
+            "    \"block_cache\": {            (object) not reported for the elysium databases\n"
+            "      \"size\": n,                (numeric) capacity of the block cache in bytes\n"
+            "      \"usage\": n,               (numeric) bytes currently cached\n"
+            "      \"hits\": n,                (numeric) lookups served from the cache\n"
+            "      \"misses\": n               (numeric) lookups that had to read from disk\n"
+            "    },\n"
+            "    \"writes\": {                 (object) not reported for the elysium databases\n"
+            "      \"batches\": n,             (numeric) write batches since the database was opened\n"
+            "      \"sync\": n,                (numeric) of which were synced to disk\n"
+            "      \"total_ms\": n,            (numeric) time spent writing\n"
+            "      \"max_ms\": n,              (numeric) the slowest write\n"
+            "      \"slow\": n                 (numeric) writes taking 100ms or more, usually stalled on compaction\n"
+            "    },\n"
+            "    \"levels\": [                 (array) compaction statistics of the non-empty levels\n"
+            "      {\n"
+            "        \"level\": n,\n"
+            "        \"files\": n,             (numeric) table files in the level\n"
+            "        \"size_mb\": n,           (numeric) size of the level\n"
+            "        \"compaction_sec\": n,    (numeric) time spent compacting into the level\n"
+            "        \"read_mb\": n,           (numeric) data read by those compactions\n"
+            "        \"write_mb\": n           (numeric) data written by those compactions\n"
+            "      }, ...\n"
+            "    ]\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+        );
+
+    UniValue ret(UniValue::VARR);
+    for (const CDBStats& stats : GetAllDBStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("profile", stats.strProfile));
+        obj.push_back(Pair("path", stats.strPath));
+        obj.push_back(Pair("compression", stats.fCompression));
+        obj.push_back(Pair("memory_usage", stats.nMemoryUsage));
+
+        if (stats.fCounters) {
+            UniValue cache(UniValue::VOBJ);
+            cache.push_back(Pair("size", (uint64_t)stats.nBlockCacheSize));
+            cache.push_back(Pair("usage", (uint64_t)stats.nBlockCacheUsage));
+            cache.push_back(Pair("hits", stats.nBlockCacheHits));
+            cache.push_back(Pair("misses", stats.nBlockCacheMisses));
+            obj.push_back(Pair("block_cache", cache));
+
+            UniValue writes(UniValue::VOBJ);
+            writes.push_back(Pair("batches", stats.nWriteBatches));
+            writes.push_back(Pair("sync", stats.nSyncWrites));
+            writes.push_back(Pair("total_ms", stats.nWriteMicros / 1000.0));
+            writes.push_back(Pair("max_ms", stats.nMaxWriteMicros / 1000.0));
+            writes.push_back(Pair("slow", stats.nSlowWrites));
+            obj.push_back(Pair("writes", writes));
+        }
+
+        UniValue levels(UniValue::VARR);
+        for (const CDBStats::Level& level : stats.vLevels) {
+            UniValue entry(UniValue::VOBJ);
+            entry.push_back(Pair("level", level.nLevel));
+            entry.push_back(Pair("files", level.nFiles));
+            entry.push_back(Pair("size_mb", level.dSizeMB));
+            entry.push_back(Pair("compaction_sec", level.dCompactionSeconds));
+            entry.push_back(Pair("read_mb", level.dCompactionReadMB));
+            entry.push_back(Pair("write_mb", level.dCompactionWriteMB));
+            levels.push_back(entry);
+        }
+        obj.push_back(Pair("levels", levels));
+        ret.push_back(obj);
+    }
+    return ret;
+}
+
+UniValue getflushinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw runtime_error(
+            "getflushinfo\n"
+            "\nReturns statistics about writing the coins cache to disk.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"async\": true|false,     (boolean) whether flushes are written in the background (-asyncflush)\n"
+            "  \"writing\": true|false,   (boolean) whether a write is running now\n"
+            "  \"flushes\": n,            (numeric) flushes since startup\n"
+            "  \"async_flushes\": n,      (numeric) of which were written in the background\n"
+            "  \"last_coins\": n,         (numeric) coins written by the most recent flush\n"
+            "  \"last_ms\": n,            (numeric) duration of the most recent write\n"
+            "  \"total_ms\": n,           (numeric) time spent writing\n"
+            "  \"max_ms\": n,             (numeric) the slowest write\n"
+            "  \"stalls\": n,             (numeric) flushes that had to wait for the previous write\n"
+            "  \"stall_ms\": n,           (numeric) time block processing waited for writes\n"
+            "  \"max_stall_ms\": n        (numeric) the longest wait\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getflushinfo", "")
+            + HelpExampleRpc("getflushinfo", "")
+        );
+
+    CCoinsFlushStats stats;
+    bool fAsync;
+    {
+        LOCK(cs_main);
+        fAsync = pcoinsFlushBuffer != NULL;
+        if (fAsync)
+            stats = pcoinsFlushBuffer->GetStats();
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("async", fAsync));
+    ret.push_back(Pair("writing", stats.fWriting));
+    ret.push_back(Pair("flushes", stats.nFlushes));
+    ret.push_back(Pair("async_flushes", stats.nAsyncFlushes));
+    ret.push_back(Pair("last_coins", stats.nLastCoins));
+    ret.push_back(Pair("last_ms", stats.nLastWriteMicros / 1000.0));
+    ret.push_back(Pair("total_ms", stats.nTotalWriteMicros / 1000.0));
+    ret.push_back(Pair("max_ms", stats.nMaxWriteMicros / 1000.0));
+    ret.push_back(Pair("stalls", stats.nStalls));
+    ret.push_back(Pair("stall_ms", stats.nTotalStallMicros / 1000.0));
+    ret.push_back(Pair("max_stall_ms", stats.nMaxStallMicros / 1000.0));
+    return ret;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -1254,6 +1539,7 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
             "  \"lastposblock\": xxxxxx,   (numeric) The last PoS Block in Block index\n"
             "  \"lastposdiff\": xxxxxx,    (numeric) The last PoS Block difficulty in Block index\n"
             "  \"headers\": xxxxxx,        (numeric) the current number of headers we have validated\n"
+            "  \"headerspersecond\": xxxx, (numeric) headers validated per second in the last batch of headers received\n"
             "  \"bestblockhash\": \"...\", (string) the hash of the currently best block\n"
             "  \"difficulty\": xxxxxx,     (numeric) the current difficulty\n"
             "  \"mediantime\": xxxxxx,     (numeric) median time for the current best block\n"
@@ -1295,6 +1581,7 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
     obj.push_back(Pair("lastposblock",          GetLastBlockIndex(chainActive.Tip(), true)->nHeight));
     obj.push_back(Pair("lastposdiff",           GetDifficulty(GetLastBlockIndex(chainActive.Tip(), true))));
     obj.push_back(Pair("headers",               pindexBestHeader ? pindexBestHeader->nHeight : -1));
+    obj.push_back(Pair("headerspersecond",      GetHeadersPerSecond()));
     obj.push_back(Pair("bestblockhash",         chainActive.Tip()->GetBlockHash().GetHex()));
     obj.push_back(Pair("difficulty",            (double)GetDifficulty()));
     obj.push_back(Pair("mediantime",            (int64_t)chainActive.Tip()->GetMedianTimePast()));
@@ -1699,26 +1986,28 @@ UniValue getspecialtxes(const JSONRPCRequest& request)
 }
 
 static const CRPCCommand commands[] =
-{ //  category              name                      actor (function)         okSafe argNames
-  //  --------------------- ------------------------  -----------------------  ------ ----------
-    { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      true,  {} },
-    { "blockchain",         "getbestblockhash",       &getbestblockhash,       true,  {} },
-    { "blockchain",         "getblockcount",          &getblockcount,          true,  {} },
-    { "blockchain",         "getblock",               &getblock,               true,  {"blockhash","verbose"} },
-    { "blockchain",         "getblockhash",           &getblockhash,           true,  {"height"} },
-    { "blockchain",         "getblockhashes",         &getblockhashes,         true,  {"high", "low"} },
-    { "blockchain",         "getblockheader",         &getblockheader,         true,  {"blockhash","verbose"} },
-    { "blockchain",         "getchaintips",           &getchaintips,           true,  {} },
-    { "blockchain",         "getdifficulty",          &getdifficulty,          true,  {} },
-    { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    true,  {"txid","verbose"} },
-    { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  true,  {"txid","verbose"} },
-    { "blockchain",         "getmempoolentry",        &getmempoolentry,        true,  {"txid"} },
-    { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {} },
-    { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"} },
+{ //  category              name                      actor (function)         okSafe argNames, concurrent, streamActor
+  //  --------------------- ------------------------  -----------------------  ------ --------------------
+    { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      true,  {}, true },
+    { "blockchain",         "getbestblockhash",       &getbestblockhash,       true,  {}, true },
+    { "blockchain",         "getblockcount",          &getblockcount,          true,  {}, true },
+    { "blockchain",         "getblock",               &getblock,               true,  {"blockhash","verbose"}, true, &getblockStream },
+    { "blockchain",         "getblockhash",           &getblockhash,           true,  {"height"}, true },
+    { "blockchain",         "getblockhashes",         &getblockhashes,         true,  {"high", "low"}, true },
+    { "blockchain",         "getblockheader",         &getblockheader,         true,  {"blockhash","verbose"}, true },
+    { "blockchain",         "getchaintips",           &getchaintips,           true,  {}, true },
+    { "blockchain",         "getdifficulty",          &getdifficulty,          true,  {}, true },
+    { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    true,  {"txid","verbose"}, true },
+    { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  true,  {"txid","verbose"}, true },
+    { "blockchain",         "getmempoolentry",        &getmempoolentry,        true,  {"txid"}, true },
+    { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {}, true },
+    { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"}, true, &getrawmempoolStream },
     { "blockchain",         "clearmempool",           &clearmempool,           true,  {} },
-    { "blockchain",         "getspecialtxes",         &getspecialtxes,         true,  {"blockhash", "type", "count", "skip", "verbosity"} },
-    { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"} },
-    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {} },
+    { "blockchain",         "getspecialtxes",         &getspecialtxes,         true,  {"blockhash", "type", "count", "skip", "verbosity"}, true },
+    { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"}, true },
+    { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {"hash_type","height"} },
+    { "blockchain",         "getdbstats",             &getdbstats,             true,  {}, true },
+    { "blockchain",         "getflushinfo",           &getflushinfo,           true,  {}, true },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        true,  {"height"} },
     { "blockchain",         "verifychain",            &verifychain,            true,  {"checklevel","nblocks"} },
 
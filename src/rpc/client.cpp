@@ -92,6 +92,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "listunspentsigmamints", 1 },
     { "listunspentsigmamints", 2 },
     { "getblock", 1, "verbose" },
+    { "gettxoutsetinfo", 1, "height" },
     { "getblockheader", 1, "verbose" },
     { "gettransaction", 1, "include_watchonly" },
     { "getrawtransaction", 1, "verbose" },
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/jsonstream.h"
+
+#include <assert.h>
+
+CJSONStreamWriter::CJSONStreamWriter(Sink sinkIn, size_t nChunkSizeIn)
+    : sink(sinkIn), nChunkSize(nChunkSizeIn), fAfterKey(false)
+{
+    buffer.reserve(nChunkSize);
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+    Flush();
+}
+
+void CJSONStreamWriter::BeginValue()
+{
+    if (fAfterKey) {
+        fAfterKey = false;
+        return;
+    }
+    if (!vHasElements.empty()) {
+        if (vHasElements.back())
+            Write(",");
+        vHasElements.back() = true;
+    }
+}
+
+void CJSONStreamWriter::BeginObject()
+{
+    BeginValue();
+    Write("{");
+    vHasElements.push_back(false);
+}
+
+void CJSONStreamWriter::EndObject()
+{
+    assert(!vHasElements.empty() && !fAfterKey);
+    vHasElements.pop_back();
+    Write("}");
+}
+
+void CJSONStreamWriter::BeginArray()
+{
+    BeginValue();
+    Write("[");
+    vHasElements.push_back(false);
+}
+
+void CJSONStreamWriter::EndArray()
+{
+    assert(!vHasElements.empty() && !fAfterKey);
+    vHasElements.pop_back();
+    Write("]");
+}
+
+void CJSONStreamWriter::Key(const std::string& key)
+{
+    assert(!vHasElements.empty() && !fAfterKey);
+    BeginValue();
+    // a string value is escaped and quoted exactly like an object key
+    Write(UniValue(key).write());
+    Write(":");
+    fAfterKey = true;
+}
+
+void CJSONStreamWriter::Value(const UniValue& value)
+{
+    BeginValue();
+    Write(value.write());
+}
+
+void CJSONStreamWriter::Members(const UniValue& obj)
+{
+    assert(obj.isObject());
+    const std::vector<std::string>& keys = obj.getKeys();
+    const std::vector<UniValue>& values = obj.getValues();
+    for (size_t i = 0; i < keys.size(); i++) {
+        Key(keys[i]);
+        Value(values[i]);
+    }
+}
+
+void CJSONStreamWriter::Raw(const std::string& str)
+{
+    Write(str);
+}
+
+void CJSONStreamWriter::Write(const std::string& str)
+{
+    buffer += str;
+    if (buffer.size() >= nChunkSize)
+        Flush();
+}
+
+void CJSONStreamWriter::Flush()
+{
+    if (buffer.empty())
+        return;
+    sink(buffer.data(), buffer.size());
+    buffer.clear();
+}
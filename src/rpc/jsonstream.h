@@ -0,0 +1,63 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_JSONSTREAM_H
+#define BITCOIN_RPC_JSONSTREAM_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <univalue.h>
+
+/**
+ * Writes a JSON document piece by piece, producing exactly the text
+ * UniValue::write() would produce for the equivalent tree. Output is buffered
+ * and handed to the sink whenever a chunk fills up, so large RPC results can
+ * be emitted without ever holding the whole tree or string in memory.
+ */
+class CJSONStreamWriter
+{
+public:
+    typedef std::function<void(const char* data, size_t size)> Sink;
+
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    explicit CJSONStreamWriter(Sink sinkIn, size_t nChunkSizeIn = DEFAULT_CHUNK_SIZE);
+    ~CJSONStreamWriter();
+
+    CJSONStreamWriter(const CJSONStreamWriter&) = delete;
+    CJSONStreamWriter& operator=(const CJSONStreamWriter&) = delete;
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Start an object member, its value has to follow */
+    void Key(const std::string& key);
+    /** Write a complete value, either as an array element or as the value of the last Key */
+    void Value(const UniValue& value);
+    /** Write all members of an object into the object currently open */
+    void Members(const UniValue& obj);
+    /** Append text outside of the JSON document, e.g. a trailing newline */
+    void Raw(const std::string& str);
+
+    /** Hand everything buffered so far to the sink */
+    void Flush();
+
+private:
+    Sink sink;
+    size_t nChunkSize;
+    std::string buffer;
+    //! For every open object or array, whether it already has an element
+    std::vector<bool> vHasElements;
+    //! Whether the last thing written was a key waiting for its value
+    bool fAfterKey;
+
+    void BeginValue();
+    void Write(const std::string& str);
+};
+
+#endif // BITCOIN_RPC_JSONSTREAM_H
@@ -9,6 +9,7 @@
 #include "validation.h"
 #include "net.h"
 #include "netbase.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "timedata.h"
 #include "txmempool.h"
@@ -738,6 +739,40 @@ UniValue getaddressmempool(const JSONRPCRequest& request)
     return result;
 }
 
+static void getAddressUnspentFromParams(const UniValue& params, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >& unspentOutputs)
+{
+    std::vector<std::pair<uint160, AddressType> > addresses;
+
+    if (!getAddressesFromParams(params, addresses)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+        if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+    }
+
+    std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+}
+
+static UniValue addressUnspentToJSON(const std::pair<CAddressUnspentKey, CAddressUnspentValue>& unspent)
+{
+    UniValue output(UniValue::VOBJ);
+    std::string address;
+    if (!getAddressFromIndex(unspent.first.type, unspent.first.hashBytes, address)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+    }
+
+    output.push_back(Pair("address", address));
+    output.push_back(Pair("txid", unspent.first.txhash.GetHex()));
+    output.push_back(Pair("outputIndex", (int)unspent.first.index));
+    output.push_back(Pair("script", HexStr(unspent.second.script.begin(), unspent.second.script.end())));
+    output.push_back(Pair("satoshis", unspent.second.satoshis));
+    output.push_back(Pair("height", unspent.second.blockHeight));
+    return output;
+}
+
 UniValue getaddressutxos(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -768,41 +803,33 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
                 + HelpExampleRpc("getaddressutxos", "{\"addresses\": [\"XwnLY9Tf7Zsef8gMGL2fhWA9ZmMjt4KPwg\"]}")
         );
 
-    std::vector<std::pair<uint160, AddressType> > addresses;
-
-    if (!getAddressesFromParams(request.params, addresses)) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
-    }
-
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
+    getAddressUnspentFromParams(request.params, unspentOutputs);
 
-    for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-        }
+    UniValue result(UniValue::VARR);
+
+    for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=unspentOutputs.begin(); it!=unspentOutputs.end(); it++) {
+        result.push_back(addressUnspentToJSON(*it));
     }
 
-    std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
+    return result;
+}
 
-    UniValue result(UniValue::VARR);
+bool getaddressutxosStream(const JSONRPCRequest& request, CJSONStreamWriter& writer)
+{
+    if (request.fHelp || request.params.size() != 1)
+        return false;
 
-    for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=unspentOutputs.begin(); it!=unspentOutputs.end(); it++) {
-        UniValue output(UniValue::VOBJ);
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
+    getAddressUnspentFromParams(request.params, unspentOutputs);
 
-        output.push_back(Pair("address", address));
-        output.push_back(Pair("txid", it->first.txhash.GetHex()));
-        output.push_back(Pair("outputIndex", (int)it->first.index));
-        output.push_back(Pair("script", HexStr(it->second.script.begin(), it->second.script.end())));
-        output.push_back(Pair("satoshis", it->second.satoshis));
-        output.push_back(Pair("height", it->second.blockHeight));
-        result.push_back(output);
+    writer.BeginArray();
+    for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=unspentOutputs.begin(); it!=unspentOutputs.end(); it++) {
+        writer.Value(addressUnspentToJSON(*it));
     }
+    writer.EndArray();
 
-    return result;
+    return true;
 }
 
 UniValue getaddressdeltas(const JSONRPCRequest& request)
@@ -997,9 +1024,16 @@ UniValue getanonymityset(const JSONRPCRequest& request)
                 coins);
     }
 
+    // Serialize the whole set with a single field inversion
+    std::vector<secp_primitives::GroupElement> values;
+    values.reserve(coins.size());
+    for(sigma::PublicCoin const & coin : coins)
+        values.push_back(coin.getValue());
+    secp_primitives::GroupElement::normalize_batch(values);
+
     UniValue serializedCoins(UniValue::VARR);
-    for(sigma::PublicCoin const & coin : coins) {
-        std::vector<unsigned char> vch = coin.getValue().getvch();
+    for(secp_primitives::GroupElement const & value : values) {
+        std::vector<unsigned char> vch = value.getvch();
         serializedCoins.push_back(HexStr(vch.begin(), vch.end()));
     }
 
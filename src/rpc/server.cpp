@@ -6,8 +6,11 @@
 #include "rpc/server.h"
 
 #include "base58.h"
+#include "ctpl.h"
+#include "httpserver.h"
 #include "init.h"
 #include "random.h"
+#include "rpc/jsonstream.h"
 #include "sync.h"
 #include "ui_interface.h"
 #include "util.h"
@@ -23,6 +26,7 @@
 #include <boost/thread.hpp>
 #include <boost/algorithm/string/case_conv.hpp> // for to_upper()
 
+#include <future>
 #include <memory> // for unique_ptr
 #include <unordered_map>
 
@@ -37,6 +41,75 @@ static CCriticalSection cs_rpcWarmup;
 static RPCTimerInterface* timerInterface = NULL;
 /* Map of name to timer. */
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers;
+/* Runs the concurrent elements of JSON-RPC batches, while the RPC server is running.
+ * Batches hold a reference for as long as they run, the pool is stopped once the last one let go of it. */
+static std::shared_ptr<ctpl::thread_pool> rpcBatchPool;
+static CCriticalSection cs_rpcBatchPool;
+
+/** Latency histogram of RPC calls or batches */
+class CRPCLatencyHistogram
+{
+public:
+    //! Upper bounds of the buckets in microseconds, anything slower lands in the last bucket
+    static const int64_t BUCKET_LIMITS[];
+    static const size_t BUCKETS = 7;
+
+    uint64_t nCount;
+    int64_t nTotalMicros;
+    int64_t nMaxMicros;
+    uint64_t vBuckets[BUCKETS];
+
+    CRPCLatencyHistogram() : nCount(0), nTotalMicros(0), nMaxMicros(0), vBuckets() {}
+
+    void Add(int64_t nMicros)
+    {
+        size_t nBucket = 0;
+        while (nBucket < BUCKETS - 1 && nMicros > BUCKET_LIMITS[nBucket])
+            nBucket++;
+        vBuckets[nBucket]++;
+        nCount++;
+        nTotalMicros += nMicros;
+        nMaxMicros = std::max(nMaxMicros, nMicros);
+    }
+
+    UniValue ToJSON() const
+    {
+        static const char* const bucketNames[BUCKETS] = {"100us", "1ms", "10ms", "100ms", "1s", "10s", "inf"};
+        UniValue histogram(UniValue::VOBJ);
+        for (size_t i = 0; i < BUCKETS; i++)
+            histogram.push_back(Pair(bucketNames[i], vBuckets[i]));
+        UniValue ret(UniValue::VOBJ);
+        ret.push_back(Pair("count", nCount));
+        ret.push_back(Pair("total_us", nTotalMicros));
+        ret.push_back(Pair("max_us", nMaxMicros));
+        ret.push_back(Pair("histogram", histogram));
+        return ret;
+    }
+};
+
+const int64_t CRPCLatencyHistogram::BUCKET_LIMITS[] = {100, 1000, 10000, 100000, 1000000, 10000000, std::numeric_limits<int64_t>::max()};
+
+static CCriticalSection cs_rpcStats;
+static std::map<std::string, CRPCLatencyHistogram> mapRPCMethodLatency;
+static CRPCLatencyHistogram rpcBatchLatency;
+static uint64_t nRPCBatchRequests = 0;
+static uint64_t nRPCBatchConcurrent = 0;
+
+/** Records the latency of an RPC call however it returns */
+struct CRPCLatencyRecorder
+{
+    const std::string& strMethod;
+    int64_t nTimeStart;
+
+    CRPCLatencyRecorder(const std::string& strMethodIn) : strMethod(strMethodIn), nTimeStart(GetTimeMicros()) {}
+
+    ~CRPCLatencyRecorder()
+    {
+        int64_t nTime = GetTimeMicros() - nTimeStart;
+        LOCK(cs_rpcStats);
+        mapRPCMethodLatency[strMethod].Add(nTime);
+    }
+};
 
 static struct CRPCSignals
 {
@@ -317,21 +390,66 @@ UniValue stop(const JSONRPCRequest& jsonRequest)
     return "Index server stopping";
 }
 
+UniValue getrpcinfo(const JSONRPCRequest& jsonRequest)
+{
+    if (jsonRequest.fHelp || jsonRequest.params.size() > 0)
+        throw runtime_error(
+            "getrpcinfo\n"
+            "\nReturns latency statistics of the RPC server.\n"
+            "Every histogram counts calls by duration, bucketed by upper bound (100us, 1ms, ..., 10s, inf).\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"batches\": {                 (json object) JSON-RPC batches\n"
+            "    \"requests\": n,             (numeric) Total number of requests received in batches\n"
+            "    \"concurrent\": n,           (numeric) Number of those which were run concurrently\n"
+            "    \"latency\": {...}           (json object) Latency histogram of whole batches\n"
+            "  },\n"
+            "  \"methods\": {                 (json object) Latency histogram of every method called so far\n"
+            "    \"method\": {\n"
+            "      \"count\": n,              (numeric) Number of calls\n"
+            "      \"total_us\": n,           (numeric) Total time spent in microseconds\n"
+            "      \"max_us\": n,             (numeric) Slowest call in microseconds\n"
+            "      \"histogram\": {\"100us\": n, ...} (json object) Number of calls per bucket\n"
+            "    }, ...\n"
+            "  }\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrpcinfo", "")
+            + HelpExampleRpc("getrpcinfo", "")
+        );
+
+    LOCK(cs_rpcStats);
+    UniValue batches(UniValue::VOBJ);
+    batches.push_back(Pair("requests", nRPCBatchRequests));
+    batches.push_back(Pair("concurrent", nRPCBatchConcurrent));
+    batches.push_back(Pair("latency", rpcBatchLatency.ToJSON()));
+
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& entry : mapRPCMethodLatency)
+        methods.push_back(Pair(entry.first, entry.second.ToJSON()));
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("batches", batches));
+    ret.push_back(Pair("methods", methods));
+    return ret;
+}
+
 /**
  * Call Table
  */
 static const CRPCCommand vRPCCommands[] =
-{ //  category              name                      actor (function)         okSafe argNames
-  //  --------------------- ------------------------  -----------------------  ------ ----------
+{ //  category              name                      actor (function)         okSafe argNames concurrent streamActor
+  //  --------------------- ------------------------  -----------------------  ------ -------- ---------- -----------
     /* Overall control/query calls */
     { "control",            "help",                   &help,                   true  },
     { "control",            "stop",                   &stop,                   true  },
+    { "control",            "getrpcinfo",             &getrpcinfo,             true,  {},      true },
         /* Address index */
-    { "addressindex",       "getaddressmempool",      &getaddressmempool,      true  },
-    { "addressindex",       "getaddressutxos",        &getaddressutxos,        false },
-    { "addressindex",       "getaddressdeltas",       &getaddressdeltas,       false },
-    { "addressindex",       "getaddresstxids",        &getaddresstxids,        false },
-    { "addressindex",       "getaddressbalance",      &getaddressbalance,      false },
+    { "addressindex",       "getaddressmempool",      &getaddressmempool,      true,  {},      true },
+    { "addressindex",       "getaddressutxos",        &getaddressutxos,        false, {},      true, &getaddressutxosStream },
+    { "addressindex",       "getaddressdeltas",       &getaddressdeltas,       false, {},      true },
+    { "addressindex",       "getaddresstxids",        &getaddresstxids,        false, {},      true },
+    { "addressindex",       "getaddressbalance",      &getaddressbalance,      false, {},      true },
         /* Index features */
     { "index",               "indexnode",                 &indexnode,                  true  },
     { "index",               "znsync",                &znsync,                 true  },
@@ -339,10 +457,10 @@ static const CRPCCommand vRPCCommands[] =
     { "index",               "indexnodebroadcast",        &indexnodebroadcast,         true  },
     { "index",               "getpoolinfo",           &getpoolinfo,            true  },
         /* Mobile related */
-    { "mobile",             "getanonymityset",        &getanonymityset,        true  },
-    { "mobile",             "getmintmetadata",        &getmintmetadata,        true  },
-    { "mobile",             "getusedcoinserials",     &getusedcoinserials,     true  },
-    { "mobile",             "getlatestcoinids",       &getlatestcoinids,       true  },
+    { "mobile",             "getanonymityset",        &getanonymityset,        true,  {},      true },
+    { "mobile",             "getmintmetadata",        &getmintmetadata,        true,  {},      true },
+    { "mobile",             "getusedcoinserials",     &getusedcoinserials,     true,  {},      true },
+    { "mobile",             "getlatestcoinids",       &getlatestcoinids,       true,  {},      true },
 
 };
 
@@ -384,6 +502,11 @@ bool StartRPC()
 {
     LogPrint("rpc", "Starting RPC\n");
     fRPCRunning = true;
+    {
+        LOCK(cs_rpcBatchPool);
+        rpcBatchPool = std::make_shared<ctpl::thread_pool>(std::max((int)GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1));
+        RenameThreadPool(*rpcBatchPool, "rpc-batch");
+    }
     g_rpcSignals.Started();
     return true;
 }
@@ -399,6 +522,13 @@ void StopRPC()
 {
     LogPrint("rpc", "Stopping RPC\n");
     deadlineTimers.clear();
+    std::shared_ptr<ctpl::thread_pool> batchPool;
+    {
+        LOCK(cs_rpcBatchPool);
+        batchPool.swap(rpcBatchPool);
+    }
+    // Waits for the pool unless a batch still runs, the batch then stops it once it is done
+    batchPool.reset();
     DeleteAuthCookie();
     g_rpcSignals.Stopped();
 }
@@ -483,11 +613,59 @@ static UniValue JSONRPCExecOne(const UniValue& req)
     return rpc_result;
 }
 
+/** Whether a batch element calls a command that may run concurrently with its neighbours */
+static bool IsConcurrentRequest(const UniValue& req)
+{
+    if (!req.isObject())
+        return false;
+    const UniValue& method = find_value(req.get_obj(), "method");
+    if (!method.isStr())
+        return false;
+    const CRPCCommand *pcmd = tableRPC[method.get_str()];
+    return pcmd && pcmd->fConcurrent;
+}
+
 std::string JSONRPCExecBatch(const UniValue& vReq)
 {
+    int64_t nTimeStart = GetTimeMicros();
+    std::vector<UniValue> vReplies(vReq.size());
+    std::vector<std::future<void>> vPending;
+    uint64_t nConcurrent = 0;
+    std::shared_ptr<ctpl::thread_pool> batchPool;
+    if (vReq.size() > 1) {
+        LOCK(cs_rpcBatchPool);
+        batchPool = rpcBatchPool;
+    }
+
+    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++) {
+        if (batchPool && IsConcurrentRequest(vReq[reqIdx])) {
+            // Read-only elements go to the pool, results are put back in request order below
+            vPending.push_back(batchPool->push([&vReq, &vReplies, reqIdx](int) {
+                vReplies[reqIdx] = JSONRPCExecOne(vReq[reqIdx]);
+            }));
+            nConcurrent++;
+            continue;
+        }
+        // Anything else may depend on or change what earlier elements see, so it runs on
+        // its own once everything before it has finished.
+        for (std::future<void>& f : vPending)
+            f.get();
+        vPending.clear();
+        vReplies[reqIdx] = JSONRPCExecOne(vReq[reqIdx]);
+    }
+    for (std::future<void>& f : vPending)
+        f.get();
+
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(vReq[reqIdx]));
+    for (UniValue& reply : vReplies)
+        ret.push_back(reply);
+
+    {
+        LOCK(cs_rpcStats);
+        rpcBatchLatency.Add(GetTimeMicros() - nTimeStart);
+        nRPCBatchRequests += vReq.size();
+        nRPCBatchConcurrent += nConcurrent;
+    }
 
     return ret.write() + "\n";
 }
@@ -550,6 +728,8 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 
     g_rpcSignals.PreCommand(*pcmd);
 
+    CRPCLatencyRecorder latencyRecorder(pcmd->name);
+
     try
     {
         // Execute, convert arguments to array if necessary
@@ -567,6 +747,37 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     g_rpcSignals.PostCommand(*pcmd);
 }
 
+bool CRPCTable::executeStreaming(const JSONRPCRequest &request, CJSONStreamWriter &writer) const
+{
+    // Leave anything unusual, including the errors, to execute()
+    const CRPCCommand *pcmd = tableRPC[request.strMethod];
+    if (!pcmd || !pcmd->streamActor || RPCIsInWarmup(NULL))
+        return false;
+
+    g_rpcSignals.PreCommand(*pcmd);
+
+    CRPCLatencyRecorder latencyRecorder(pcmd->name);
+
+    try
+    {
+        JSONRPCRequest namedRequest;
+        const JSONRPCRequest* pRequest = &request;
+        if (request.params.isObject()) {
+            namedRequest = transformNamedArguments(request, pcmd->argNames);
+            pRequest = &namedRequest;
+        }
+        // Requests the streaming actor leaves to the regular one are answered here as well,
+        // with the result written whole, so that the command runs and is counted once
+        if (!pcmd->streamActor(*pRequest, writer))
+            writer.Value(pcmd->actor(*pRequest));
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        throw JSONRPCError(RPC_MISC_ERROR, e.what());
+    }
+}
+
 std::vector<std::string> CRPCTable::listCommands() const
 {
     std::vector<std::string> commandList;
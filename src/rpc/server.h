@@ -32,6 +32,7 @@ namespace RPCServer
 }
 
 class CBlockIndex;
+class CJSONStreamWriter;
 class CNetAddr;
 
 /** Wrapper for UniValue::VType, which includes typeAny:
@@ -134,6 +135,16 @@ void RPCRunLater(const std::string& name, boost::function<void(void)> func, int6
 
 typedef UniValue(*rpcfn_type)(const JSONRPCRequest& jsonRequest);
 
+/**
+ * Streaming variant of an actor: writes the very same result straight to writer
+ * instead of returning it. Returns false, without writing or doing anything else,
+ * for requests it leaves to the regular actor (e.g. help or small result forms),
+ * which then runs in its place. Anything that can fail is to be done before
+ * writing, and as writing may wait for the client, no lock is to be held while
+ * writing.
+ */
+typedef bool(*rpcstreamfn_type)(const JSONRPCRequest& jsonRequest, CJSONStreamWriter& writer);
+
 class CRPCCommand
 {
 public:
@@ -142,6 +153,10 @@ public:
     rpcfn_type actor;
     bool okSafeMode;
     std::vector<std::string> argNames;
+    //! Read-only command whose batch elements may run concurrently and out of order
+    bool fConcurrent;
+    //! Optional streaming actor for commands with large results
+    rpcstreamfn_type streamActor;
 };
 
 /**
@@ -164,6 +179,16 @@ public:
      */
     UniValue execute(const JSONRPCRequest &request) const;
 
+    /**
+     * Execute a method through its streaming actor, if it has one.
+     * @param request The JSONRPCRequest to execute
+     * @param writer Receives the result of the call
+     * @returns false if the request has to go through execute() instead, as the method is unknown,
+     *          has no streaming actor or the server is warming up; nothing was written then.
+     * @throws an exception (UniValue) when an error happens, part of the result may have been written.
+     */
+    bool executeStreaming(const JSONRPCRequest &request, CJSONStreamWriter &writer) const;
+
     /**
     * Returns a list of registered commands
     * @returns List of registered commands.
@@ -205,6 +230,7 @@ extern std::string HelpExampleRpc(const std::string& methodname, const std::stri
 
 extern UniValue getaddressmempool(const JSONRPCRequest &request);
 extern UniValue getaddressutxos(const JSONRPCRequest &request);
+extern bool getaddressutxosStream(const JSONRPCRequest &request, CJSONStreamWriter &writer);
 extern UniValue getaddressdeltas(const JSONRPCRequest &request);
 extern UniValue getaddresstxids(const JSONRPCRequest &request);
 extern UniValue getaddressbalance(const JSONRPCRequest &request);
@@ -20,15 +20,20 @@ public:
 
   GroupElement();
 
-  ~GroupElement();
+  // The point is stored inline, so copies and moves are plain memory copies.
+  ~GroupElement() = default;
 
-  GroupElement(const GroupElement& other);
+  GroupElement(const GroupElement& other) = default;
+
+  GroupElement(GroupElement&& other) noexcept = default;
 
   GroupElement(const char* x,const char* y,  int base = 10);
 
   GroupElement& set(const GroupElement& other);
 
-  GroupElement& operator=(const GroupElement& other);
+  GroupElement& operator=(const GroupElement& other) = default;
+
+  GroupElement& operator=(GroupElement&& other) noexcept = default;
 
   // Operator for multiplying with a scalar number.
   GroupElement operator*(const Scalar& multiplier) const;
@@ -54,6 +59,18 @@ public:
 
   bool isInfinity() const;
 
+  // Converts the point to affine coordinates in place. Comparisons, hashing and
+  // serialization of a normalized point need no field inversion, and adding it
+  // to another point is cheaper. Points are normalized when deserialized or
+  // generated, and lose it again on arithmetic. Const members never normalize,
+  // so sharing points between threads for reading stays safe.
+  GroupElement& normalize();
+
+  bool isNormalized() const;
+
+  // Normalizes all elements at once with a single field inversion.
+  static void normalize_batch(std::vector<GroupElement>& elements);
+
   GroupElement& generate(unsigned char* seed);
 
   void sha256(unsigned char* result) const;
@@ -107,8 +124,20 @@ private:
 
     GroupElement(const void *g);
 
+    // Sets the point from a secp256k1_ge, keeping its coordinates as they are.
+    void set_affine(const void *ge);
+
+    // Writes the point as a secp256k1_ge with normalized coordinates when it is affine.
+    void get_affine(void *ge) const;
+
 private:
-    void *g_; // secp256k1_gej
+    // Large enough for secp256k1_gej with either field implementation, checked in GroupElement.cpp.
+    static constexpr std::size_t gej_storage_size = 128;
+
+    alignas(8) unsigned char g_[gej_storage_size]; // secp256k1_gej
+
+    // Whether g_ has z = 1, never set for infinity. x and y are not normalized.
+    bool normalized_;
 
 };
 
@@ -1,6 +1,8 @@
 #ifndef SECP_MULTIEXPONENT_H
 #define SECP_MULTIEXPONENT_H
 
+#include <cstddef>
+#include <functional>
 #include <vector>
 #include "../include/GroupElement.h"
 #include "../include/Scalar.h"
@@ -9,16 +11,39 @@ namespace secp_primitives {
 
 class MultiExponent {
 public:
+    // Runs all the given tasks and returns once they are done, typically on a
+    // thread pool of the caller. The tasks are independent of each other.
+    typedef std::function<void(const std::vector<std::function<void()>>&)> TaskRunner;
+
+    // Multiexps of fewer points are not worth splitting between tasks.
+    static constexpr std::size_t min_parallel_points = 1024;
+
     MultiExponent(const MultiExponent& other);
+
+    // Copies the generators and powers.
     MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers);
-    ~MultiExponent();
 
-    GroupElement get_multiple();
+    // Refers to n generators and powers in place, without copying them; they
+    // must outlive the object.
+    MultiExponent(const GroupElement* generators, const Scalar* powers, std::size_t n);
+
+    MultiExponent& operator=(const MultiExponent& other) = delete;
+
+    GroupElement get_multiple() const;
+
+    // Same result, with the work split into up to n_tasks tasks run by runner.
+    // Pippenger's bucket windows are divided between the tasks, so the total
+    // work stays the same as computing it in one go.
+    GroupElement get_multiple(const TaskRunner& runner, std::size_t n_tasks) const;
 
 private:
-    void  *sc_; // secp256k1_scalar[]
-    void  *pt_; // secp256k1_gej[]
-    int n_points;
+    // Only used by the copying constructor.
+    std::vector<GroupElement> own_generators_;
+    std::vector<Scalar> own_powers_;
+
+    const GroupElement* generators_;
+    const Scalar* powers_;
+    std::size_t n_points;
 };
 
 }// namespace secp_primitives
@@ -20,16 +20,20 @@ public:
     // Constructor from interger.
     Scalar(uint64_t value);
 
-    // Copy constructor
-    Scalar(const Scalar& other);
+    // The value is stored inline, so copies and moves are plain memory copies.
+    Scalar(const Scalar& other) = default;
+
+    Scalar(Scalar&& other) noexcept = default;
 
     Scalar(const unsigned char* str);
 
-    ~Scalar();
+    ~Scalar() = default;
 
     Scalar& set(const Scalar& other);
 
-    Scalar& operator=(const Scalar& other);
+    Scalar& operator=(const Scalar& other) = default;
+
+    Scalar& operator=(Scalar&& other) noexcept = default;
 
     Scalar& operator=(unsigned int i);
 
@@ -118,7 +122,10 @@ private:
     Scalar(const void *value);
 
 private:
-    void *value_; // secp256k1_scalar
+    // Large enough for secp256k1_scalar with either implementation, checked in Scalar.cpp.
+    static constexpr size_t scalar_storage_size = 32;
+
+    alignas(8) unsigned char value_[scalar_storage_size]; // secp256k1_scalar
 
 };
 
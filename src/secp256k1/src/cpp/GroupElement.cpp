@@ -23,6 +23,17 @@
 
 static secp256k1_ecmult_context ctx;
 
+// Views of the inline storage of GroupElement.
+static secp256k1_gej* as_gej(unsigned char* storage)
+{
+    return reinterpret_cast<secp256k1_gej *>(storage);
+}
+
+static const secp256k1_gej* as_gej(const unsigned char* storage)
+{
+    return reinterpret_cast<const secp256k1_gej *>(storage);
+}
+
 // Converts the value from secp256k1_gej to secp256k1_ge and returns.
 static secp256k1_ge gej_to_ge(const secp256k1_gej &gej)
 {
@@ -159,22 +170,45 @@ static void _negate (uint8_t(&num) [Len])
     }
 }
 
+static_assert(sizeof(secp256k1_gej) <= sizeof(GroupElement), "GroupElement storage is too small for secp256k1_gej");
+static_assert(alignof(secp256k1_gej) <= alignof(GroupElement), "GroupElement storage is not aligned for secp256k1_gej");
+
 GroupElement::GroupElement()
-        : g_(new secp256k1_gej())
+        : normalized_(false)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
     secp256k1_gej_clear(g);
     g->infinity = 1;
 }
 
-GroupElement::GroupElement(const GroupElement& other)
-        : g_(new secp256k1_gej(*reinterpret_cast<secp256k1_gej *>(other.g_)))
+GroupElement::GroupElement(const void *g)
+        : normalized_(false)
 {
+    *as_gej(g_) = *reinterpret_cast<const secp256k1_gej *>(g);
 }
 
-GroupElement::GroupElement(const void *g)
-        : g_(new secp256k1_gej(*reinterpret_cast<const secp256k1_gej *>(g)))
+void GroupElement::set_affine(const void *ge)
+{
+    auto g = as_gej(g_);
+    // The coordinates are kept exactly as given: sha256() hashes them as they are
+    // stored, and the Sigma generators are derived from these hashes.
+    secp256k1_gej_set_ge(g, reinterpret_cast<const secp256k1_ge *>(ge));
+    // Infinity has no affine coordinates, it always takes the generic path
+    normalized_ = !g->infinity;
+}
+
+void GroupElement::get_affine(void *ge) const
 {
+    auto r = reinterpret_cast<secp256k1_ge *>(ge);
+    if (!normalized_) {
+        *r = gej_to_ge(*as_gej(g_));
+        return;
+    }
+
+    auto g = as_gej(g_);
+    secp256k1_ge_set_xy(r, &g->x, &g->y);
+    secp256k1_fe_normalize_var(&r->x);
+    secp256k1_fe_normalize_var(&r->y);
 }
 
 static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
@@ -225,31 +259,21 @@ static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
 }
 
 GroupElement::GroupElement(const char* x,const char* y, int base)
-        : g_(new secp256k1_gej())
+        : normalized_(false)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
 
     secp256k1_gej_clear(g);
     secp256k1_ge element;
     _convertToFieldElement(&element.x,x,base);
     _convertToFieldElement(&element.y,y,base);
     element.infinity = 0;
-    secp256k1_gej_set_ge(g,&element);
-}
-
-GroupElement::~GroupElement()
-{
-    delete reinterpret_cast<secp256k1_gej *>(g_);
-}
-
-GroupElement& GroupElement::operator=(const GroupElement &other)
-{
-    return set(other);
+    set_affine(&element);
 }
 
 GroupElement& GroupElement::set(const GroupElement &other)
 {
-    *reinterpret_cast<secp256k1_gej *>(g_) = *reinterpret_cast<secp256k1_gej *>(other.g_);
+    *this = other;
     return *this;
 }
 
@@ -258,57 +282,79 @@ GroupElement GroupElement::operator*(const Scalar& multiplier) const
     secp256k1_gej result;
     secp256k1_scalar ng;
     secp256k1_scalar_set_int(&ng,0);
-    secp256k1_ecmult(&ctx,&result,reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
+    secp256k1_ecmult(&ctx,&result,as_gej(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
     return &result;
 }
 
 GroupElement& GroupElement::operator*=(const Scalar& multiplier)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
     secp256k1_scalar ng;
     secp256k1_scalar_set_int(&ng,0);
     secp256k1_ecmult(&ctx,g,g, reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
+    normalized_ = false;
     return *this;
 }
 
 GroupElement GroupElement::operator+(const GroupElement &other) const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_add_var(&result_gej, reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    // Mixed addition is cheaper when either point is affine already
+    if (other.normalized_) {
+        secp256k1_ge other_ge;
+        other.get_affine(&other_ge);
+        secp256k1_gej_add_ge_var(&result_gej, as_gej(g_), &other_ge, NULL);
+    } else if (normalized_) {
+        secp256k1_ge this_ge;
+        get_affine(&this_ge);
+        secp256k1_gej_add_ge_var(&result_gej, as_gej(other.g_), &this_ge, NULL);
+    } else {
+        secp256k1_gej_add_var(&result_gej, as_gej(g_), as_gej(other.g_), NULL);
+    }
     return &result_gej;
 }
 
 GroupElement& GroupElement::operator+=(const GroupElement& other)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    secp256k1_gej_add_var(g, g, reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    auto g = as_gej(g_);
+    if (other.normalized_) {
+        secp256k1_ge other_ge;
+        other.get_affine(&other_ge);
+        secp256k1_gej_add_ge_var(g, g, &other_ge, NULL);
+    } else {
+        secp256k1_gej_add_var(g, g, as_gej(other.g_), NULL);
+    }
+    normalized_ = false;
     return *this;
 }
 
 GroupElement GroupElement::inverse() const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_neg(&result_gej,reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_gej_neg(&result_gej,as_gej(g_));
     return &result_gej;
 }
 
 void GroupElement::square()
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
     secp256k1_gej_double_var(g, g, NULL);
+    normalized_ = false;
 }
 
 bool GroupElement::operator==(const  GroupElement& other) const
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    auto og = reinterpret_cast<secp256k1_gej *>(other.g_);
+    auto g = as_gej(g_);
+    auto og = as_gej(other.g_);
 
     if(g->infinity && og->infinity)
         return true;
     if(g->infinity != og->infinity)
         return false;
-    secp256k1_ge this_ge = gej_to_ge(*g);
-    secp256k1_ge other_ge = gej_to_ge(*og);
+    secp256k1_ge this_ge;
+    get_affine(&this_ge);
+    secp256k1_ge other_ge;
+    other.get_affine(&other_ge);
     if(!secp256k1_fe_equal(&this_ge.x, &other_ge.x))
         return false;
     if(!secp256k1_fe_equal(&this_ge.y, &other_ge.y))
@@ -324,7 +370,8 @@ bool GroupElement::operator!=(const  GroupElement& other) const
 
 bool GroupElement::isMember() const
 {
-    secp256k1_ge v1 = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge v1;
+    get_affine(&v1);
     if (secp256k1_ge_is_infinity(&v1)) {
         return true;
     }
@@ -333,7 +380,7 @@ bool GroupElement::isMember() const
 
 bool GroupElement::isInfinity() const
 {
-    return secp256k1_gej_is_infinity(reinterpret_cast<const secp256k1_gej *>(g_));
+    return secp256k1_gej_is_infinity(as_gej(g_));
 }
 
 void GroupElement::randomize() {
@@ -383,12 +430,14 @@ GroupElement& GroupElement::generate(unsigned char* seed){
     if (gen[0] & 1) {
         secp256k1_ge_neg(&ge, &ge);
     }
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &ge);
+    set_affine(&ge);
     return *this;
 }
 
+// Hashes the stored coordinates as they are, without normalizing them, as the
+// Sigma and Elysium generators always were derived.
 void GroupElement::sha256(unsigned char* result) const{
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
     unsigned char buff[64];
     secp256k1_fe_get_b32(&buff[0], &g->x);
     secp256k1_fe_get_b32(&buff[32], &g->y);
@@ -447,7 +496,8 @@ std::string _convertToString(const unsigned char(&buffer) [Len], int base) {
 
 std::string GroupElement::tostring() const {
     int base = 10;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge ge;
+    get_affine(&ge);
 
     if (ge.infinity) {
     return std::string("O");
@@ -456,6 +506,8 @@ std::string GroupElement::tostring() const {
     std::stringstream str;
     unsigned char buffer[32];
 
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
     str << '(';
     secp256k1_fe_get_b32(buffer,&ge.x);
     str << _convertToString(buffer, base);
@@ -469,7 +521,8 @@ std::string GroupElement::tostring() const {
 
 std::string GroupElement::GetHex() const {
     int base = 16;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge ge;
+    get_affine(&ge);
 
     if (ge.infinity) {
         return std::string("O");
@@ -478,6 +531,8 @@ std::string GroupElement::GetHex() const {
     std::stringstream str;
     unsigned char buffer[32];
 
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
     str << '(';
     secp256k1_fe_get_b32(buffer,&ge.x);
     str << _convertToString(buffer, base);
@@ -490,7 +545,7 @@ std::string GroupElement::GetHex() const {
 }
 
 unsigned char* GroupElement::serialize() const {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = as_gej(g_);
     unsigned char* data = new unsigned char[ 2 * sizeof(secp256k1_fe)];
     memcpy(&data[0], &g->x.n[0], sizeof(secp256k1_fe));
     memcpy(&data[0] + sizeof(secp256k1_fe), &g->y.n[0], sizeof(secp256k1_fe));
@@ -498,7 +553,8 @@ unsigned char* GroupElement::serialize() const {
 }
 
 unsigned char* GroupElement::serialize(unsigned char* buffer) const {
-    secp256k1_ge value = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge value;
+    get_affine(&value);
     secp256k1_fe x = value.x;
     secp256k1_fe y = value.y;
     secp256k1_fe_normalize(&x);
@@ -519,7 +575,7 @@ const unsigned char* GroupElement::deserialize(const unsigned char* buffer) {
     secp256k1_ge result;
     secp256k1_ge_set_xo_var(&result, &x, (int)oddness);
     result.infinity = (int)infinity;
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &result);
+    set_affine(&result);
     return buffer + memoryRequired();
 }
 
@@ -533,12 +589,16 @@ std::vector<unsigned char> GroupElement::getvch() const {
 
 std::size_t GroupElement::hash() const
 {
-    auto ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge ge;
+    get_affine(&ge);
     std::array<unsigned char, 32 * 2> coord;
 
     if (ge.infinity) {
         coord.fill(0);
     } else {
+        // Equal points must hash equally whatever the representation of their coordinates
+        secp256k1_fe_normalize_var(&ge.x);
+        secp256k1_fe_normalize_var(&ge.y);
         secp256k1_fe_get_b32(&coord[0], &ge.x);
         secp256k1_fe_get_b32(&coord[32], &ge.y);
     }
@@ -551,8 +611,43 @@ const void* GroupElement::get_value() const {
 }
 
 GroupElement& GroupElement::set_base_g() {
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &secp256k1_ge_const_g);
+    set_affine(&secp256k1_ge_const_g);
+    return *this;
+}
+
+GroupElement& GroupElement::normalize() {
+    if (!normalized_ && !isInfinity()) {
+        secp256k1_ge ge = gej_to_ge(*as_gej(g_));
+        set_affine(&ge);
+    }
     return *this;
 }
 
+bool GroupElement::isNormalized() const {
+    return normalized_;
+}
+
+void GroupElement::normalize_batch(std::vector<GroupElement>& elements) {
+    std::vector<GroupElement*> pending;
+    std::vector<secp256k1_fe> z;
+    pending.reserve(elements.size());
+    z.reserve(elements.size());
+    for (auto& element : elements) {
+        if (!element.normalized_ && !element.isInfinity()) {
+            pending.push_back(&element);
+            z.push_back(as_gej(element.g_)->z);
+        }
+    }
+
+    // Montgomery's trick: one field inversion for all of them
+    std::vector<secp256k1_fe> zInverse(z.size());
+    secp256k1_fe_inv_all_var(zInverse.data(), z.data(), z.size());
+
+    for (std::size_t i = 0; i < pending.size(); i++) {
+        secp256k1_ge ge;
+        secp256k1_ge_set_gej_zinv(&ge, as_gej(pending[i]->g_), &zInverse[i]);
+        pending[i]->set_affine(&ge);
+    }
+}
+
 } // namespace secp_primitives
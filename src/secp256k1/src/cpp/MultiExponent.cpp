@@ -12,10 +12,13 @@
 #include "../src/scratch_impl.h"
 #include "../src/ecmult_impl.h"
 
+#include <algorithm>
+#include <utility>
+
 
 typedef struct {
-    secp256k1_scalar *sc;
-    secp256k1_gej *pt;
+    const secp256k1_scalar *sc;
+    const secp256k1_gej *pt;
 } ecmult_multi_data;
 
 int ecmult_multi_callback(secp256k1_scalar *sc, secp256k1_gej *pt, size_t idx, void *cbdata) {
@@ -27,58 +30,288 @@ int ecmult_multi_callback(secp256k1_scalar *sc, secp256k1_gej *pt, size_t idx, v
 
 namespace secp_primitives {
 
+namespace {
+
+#ifdef USE_ENDOMORPHISM
+// Every point is split in two with half length scalars.
+const std::size_t entries_per_point = 2;
+#else
+const std::size_t entries_per_point = 1;
+#endif
+
+// Scratch space for the Strauss multiexps below the Pippenger threshold. It
+// is created once per thread; its frames are still allocated per call.
+struct strauss_scratch {
+    secp256k1_scratch *scratch;
+
+    strauss_scratch()
+        : scratch(secp256k1_scratch_create(NULL, secp256k1_strauss_scratch_size(ECMULT_PIPPENGER_THRESHOLD) + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT)) {
+    }
+
+    ~strauss_scratch() {
+        secp256k1_scratch_destroy(scratch);
+    }
+};
+
+// The affine points and wnaf digits of a Pippenger multiexp. They are kept per
+// thread and reused, so repeated multiexps only allocate when they are larger
+// than any before on the same thread.
+struct pippenger_buffers {
+    std::vector<secp256k1_ge> points;
+    std::vector<secp256k1_scalar> scalars;
+    std::vector<int> wnaf;
+    std::vector<int> skew;
+    // z coordinates of the points that are not affine yet, and their inverses
+    std::vector<secp256k1_fe> z;
+    std::vector<secp256k1_fe> z_inv;
+    // gej inputs of the Strauss multiexps
+    std::vector<secp256k1_gej> strauss_points;
+    std::vector<secp256k1_scalar> strauss_scalars;
+
+    void resize(std::size_t n_points, int bucket_window) {
+        std::size_t n_entries = n_points * entries_per_point;
+        if (points.size() < n_entries) {
+            points.resize(n_entries);
+            scalars.resize(n_entries);
+            skew.resize(n_entries);
+        }
+        if (wnaf.size() < n_entries * WNAF_SIZE(bucket_window+1))
+            wnaf.resize(n_entries * WNAF_SIZE(bucket_window+1));
+        if (z.size() < n_points) {
+            z.resize(n_points);
+            z_inv.resize(n_points);
+        }
+    }
+};
+
+thread_local pippenger_buffers tls_buffers;
+thread_local std::vector<secp256k1_gej> tls_buckets;
+thread_local strauss_scratch tls_strauss_scratch;
+
+// Converts points [begin, end) to affine coordinates with one field inversion
+// and computes the wnaf digits of their scalars. A point whose scalar is zero,
+// or which is infinity, gets all zero digits and is never looked at again.
+// point_at(i) returns the secp256k1_gej of point i and whether it is affine.
+template <typename PointAt>
+void pippenger_prepare(pippenger_buffers& b, const PointAt& point_at, const Scalar* powers, std::size_t begin, std::size_t end, int bucket_window) {
+    const std::size_t n_wnaf = WNAF_SIZE(bucket_window+1);
+    std::size_t n_z = 0;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        std::pair<const secp256k1_gej*, bool> point = point_at(i);
+        std::size_t e = i * entries_per_point;
+        b.scalars[e] = *reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
+        if (point.first->infinity || secp256k1_scalar_is_zero(&b.scalars[e])) {
+            secp256k1_scalar_clear(&b.scalars[e]);
+            secp256k1_ge_set_infinity(&b.points[e]);
+        } else if (point.second) {
+            // Affine points keep their coordinates as they were set, possibly of magnitude 2
+            secp256k1_ge_set_xy(&b.points[e], &point.first->x, &point.first->y);
+            secp256k1_fe_normalize_weak(&b.points[e].x);
+            secp256k1_fe_normalize_weak(&b.points[e].y);
+        } else {
+            b.z[begin + n_z++] = point.first->z;
+        }
+    }
+    secp256k1_fe_inv_all_var(&b.z_inv[begin], &b.z[begin], n_z);
+
+    n_z = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        std::pair<const secp256k1_gej*, bool> point = point_at(i);
+        std::size_t e = i * entries_per_point;
+        if (!secp256k1_scalar_is_zero(&b.scalars[e]) && !point.first->infinity && !point.second) {
+            secp256k1_ge_set_gej_zinv(&b.points[e], point.first, &b.z_inv[begin + n_z++]);
+        }
+#ifdef USE_ENDOMORPHISM
+        if (secp256k1_scalar_is_zero(&b.scalars[e])) {
+            secp256k1_scalar_clear(&b.scalars[e + 1]);
+            secp256k1_ge_set_infinity(&b.points[e + 1]);
+        } else {
+            secp256k1_ecmult_endo_split(&b.scalars[e], &b.scalars[e + 1], &b.points[e], &b.points[e + 1]);
+        }
+#endif
+        for (std::size_t k = e; k < e + entries_per_point; ++k) {
+            b.skew[k] = secp256k1_wnaf_fixed(&b.wnaf[k * n_wnaf], &b.scalars[k], bucket_window+1);
+        }
+    }
+}
+
+// The part of secp256k1_ecmult_pippenger_wnaf for windows [first, last) and
+// entries [begin, end), without the factor of 2^(first*(bucket_window+1)).
+void pippenger_windows(const pippenger_buffers& b, std::size_t begin, std::size_t end, int bucket_window, int first, int last, secp256k1_gej *r) {
+    const std::size_t n_wnaf = WNAF_SIZE(bucket_window+1);
+    const int n_buckets = ECMULT_TABLE_SIZE(bucket_window+2);
+    if (tls_buckets.size() < (std::size_t)n_buckets)
+        tls_buckets.resize(n_buckets);
+    secp256k1_gej *buckets = tls_buckets.data();
+
+    secp256k1_gej_set_infinity(r);
+    for (int i = last - 1; i >= first; i--) {
+        secp256k1_gej running_sum;
+        int j;
+
+        for (j = 0; j < n_buckets; j++) {
+            secp256k1_gej_set_infinity(&buckets[j]);
+        }
+
+        for (std::size_t e = begin; e < end; ++e) {
+            int n = b.wnaf[e*n_wnaf + i];
+            secp256k1_ge tmp;
+            int idx;
+
+            if (i == 0 && b.skew[e]) {
+                /* correct for wnaf skew */
+                secp256k1_ge_neg(&tmp, &b.points[e]);
+                secp256k1_gej_add_ge_var(&buckets[0], &buckets[0], &tmp, NULL);
+            }
+            if (n > 0) {
+                idx = (n - 1)/2;
+                secp256k1_gej_add_ge_var(&buckets[idx], &buckets[idx], &b.points[e], NULL);
+            } else if (n < 0) {
+                idx = -(n + 1)/2;
+                secp256k1_ge_neg(&tmp, &b.points[e]);
+                secp256k1_gej_add_ge_var(&buckets[idx], &buckets[idx], &tmp, NULL);
+            }
+        }
+
+        for (j = 0; j < bucket_window; j++) {
+            secp256k1_gej_double_var(r, r, NULL);
+        }
+
+        secp256k1_gej_set_infinity(&running_sum);
+        for (j = n_buckets - 1; j > 0; j--) {
+            secp256k1_gej_add_var(&running_sum, &running_sum, &buckets[j], NULL);
+            secp256k1_gej_add_var(r, r, &running_sum, NULL);
+        }
+
+        secp256k1_gej_add_var(&running_sum, &running_sum, &buckets[0], NULL);
+        secp256k1_gej_double_var(r, r, NULL);
+        secp256k1_gej_add_var(r, r, &running_sum, NULL);
+    }
+}
+
+// Splits [0, n) into almost equal parts and returns where part i starts.
+std::size_t part_begin(std::size_t n, std::size_t parts, std::size_t i) {
+    return n / parts * i + std::min(i, n % parts);
+}
+
+} // namespace
+
 MultiExponent::MultiExponent(const MultiExponent& other)
-        : sc_(new secp256k1_scalar[other.n_points])
-        , pt_(new secp256k1_gej[other.n_points])
+        : own_generators_(other.own_generators_)
+        , own_powers_(other.own_powers_)
+        , generators_(other.own_generators_.empty() ? other.generators_ : own_generators_.data())
+        , powers_(other.own_powers_.empty() ? other.powers_ : own_powers_.data())
         , n_points(other.n_points)
 {
-    for(int i = 0; i < n_points; ++i)
-    {
-        (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = (reinterpret_cast<secp256k1_scalar *>(other.sc_))[i];
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = (reinterpret_cast<secp256k1_gej *>(other.pt_))[i];
-    }
 }
 
-MultiExponent::MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers){
-    sc_ = new secp256k1_scalar[powers.size()];
-    pt_ = new secp256k1_gej[generators.size()];
-    n_points = generators.size();
-    for(int i = 0; i < n_points; ++i)
-    {
-        (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = *reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = *reinterpret_cast<const secp256k1_gej *>(generators[i].get_value());
-    }
+MultiExponent::MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers)
+        : own_generators_(generators)
+        , own_powers_(powers)
+        , generators_(own_generators_.data())
+        , powers_(own_powers_.data())
+        , n_points(generators.size())
+{
 }
 
-MultiExponent::~MultiExponent(){
-    delete []reinterpret_cast<secp256k1_scalar *>(sc_);
-    delete []reinterpret_cast<secp256k1_gej *>(pt_);
+MultiExponent::MultiExponent(const GroupElement* generators, const Scalar* powers, std::size_t n)
+        : generators_(generators)
+        , powers_(powers)
+        , n_points(n)
+{
+}
+
+GroupElement MultiExponent::get_multiple() const {
+    return get_multiple(TaskRunner(), 1);
 }
 
-GroupElement MultiExponent::get_multiple() {
+GroupElement MultiExponent::get_multiple(const TaskRunner& runner, std::size_t n_tasks) const {
     secp256k1_gej r;
+    pippenger_buffers& b = tls_buffers;
 
-    ecmult_multi_data data;
-    data.sc = reinterpret_cast<secp256k1_scalar *>(sc_);
-    data.pt = reinterpret_cast<secp256k1_gej *>(pt_);
+    if (n_points < ECMULT_PIPPENGER_THRESHOLD) {
+        if (b.strauss_points.size() < n_points) {
+            b.strauss_points.resize(n_points);
+            b.strauss_scalars.resize(n_points);
+        }
+        for (std::size_t i = 0; i < n_points; ++i) {
+            b.strauss_points[i] = *reinterpret_cast<const secp256k1_gej *>(generators_[i].get_value());
+            b.strauss_scalars[i] = *reinterpret_cast<const secp256k1_scalar *>(powers_[i].get_value());
+        }
 
-    secp256k1_scratch *scratch;
-    if (n_points > ECMULT_PIPPENGER_THRESHOLD) {
-        int bucket_window = secp256k1_pippenger_bucket_window(n_points);
-        size_t scratch_size = secp256k1_pippenger_scratch_size(n_points, bucket_window);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
-    } else {
-        size_t scratch_size = secp256k1_strauss_scratch_size(n_points);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT);
+        ecmult_multi_data data;
+        data.sc = b.strauss_scalars.data();
+        data.pt = b.strauss_points.data();
+
+        secp256k1_ecmult_context ctx;
+        secp256k1_ecmult_multi_var(&ctx, tls_strauss_scratch.scratch, &r, NULL, ecmult_multi_callback, &data, n_points);
+        return GroupElement(&r);
     }
 
-    secp256k1_ecmult_context ctx;
+    const GroupElement* generators = generators_;
+    auto point_at = [generators](std::size_t i) {
+        return std::make_pair(reinterpret_cast<const secp256k1_gej *>(generators[i].get_value()), generators[i].normalized_);
+    };
 
-    secp256k1_ecmult_multi_var(&ctx, scratch, &r, NULL, ecmult_multi_callback, &data, n_points);
+    const int bucket_window = secp256k1_pippenger_bucket_window(n_points);
+    const int n_wnaf = WNAF_SIZE(bucket_window+1);
+    const std::size_t n_entries = n_points * entries_per_point;
+    b.resize(n_points, bucket_window);
 
-    secp256k1_scratch_destroy(scratch);
+    if (!runner || n_tasks <= 1 || n_points < min_parallel_points) {
+        pippenger_prepare(b, point_at, powers_, 0, n_points, bucket_window);
+        pippenger_windows(b, 0, n_entries, bucket_window, 0, n_wnaf, &r);
+        return GroupElement(&r);
+    }
 
-    return  reinterpret_cast<secp256k1_scalar *>(&r);
+    // First every task prepares a share of the points, then the windows are
+    // divided between the tasks, and the points too if there are more tasks
+    // than windows. Each task has the buckets of its own thread.
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(n_tasks);
+    const Scalar* powers = powers_;
+    for (std::size_t t = 0; t < n_tasks; ++t) {
+        std::size_t begin = part_begin(n_points, n_tasks, t);
+        std::size_t end = part_begin(n_points, n_tasks, t + 1);
+        tasks.push_back([&b, &point_at, powers, begin, end, bucket_window]() {
+            pippenger_prepare(b, point_at, powers, begin, end, bucket_window);
+        });
+    }
+    runner(tasks);
+
+    const std::size_t window_parts = std::min(n_tasks, (std::size_t)n_wnaf);
+    const std::size_t entry_parts = n_tasks / window_parts;
+    std::vector<secp256k1_gej> partial(window_parts * entry_parts);
+    tasks.clear();
+    for (std::size_t w = 0; w < window_parts; ++w) {
+        int first = part_begin(n_wnaf, window_parts, w);
+        int last = part_begin(n_wnaf, window_parts, w + 1);
+        for (std::size_t p = 0; p < entry_parts; ++p) {
+            std::size_t begin = part_begin(n_entries, entry_parts, p);
+            std::size_t end = part_begin(n_entries, entry_parts, p + 1);
+            secp256k1_gej *result = &partial[w * entry_parts + p];
+            tasks.push_back([&b, begin, end, bucket_window, first, last, result]() {
+                pippenger_windows(b, begin, end, bucket_window, first, last, result);
+            });
+        }
+    }
+    runner(tasks);
+
+    // Horner's rule over the window parts, from the most significant one
+    secp256k1_gej_set_infinity(&r);
+    for (std::size_t w = window_parts; w-- > 0;) {
+        if (w + 1 < window_parts) {
+            int n_doublings = (part_begin(n_wnaf, window_parts, w + 1) - part_begin(n_wnaf, window_parts, w)) * (bucket_window + 1);
+            for (int j = 0; j < n_doublings; j++) {
+                secp256k1_gej_double_var(&r, &r, NULL);
+            }
+        }
+        for (std::size_t p = 0; p < entry_parts; ++p) {
+            secp256k1_gej_add_var(&r, &r, &partial[w * entry_parts + p], NULL);
+        }
+    }
+    return GroupElement(&r);
 }
 
 }// namespace secp_primitives
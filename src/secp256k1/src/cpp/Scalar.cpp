@@ -16,82 +16,77 @@
 #include <iostream>
 #include <openssl/rand.h>
 
-namespace secp_primitives {
-
-Scalar::Scalar()
-   : value_(new secp256k1_scalar()) {
-    secp256k1_scalar_clear(reinterpret_cast<secp256k1_scalar *>(value_));
+// Views of the inline storage of Scalar.
+static secp256k1_scalar* as_scalar(unsigned char* storage) {
+    return reinterpret_cast<secp256k1_scalar *>(storage);
 }
 
-Scalar::Scalar(uint64_t value)
-   : value_(new secp256k1_scalar()) {
-    secp256k1_scalar_set_int(reinterpret_cast<secp256k1_scalar *>(value_), value);
+static const secp256k1_scalar* as_scalar(const unsigned char* storage) {
+    return reinterpret_cast<const secp256k1_scalar *>(storage);
 }
 
-Scalar::Scalar(const unsigned char* str)
-     : value_(new secp256k1_scalar()) {
-    secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), str, 0);
-}
+namespace secp_primitives {
 
-Scalar::Scalar(const void *value)
-   : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(value))) {
+static_assert(sizeof(secp256k1_scalar) <= sizeof(Scalar), "Scalar storage is too small for secp256k1_scalar");
+static_assert(alignof(secp256k1_scalar) <= alignof(Scalar), "Scalar storage is not aligned for secp256k1_scalar");
 
+Scalar::Scalar() {
+    secp256k1_scalar_clear(as_scalar(value_));
 }
 
-Scalar::Scalar(const Scalar& other)
-   : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(other.value_))) {
-
+Scalar::Scalar(uint64_t value) {
+    secp256k1_scalar_set_int(as_scalar(value_), value);
 }
 
-Scalar::~Scalar() {
-    delete reinterpret_cast<secp256k1_scalar *>(value_);
+Scalar::Scalar(const unsigned char* str) {
+    secp256k1_scalar_set_b32(as_scalar(value_), str, 0);
 }
 
-Scalar& Scalar::operator=(const Scalar& other) {
-    return set(other);
+Scalar::Scalar(const void *value) {
+    *as_scalar(value_) = *reinterpret_cast<const secp256k1_scalar *>(value);
 }
 
 Scalar& Scalar::operator=(unsigned int i) {
-    secp256k1_scalar_set_int(reinterpret_cast<secp256k1_scalar *>(value_), i);
+    secp256k1_scalar_set_int(as_scalar(value_), i);
     return *this;
 }
 
 Scalar& Scalar::operator=(const unsigned char *bin){
-    secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), bin, NULL);
+    secp256k1_scalar_set_b32(as_scalar(value_), bin, NULL);
     return *this;
 }
 
 Scalar& Scalar::set(const Scalar& other) {
-    *reinterpret_cast<secp256k1_scalar *>(value_) = *reinterpret_cast<const secp256k1_scalar *>(other.value_);
+    *as_scalar(value_) = *as_scalar(other.value_);
     return *this;
 }
 
 Scalar Scalar::operator*(const Scalar& other) const {
     secp256k1_scalar result;
-    secp256k1_scalar_mul(&result, reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_));
+    secp256k1_scalar_mul(&result, as_scalar(value_), as_scalar(other.value_));
     return &result;
 }
 
 Scalar& Scalar::operator*=(const Scalar& other) {
     secp256k1_scalar result;
 
-    secp256k1_scalar_mul(&result, reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_));
-    *reinterpret_cast<secp256k1_scalar *>(value_) = result;
+    secp256k1_scalar_mul(&result, as_scalar(value_), as_scalar(other.value_));
+    *as_scalar(value_) = result;
 
     return *this;
 }
 
 Scalar Scalar::operator+(const Scalar& other) const {
     secp256k1_scalar result;
-    secp256k1_scalar_add(&result, reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_));
+    secp256k1_scalar_add(&result, as_scalar(value_), as_scalar(other.value_));
     return &result;
 }
 
 Scalar& Scalar::operator+=(const Scalar& other) {
     secp256k1_scalar result;
 
-    secp256k1_scalar_add(&result, reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_));
-    *reinterpret_cast<secp256k1_scalar *>(value_) = result;
+    secp256k1_scalar_add(&result, as_scalar(value_), as_scalar(other.value_));
+    *as_scalar(value_) = result;
 
     return *this;
 }
@@ -99,8 +94,8 @@ Scalar& Scalar::operator+=(const Scalar& other) {
 Scalar Scalar::operator-(const Scalar& other) const {
     secp256k1_scalar negated, result;
 
-    secp256k1_scalar_negate(&negated, reinterpret_cast<const secp256k1_scalar *>(other.value_));
-    secp256k1_scalar_add(&result, &negated, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_negate(&negated, as_scalar(other.value_));
+    secp256k1_scalar_add(&result, &negated, as_scalar(value_));
 
     return &result;
 }
@@ -108,19 +103,19 @@ Scalar Scalar::operator-(const Scalar& other) const {
 Scalar& Scalar::operator-=(const Scalar& other) {
     secp256k1_scalar negated, result;
 
-    secp256k1_scalar_negate(&negated, reinterpret_cast<const secp256k1_scalar *>(other.value_));
-    secp256k1_scalar_add(&result, reinterpret_cast<const secp256k1_scalar *>(value_), &negated);
-    *reinterpret_cast<secp256k1_scalar *>(value_) = result;
+    secp256k1_scalar_negate(&negated, as_scalar(other.value_));
+    secp256k1_scalar_add(&result, as_scalar(value_), &negated);
+    *as_scalar(value_) = result;
 
     return *this;
 }
 
 bool Scalar::operator==(const Scalar& other) const {
-    return secp256k1_scalar_eq(reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_));
+    return secp256k1_scalar_eq(as_scalar(value_), as_scalar(other.value_));
 }
 
 bool Scalar::operator!=(const Scalar& other) const {
-    return !(secp256k1_scalar_eq(reinterpret_cast<const secp256k1_scalar *>(value_), reinterpret_cast<const secp256k1_scalar *>(other.value_)));
+    return !(secp256k1_scalar_eq(as_scalar(value_), as_scalar(other.value_)));
 }
 
 const void * Scalar::get_value() const {
@@ -129,25 +124,25 @@ const void * Scalar::get_value() const {
 
 Scalar Scalar::inverse() const {
     secp256k1_scalar result;
-    secp256k1_scalar_inverse(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_inverse(&result, as_scalar(value_));
  return &result;
 }
 
 Scalar Scalar::negate() const {
     secp256k1_scalar result;
-    secp256k1_scalar_negate(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_negate(&result, as_scalar(value_));
     return &result;
 }
 
 Scalar Scalar::square() const{
     secp256k1_scalar result;
-    secp256k1_scalar_sqr(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_sqr(&result, as_scalar(value_));
  return &result;
 }
 
 Scalar Scalar::exponent(const Scalar& exp) const {
-    secp256k1_scalar value(*reinterpret_cast<const secp256k1_scalar *>(value_));
-    secp256k1_scalar exp_(*reinterpret_cast<const secp256k1_scalar *>(exp.value_));
+    secp256k1_scalar value(*as_scalar(value_));
+    secp256k1_scalar exp_(*as_scalar(exp.value_));
     secp256k1_scalar result;
 
     secp256k1_scalar_set_int(&result, 1);
@@ -182,7 +177,7 @@ bool Scalar::isMember() const {
 }
 
 bool Scalar::isZero() const {
-    return secp256k1_scalar_is_zero(reinterpret_cast<const secp256k1_scalar *>(value_));
+    return secp256k1_scalar_is_zero(as_scalar(value_));
 }
 
 Scalar& Scalar::memberFromSeed(unsigned char* seed) {
@@ -214,11 +209,11 @@ Scalar& Scalar::randomize() {
 Scalar& Scalar::generate(unsigned char* buff) {
     secp256k1_scalar zero, result;
 
-    secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), buff, nullptr);
+    secp256k1_scalar_set_b32(as_scalar(value_), buff, nullptr);
     secp256k1_scalar_set_int(&zero, 0);
 
-    secp256k1_scalar_add(&result, reinterpret_cast<const secp256k1_scalar *>(value_), &zero);
-    *reinterpret_cast<secp256k1_scalar *>(value_) = result;
+    secp256k1_scalar_add(&result, as_scalar(value_), &zero);
+    *as_scalar(value_) = result;
 
     return *this;
 }
@@ -227,8 +222,8 @@ Scalar& Scalar::mod_p() {
     secp256k1_scalar zero, result;
 
     secp256k1_scalar_clear(&zero);
-    secp256k1_scalar_add(&result, reinterpret_cast<const secp256k1_scalar *>(value_), &zero);
-    *reinterpret_cast<secp256k1_scalar *>(value_) = result;
+    secp256k1_scalar_add(&result, as_scalar(value_), &zero);
+    *as_scalar(value_) = result;
 
     return *this;
 }
@@ -257,7 +252,7 @@ std::string Scalar::tostring() const {
     unsigned char buffer[32];
     std::stringstream ss;
 
-    secp256k1_scalar_get_b32(buffer, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_get_b32(buffer, as_scalar(value_));
 
     for (int i = 0; i < 32; ++i) {
         ss << (int)buffer[i];
@@ -267,14 +262,14 @@ std::string Scalar::tostring() const {
 }
 
 unsigned char* Scalar::serialize(unsigned char* buffer) const {
-    secp256k1_scalar_get_b32(buffer, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_get_b32(buffer, as_scalar(value_));
     return buffer + 32;
 }
 
 unsigned const char* Scalar::deserialize(unsigned const char* buffer) {
     int overflow = 0;
 
-    secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), buffer, &overflow);
+    secp256k1_scalar_set_b32(as_scalar(value_), buffer, &overflow);
 
     if (overflow) {
         throw "Scalar: decoding overflowed";
@@ -285,7 +280,7 @@ unsigned const char* Scalar::deserialize(unsigned const char* buffer) {
 
 std::string Scalar::GetHex() const {
     std::array<unsigned char, 32> buffer;
-    secp256k1_scalar_get_b32(buffer.data(), reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_get_b32(buffer.data(), as_scalar(value_));
 
     std::stringstream ss;
     ss << std::hex;
@@ -316,7 +311,7 @@ void Scalar::SetHex(const std::string& str) {
 
     int overflow = 0;
 
-    secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), buffer.data(), &overflow);
+    secp256k1_scalar_set_b32(as_scalar(value_), buffer.data(), &overflow);
 
     if (overflow) {
         throw "Scalar: decoding overflowed";
@@ -326,7 +321,7 @@ void Scalar::SetHex(const std::string& str) {
 void Scalar::get_bits(std::vector<bool>& bits) const {
     unsigned char bin[32];
 
-    secp256k1_scalar_get_b32(bin, reinterpret_cast<const secp256k1_scalar *>(value_));
+    secp256k1_scalar_get_b32(bin, as_scalar(value_));
 
     for (int i = 0; i < 32; ++i) {
         int32_t val = bin[i];
@@ -18,6 +18,7 @@
 #include "primitives/zerocoin.h"
 
 
+#include <array>
 #include <atomic>
 #include <sstream>
 #include <chrono>
@@ -733,18 +734,57 @@ bool BuildSigmaStateFromIndex(CChain *chain) {
     return true;
 }
 
+bool BuildSigmaStateFromSnapshot(CChain *chain) {
+    CSigmaStateSnapshot snapshot;
+    if (!pblocktree->ReadSigmaStateSnapshot(snapshot) || snapshot.nVersion != CSigmaStateSnapshot::CURRENT_VERSION) {
+        LogPrintf("BuildSigmaStateFromSnapshot: no usable sigma state snapshot, rebuilding from index\n");
+        return BuildSigmaStateFromIndex(chain);
+    }
+
+    if (!sigmaState.ApplySnapshot(chain, snapshot)) {
+        LogPrintf("BuildSigmaStateFromSnapshot: snapshot at %s is not in the active chain, rebuilding from index\n",
+            snapshot.blockHash.ToString());
+        sigmaState.Reset();
+        return BuildSigmaStateFromIndex(chain);
+    }
+
+    int nReplayed = 0;
+    for (CBlockIndex *blockIndex = chain->Next((*chain)[snapshot.nHeight]); blockIndex; blockIndex = chain->Next(blockIndex)) {
+        sigmaState.AddBlock(blockIndex);
+        nReplayed++;
+    }
+
+    LogPrintf("BuildSigmaStateFromSnapshot: loaded snapshot at height %d, replayed %d blocks\n",
+        snapshot.nHeight, nReplayed);
+    return true;
+}
+
+bool WriteSigmaStateSnapshot(const CBlockIndex *tip) {
+    CSigmaStateSnapshot snapshot;
+    sigmaState.GetSnapshot(tip, snapshot);
+    return pblocktree->WriteSigmaStateSnapshot(snapshot);
+}
+
 // CZerocoinTxInfoV3
 
 void CSigmaTxInfo::Complete() {
     // We need to sort mints lexicographically by serialized value of pubCoin. That's the way old code
-    // works, we need to stick to it. Denomination doesn't matter but we will sort by it as well
-    sort(mints.begin(), mints.end(),
-            [](decltype(mints)::const_reference m1, decltype(mints)::const_reference m2)->bool {
-            CDataStream ds1(SER_DISK, CLIENT_VERSION), ds2(SER_DISK, CLIENT_VERSION);
-            ds1 << m1;
-            ds2 << m2;
-            return ds1.str() < ds2.str();
-            });
+    // works, we need to stick to it. Denomination doesn't matter but we will sort by it as well.
+    // Canonical bytes of every coin are computed once instead of serializing on each comparison
+    typedef std::array<unsigned char, sigma::PublicCoin::canonicalSize> SortKey;
+    std::vector<std::pair<SortKey, std::size_t>> keys(mints.size());
+    for (std::size_t i = 0; i < mints.size(); i++) {
+        mints[i].getCanonicalBytes(keys[i].first.data());
+        keys[i].second = i;
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<sigma::PublicCoin> sortedMints;
+    sortedMints.reserve(mints.size());
+    for (const auto& key : keys)
+        sortedMints.push_back(std::move(mints[key.second]));
+    mints.swap(sortedMints);
 
     // Mark this info as complete
     fInfoIsComplete = true;
@@ -1020,6 +1060,22 @@ bool CSigmaState::HasCoinHash(GroupElement &pubCoinValue, const uint256 &pubCoin
     return false;
 }
 
+size_t CSigmaState::GetCoinsByHash(const std::set<uint256> &pubCoinValueHashes, std::map<uint256, sigma::PublicCoin> &coins_out) const {
+    coins_out.clear();
+    if (pubCoinValueHashes.empty())
+        return 0;
+
+    for (const auto &mint : GetMints()) {
+        const uint256 &hash = mint.first.getValueHash();
+        if (pubCoinValueHashes.count(hash)) {
+            coins_out.insert(std::make_pair(hash, mint.first));
+            if (coins_out.size() == pubCoinValueHashes.size())
+                break;
+        }
+    }
+    return coins_out.size();
+}
+
 int CSigmaState::GetCoinSetForSpend(
         CChain *chain,
         int maxHeight,
@@ -1129,6 +1185,61 @@ void CSigmaState::Reset() {
     containers.Reset();
 }
 
+void CSigmaState::GetSnapshot(const CBlockIndex *tip, CSigmaStateSnapshot &snapshot) const {
+    snapshot = CSigmaStateSnapshot();
+    snapshot.blockHash = tip->GetBlockHash();
+    snapshot.nHeight = tip->nHeight;
+
+    snapshot.coinGroups.reserve(coinGroups.size());
+    for (const auto &group : coinGroups) {
+        CSigmaStateSnapshot::CoinGroup entry;
+        entry.denomination = group.first.first;
+        entry.id = group.first.second;
+        entry.firstBlockHeight = group.second.firstBlock->nHeight;
+        entry.lastBlockHeight = group.second.lastBlock->nHeight;
+        entry.nCoins = group.second.nCoins;
+        snapshot.coinGroups.push_back(entry);
+    }
+
+    snapshot.latestCoinIds.reserve(latestCoinIds.size());
+    for (const auto &latestCoinId : latestCoinIds)
+        snapshot.latestCoinIds.emplace_back(int64_t(latestCoinId.first), latestCoinId.second);
+    snapshot.mints.assign(GetMints().begin(), GetMints().end());
+    snapshot.spends.assign(GetSpends().begin(), GetSpends().end());
+}
+
+bool CSigmaState::ApplySnapshot(CChain *chain, const CSigmaStateSnapshot &snapshot) {
+    CBlockIndex *snapshotBlock = (*chain)[snapshot.nHeight];
+    if (!snapshotBlock || snapshotBlock->GetBlockHash() != snapshot.blockHash)
+        return false;
+
+    Reset();
+
+    for (const auto &entry : snapshot.coinGroups) {
+        SigmaCoinGroupInfo &coinGroup = coinGroups[std::make_pair(entry.denomination, entry.id)];
+        coinGroup.firstBlock = (*chain)[entry.firstBlockHeight];
+        coinGroup.lastBlock = (*chain)[entry.lastBlockHeight];
+        coinGroup.nCoins = entry.nCoins;
+
+        if (!coinGroup.firstBlock || !coinGroup.lastBlock || entry.lastBlockHeight > snapshot.nHeight) {
+            Reset();
+            return false;
+        }
+    }
+
+    for (const auto &latestCoinId : snapshot.latestCoinIds)
+        latestCoinIds[CoinDenomination(latestCoinId.first)] = latestCoinId.second;
+
+    // Add all the mints before spends so surge detection doesn't see spends without mints
+    for (const auto &mint : snapshot.mints)
+        containers.AddMint(mint.first, mint.second);
+
+    for (const auto &spend : snapshot.spends)
+        containers.AddSpend(spend.first, spend.second);
+
+    return true;
+}
+
 CSigmaState* CSigmaState::GetState() {
     return &sigmaState;
 }
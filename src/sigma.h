@@ -84,9 +84,77 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 
 bool BuildSigmaStateFromIndex(CChain *chain);
 
+/*
+ * Restore sigma state from the snapshot stored in the block tree database and replay only
+ * the blocks connected after it. Falls back to BuildSigmaStateFromIndex() if there is no
+ * usable snapshot
+ */
+bool BuildSigmaStateFromSnapshot(CChain *chain);
+
+// Store snapshot of the current sigma state for the given chain tip
+bool WriteSigmaStateSnapshot(const CBlockIndex *tip);
+
 Scalar GetSigmaSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 CAmount GetSigmaSpendInput(const CTransaction &tx);
 
+/*
+ * On-disk image of CSigmaState at a given block, so that startup only replays the blocks after it
+ * instead of rebuilding the state from the whole chain. The mints and spends of every block stay
+ * in CBlockIndex, where GetCoinSetForSpend and RemoveBlock read them. Coin groups refer to blocks
+ * by height as all of them are ancestors of the snapshot block. Denominations are stored as int64,
+ * as in CMintedCoinInfo and CSpendCoinInfo
+ */
+class CSigmaStateSnapshot {
+public:
+    static const int CURRENT_VERSION = 2;
+
+    struct CoinGroup {
+        CoinDenomination denomination;
+        int id;
+        int firstBlockHeight;
+        int lastBlockHeight;
+        int nCoins;
+
+        ADD_SERIALIZE_METHODS;
+
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action) {
+            int64_t denom = int64_t(denomination);
+            READWRITE(denom);
+            denomination = CoinDenomination(denom);
+            READWRITE(id);
+            READWRITE(firstBlockHeight);
+            READWRITE(lastBlockHeight);
+            READWRITE(nCoins);
+        }
+    };
+
+    int nVersion;
+    uint256 blockHash;
+    int nHeight;
+    std::vector<CoinGroup> coinGroups;
+    std::vector<std::pair<int64_t, int>> latestCoinIds;
+    std::vector<std::pair<sigma::PublicCoin, CMintedCoinInfo>> mints;
+    std::vector<std::pair<Scalar, CSpendCoinInfo>> spends;
+
+    CSigmaStateSnapshot() : nVersion(CURRENT_VERSION), nHeight(-1) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nVersion);
+        if (nVersion != CURRENT_VERSION)
+            return;
+        READWRITE(blockHash);
+        READWRITE(nHeight);
+        READWRITE(coinGroups);
+        READWRITE(latestCoinIds);
+        READWRITE(mints);
+        READWRITE(spends);
+    }
+};
+
 /*
  * State of minted/spent coins as extracted from the index
  */
@@ -140,6 +208,9 @@ public:
     bool HasCoin(const sigma::PublicCoin& pubCoin);
     // Query if there is a coin with given hash of a pubCoin value. If so, store preimage in pubCoin param
     bool HasCoinHash(GroupElement &pubCoinValue, const uint256 &pubCoinValueHash);
+    // Same as HasCoinHash but for many hashes at once, in a single pass over the minted coins.
+    // Returns number of coins found
+    size_t GetCoinsByHash(const std::set<uint256> &pubCoinValueHashes, std::map<uint256, sigma::PublicCoin> &coins_out) const;
 
     // Given denomination and id returns latest accumulator value and corresponding block hash
     // Do not take into account coins with height more than maxHeight
@@ -158,6 +229,12 @@ public:
     // Reset to initial values
     void Reset();
 
+    // Fill snapshot with the current state, tip is the last block added to the state
+    void GetSnapshot(const CBlockIndex *tip, CSigmaStateSnapshot &snapshot) const;
+
+    // Replace current state with the snapshot. Snapshot block should be in the chain
+    bool ApplySnapshot(CChain *chain, const CSigmaStateSnapshot &snapshot);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool CanAddSpendToMempool(const Scalar& coinSerial);
 
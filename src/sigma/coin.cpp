@@ -1,6 +1,7 @@
 #include "coin.h"
 #include "util.h"
 #include "amount.h"
+#include "hash.h"
 
 #include <openssl/rand.h>
 #include <sstream>
@@ -168,6 +169,8 @@ PublicCoin::PublicCoin(const GroupElement& coin, const CoinDenomination d)
     : value(coin)
     , denomination(d)
 {
+    // coins are compared, hashed and serialized many times, pay the inversion once
+    value.normalize();
 }
 
 const GroupElement& PublicCoin::getValue() const{
@@ -175,11 +178,20 @@ const GroupElement& PublicCoin::getValue() const{
 }
 
 uint256 const & PublicCoin::getValueHash() const {
-    if(valueHash.IsNull())
-        valueHash = primitives::GetPubCoinValueHash(value);
+    if(valueHash.IsNull()) {
+        // same bytes as primitives::GetPubCoinValueHash() but without a stream allocation
+        unsigned char buffer[GroupElement::serialize_size];
+        value.serialize(buffer);
+        valueHash = Hash(buffer, buffer + sizeof(buffer));
+    }
     return valueHash;
 }
 
+void PublicCoin::getCanonicalBytes(unsigned char* buffer) const {
+    value.serialize(buffer);
+    buffer[GroupElement::serialize_size] = static_cast<unsigned char>(denomination);
+}
+
 
 CoinDenomination PublicCoin::getDenomination() const {
     return denomination;
@@ -38,6 +38,9 @@ void GetAllDenoms(std::vector<sigma::CoinDenomination>& denominations_out);
 
 class PublicCoin {
 public:
+    // Size of the canonical byte form: serialized value followed by the denomination
+    static constexpr std::size_t canonicalSize = GroupElement::serialize_size + 1;
+
     PublicCoin();
 
     PublicCoin(const GroupElement& coin, const CoinDenomination d);
@@ -46,6 +49,10 @@ public:
     CoinDenomination getDenomination() const;
     uint256 const & getValueHash() const;
 
+    // Write canonical byte form into buffer of canonicalSize bytes. Comparing these
+    // lexicographically gives the same order as comparing serialized coins
+    void getCanonicalBytes(unsigned char* buffer) const;
+
     bool operator==(const PublicCoin& other) const;
     bool operator!=(const PublicCoin& other) const;
     bool validate() const;
@@ -69,6 +76,7 @@ public:
         s.read(b, size + sizeof(int32_t));
         value.deserialize(buffer);
         std::memcpy(&denomination, buffer + size, sizeof(denomination));
+        valueHash.SetNull();
     }
 
 private:
@@ -29,6 +29,8 @@ CoinSpend::CoinSpend(
         params->get_m());
     //compute inverse of g^s
     GroupElement gs = (params->get_g() * coinSerialNumber).inverse();
+    // affine, so adding it to each coin is a mixed addition
+    gs.normalize();
     std::vector<GroupElement> C_;
     C_.reserve(anonymity_set.size());
     std::size_t coinIndex = SIZE_MAX;
@@ -101,6 +103,8 @@ bool CoinSpend::Verify(
     SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
     //compute inverse of g^s
     GroupElement gs = (params->get_g() * coinSerialNumber).inverse();
+    // affine, so adding it to each coin is a mixed addition
+    gs.normalize();
     std::vector<GroupElement> C_;
     C_.reserve(anonymity_set.size());
     for(std::size_t j = 0; j < anonymity_set.size(); ++j)
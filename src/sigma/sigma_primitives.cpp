@@ -0,0 +1,46 @@
+#include "sigma_primitives.h"
+
+#include "../ctpl.h"
+#include "../util.h"
+
+#include <future>
+
+namespace sigma {
+
+/**
+ * Runs the parts of the multiexps of provers and verifiers alike, so that its threads start once.
+ * Never destroyed, the idle threads do not keep the process from exiting. Nothing run on it waits
+ * for other tasks of it, so callers may be on other pools, like the one of the wallet's provers.
+ */
+static ctpl::thread_pool& GetMultiExpPool()
+{
+    static ctpl::thread_pool* pool = []() {
+        ctpl::thread_pool* newPool = new ctpl::thread_pool(std::max(1, GetNumCores()));
+        RenameThreadPool(*newPool, "sigma-multiexp");
+        return newPool;
+    }();
+    return *pool;
+}
+
+secp_primitives::GroupElement get_multiple_parallel(const secp_primitives::MultiExponent& mult)
+{
+    int nThreads = std::max(1, GetNumCores());
+    if (nThreads < 2) {
+        return mult.get_multiple();
+    }
+
+    secp_primitives::MultiExponent::TaskRunner runner = [](const std::vector<std::function<void()>>& tasks) {
+        ctpl::thread_pool& workerPool = GetMultiExpPool();
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks.size());
+        for (const auto& task : tasks) {
+            futures.push_back(workerPool.push([&task](int) { task(); }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    };
+    return mult.get_multiple(runner, nThreads);
+}
+
+} // namespace sigma
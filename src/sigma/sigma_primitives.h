@@ -6,6 +6,7 @@
 #include "../secp256k1/include/Scalar.h"
 
 #include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace sigma {
@@ -34,8 +35,30 @@ public:
      */
     static void new_factor(const Exponent& x, const Exponent& a, std::vector<Exponent>& coefficients);
 
+    /** \brief Computes \prod_{j=0}^{m-1} f_{j,i_j} for every index i in [0, count), i_j being the n-ary digits of i.
+     *  Products of the higher digits are shared by all indices having them, so this takes about count * n / (n - 1)
+     *  multiplications and no allocation besides the output.
+     *  \param[out] products_out Resized to count.
+     */
+    static void compute_digit_products(
+            const std::vector<Exponent>& f, int n, int m, std::size_t count, std::vector<Exponent>& products_out);
+
+    /** \brief Computes the coefficients of \prod_{j=0}^{m-1} (x_{j,i_j} X + a_{j,i_j}) for every index i in [0, count)
+     *  the same way as compute_digit_products().
+     *  \param[out] coefficients_out Coefficients of polynomial i are at [i * (m + 1), (i + 1) * (m + 1)), lowest degree
+     *  first. Must have room for count polynomials, others are left as they are.
+     */
+    static void compute_digit_polynomials(
+            const std::vector<Exponent>& x, const std::vector<Exponent>& a, int n, int m, std::size_t count,
+            std::vector<Exponent>& coefficients_out);
+
     };
 
+/** \brief Same as mult.get_multiple(), split between the threads of a pool shared by all proofs
+ *  when there are enough points for it to pay off, as for full anonymity sets.
+ */
+secp_primitives::GroupElement get_multiple_parallel(const secp_primitives::MultiExponent& mult);
+
 } // namespace sigma
 
 #include "sigma_primitives.hpp"
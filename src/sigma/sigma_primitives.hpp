@@ -8,7 +8,7 @@ void SigmaPrimitives<Exponent, GroupElement>::commit(const GroupElement& g,
         const std::vector<Exponent>& exp,
         const Exponent& r,
         GroupElement& result_out) {
-    secp_primitives::MultiExponent mult(h, exp);
+    secp_primitives::MultiExponent mult(h.data(), exp.data(), h.size());
     result_out += g * r + mult.get_multiple();
 }
 
@@ -68,11 +68,14 @@ void SigmaPrimitives<Exponent, GroupElement>::generate_challenge(
         Exponent& result_out) {
     if (group_elements.empty())
         throw std::runtime_error("Group elements empty while generating a challenge.");
+    // serialization needs affine points, convert them all with a single inversion
+    std::vector<GroupElement> normalized(group_elements);
+    GroupElement::normalize_batch(normalized);
     CSHA256 hash;
-    std::vector<unsigned char> data(group_elements.size() * group_elements[0].memoryRequired());
+    std::vector<unsigned char> data(normalized.size() * normalized[0].memoryRequired());
     unsigned char* current = data.data();
-    for (size_t i = 0; i < group_elements.size(); ++i) {
-        current = group_elements[i].serialize(current);
+    for (size_t i = 0; i < normalized.size(); ++i) {
+        current = normalized[i].serialize(current);
     }
     hash.Write(data.data(), data.size());
     unsigned char result_data[CSHA256::OUTPUT_SIZE];
@@ -80,6 +83,86 @@ void SigmaPrimitives<Exponent, GroupElement>::generate_challenge(
     result_out = result_data;
 }
 
+template<class Exponent, class GroupElement>
+void SigmaPrimitives<Exponent, GroupElement>::compute_digit_products(
+        const std::vector<Exponent>& f,
+        int n,
+        int m,
+        std::size_t count,
+        std::vector<Exponent>& products_out) {
+    products_out.resize(count);
+    if (count == 0)
+        return;
+
+    // Layer by layer from the most significant digit, entry k of a layer is the product for the higher digits k.
+    // Entry k becomes entries k*n..k*n+n-1 of the next layer, which only overwrites entries above k that were
+    // expanded already, so going down from the last entry the layers can share the output vector.
+    std::vector<std::size_t> layer_size(m + 1);
+    layer_size[0] = count;
+    for (int j = 1; j <= m; ++j)
+        layer_size[j] = (layer_size[j - 1] + n - 1) / n;
+
+    // Digits above the m-th are ignored, as with convert_to_nal()
+    std::fill(products_out.begin(), products_out.begin() + layer_size[m], Exponent(uint64_t(1)));
+    for (int j = m - 1; j >= 0; --j) {
+        const std::size_t size = layer_size[j + 1];
+        const std::size_t next_size = layer_size[j];
+        for (std::size_t k = size; k-- > 0;) {
+            const Exponent prefix = products_out[k];
+            for (int d = n - 1; d >= 0; --d) {
+                std::size_t index = k * n + d;
+                if (index < next_size)
+                    products_out[index] = prefix * f[j * n + d];
+            }
+        }
+    }
+}
+
+template<class Exponent, class GroupElement>
+void SigmaPrimitives<Exponent, GroupElement>::compute_digit_polynomials(
+        const std::vector<Exponent>& x,
+        const std::vector<Exponent>& a,
+        int n,
+        int m,
+        std::size_t count,
+        std::vector<Exponent>& coefficients_out) {
+    if (count == 0)
+        return;
+
+    const std::size_t stride = m + 1;
+    assert(coefficients_out.size() >= count * stride);
+
+    std::vector<std::size_t> layer_size(m + 1);
+    layer_size[0] = count;
+    for (int j = 1; j <= m; ++j)
+        layer_size[j] = (layer_size[j - 1] + n - 1) / n;
+
+    // Same layering as compute_digit_products(), with polynomials gaining a degree per layer.
+    std::vector<Exponent> prefix(stride);
+    for (std::size_t k = 0; k < layer_size[m]; ++k)
+        coefficients_out[k * stride] = Exponent(uint64_t(1));
+    for (int j = m - 1; j >= 0; --j) {
+        const std::size_t degree = m - 1 - j;
+        const std::size_t size = layer_size[j + 1];
+        const std::size_t next_size = layer_size[j];
+        for (std::size_t k = size; k-- > 0;) {
+            std::copy(coefficients_out.begin() + k * stride, coefficients_out.begin() + k * stride + degree + 1, prefix.begin());
+            for (int d = n - 1; d >= 0; --d) {
+                std::size_t index = k * n + d;
+                if (index >= next_size)
+                    continue;
+                const Exponent& xd = x[j * n + d];
+                const Exponent& ad = a[j * n + d];
+                auto out = coefficients_out.begin() + index * stride;
+                out[degree + 1] = xd * prefix[degree];
+                for (std::size_t e = degree; e >= 1; --e)
+                    out[e] = ad * prefix[e] + xd * prefix[e - 1];
+                out[0] = ad * prefix[0];
+            }
+        }
+    }
+}
+
 template<class Exponent, class GroupElement>
 void SigmaPrimitives<Exponent, GroupElement>::new_factor(
         const Exponent& x,
@@ -42,20 +42,13 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
     r1prover.proof(a, proof_out.r1Proof_, true /*Skip generation of final response*/);
 
     // Compute coefficients of Polynomials P_I(x), for all I from [0..N].
+    // Polynomial I has m+1 coefficients starting at P_i_k[I * (m+1)].
     std::size_t N = setSize;
-    std::vector <std::vector<Exponent>> P_i_k;
-    P_i_k.resize(N);
+    const std::size_t P_stride = m_ + 1;
+    std::vector<Exponent> P_i_k(N * P_stride);
 
     // last polynomial is special case if fPadding is true
-    for (std::size_t i = 0; i < (fPadding ? N-1 : N); ++i) {
-        std::vector<Exponent>& coefficients = P_i_k[i];
-        std::vector<uint64_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n_, m_);
-        coefficients.push_back(a[I[0]]);
-        coefficients.push_back(sigma[I[0]]);
-        for (int j = 1; j < m_; ++j) {
-            SigmaPrimitives<Exponent, GroupElement>::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
-        }
-    }
+    SigmaPrimitives<Exponent, GroupElement>::compute_digit_polynomials(sigma, a, n_, m_, fPadding ? N-1 : N, P_i_k);
 
     if (fPadding) {
         /*
@@ -105,7 +98,7 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
                 p_i_sum[j + k] += polynomial[k];
         }
 
-        P_i_k[N-1] = p_i_sum;
+        std::copy(p_i_sum.begin(), p_i_sum.end(), P_i_k.begin() + (N-1) * P_stride);
     }
 
     //computing G_k`s;
@@ -115,10 +108,10 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
         std::vector <Exponent> P_i;
         P_i.reserve(N);
         for (size_t i = 0; i < N; ++i) {
-            P_i.emplace_back(P_i_k[i][k]);
+            P_i.emplace_back(P_i_k[i * P_stride + k]);
         }
-        secp_primitives::MultiExponent mult(commits, P_i);
-        GroupElement c_k = mult.get_multiple();
+        secp_primitives::MultiExponent mult(commits.data(), P_i.data(), commits.size());
+        GroupElement c_k = get_multiple_parallel(mult);
         c_k += SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], Pk[k]);
         Gk.emplace_back(c_k);
     }
@@ -68,14 +68,7 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
     f_i_.reserve(N);
 
     // if fPadding is true last index is special
-    for (std::size_t i = 0; i < (fPadding ? N-1 : N); ++i) {
-        std::vector<uint64_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n, m);
-        Exponent f_i(uint64_t(1));
-        for(int j = 0; j < m; ++j){
-            f_i *= f[j*n + I[j]];
-        }
-        f_i_.emplace_back(f_i);
-    }
+    SigmaPrimitives<Exponent, GroupElement>::compute_digit_products(f, n, m, fPadding ? N-1 : N, f_i_);
 
     if (fPadding) {
         /*
@@ -112,8 +105,8 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::verify(
         f_i_.emplace_back(pow);
     }
 
-    secp_primitives::MultiExponent mult(commits, f_i_);
-    GroupElement t1 = mult.get_multiple();
+    secp_primitives::MultiExponent mult(commits.data(), f_i_.data(), commits.size());
+    GroupElement t1 = get_multiple_parallel(mult);
 
     GroupElement t2;
     Exponent x_k(uint64_t(1));
@@ -25,6 +25,20 @@ BOOST_AUTO_TEST_CASE(pubcoin_serialization)
     BOOST_CHECK(pubcoin == deserialized);
 }
 
+BOOST_AUTO_TEST_CASE(params_generators)
+{
+    // The generators are consensus critical, every existing proof was made with them
+    auto params = sigma::Params::get_default();
+
+    BOOST_CHECK_EQUAL(params->get_g().GetHex(),
+        "(d75bfd6797e108484944bf16246ecbac54cf25d39c537ba91aced24f70fcc238,188d9e4b0f5e4d6c8c02bb314342d61a64b6ecc69d6c109ab04aad8bf7bf6d7d)");
+    BOOST_CHECK_EQUAL(params->get_h0().GetHex(),
+        "(b0f4cdec32c98273766898efb79b61c1d96e1be153b577d79c3974c9d9e8fa31,470492a93d78165331da216906ea9cbdb99b448ea65f7a0aa7f505a8a2f9bba2)");
+    BOOST_CHECK_EQUAL(params->get_h().size(), 28);
+    BOOST_CHECK_EQUAL(params->get_h().back().GetHex(),
+        "(8b6b1c4a07dcf5c2c126f2c3c356bc1ab593b879e8776bc64c1e70cc75b5534f,fcecfc8d9af5b5df12581eee768c6295c26126f6ec2572dcda46c899ebf1cc3a)");
+}
+
 BOOST_AUTO_TEST_CASE(pubcoin_validate)
 {
     auto params = sigma::Params::get_default();
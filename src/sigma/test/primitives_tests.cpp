@@ -169,4 +169,57 @@ BOOST_AUTO_TEST_CASE(commit2_homomorphic_test)
     BOOST_CHECK(t1+t2 == t3);
 }
 
+BOOST_AUTO_TEST_CASE(digit_products_test)
+{
+    typedef sigma::SigmaPrimitives<secp_primitives::Scalar,secp_primitives::GroupElement> Primitives;
+    const int n = 4;
+    const int m = 3;
+
+    std::vector<secp_primitives::Scalar> f(n * m), x(n * m), a(n * m);
+    for (int i = 0; i < n * m; ++i) {
+        f[i].randomize();
+        a[i].randomize();
+        x[i] = uint64_t(i % n == 1 ? 1 : 0);
+    }
+
+    // full and partial sets
+    for (std::size_t count : {std::size_t(1), std::size_t(37), std::size_t(64)}) {
+        std::vector<secp_primitives::Scalar> products;
+        Primitives::compute_digit_products(f, n, m, count, products);
+        BOOST_CHECK_EQUAL(products.size(), count);
+
+        std::vector<secp_primitives::Scalar> polynomials(count * (m + 1));
+        Primitives::compute_digit_polynomials(x, a, n, m, count, polynomials);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            std::vector<uint64_t> I = Primitives::convert_to_nal(i, n, m);
+
+            secp_primitives::Scalar expected(uint64_t(1));
+            for (int j = 0; j < m; ++j)
+                expected *= f[j * n + I[j]];
+            BOOST_CHECK(products[i] == expected);
+
+            std::vector<secp_primitives::Scalar> coefficients = {a[I[0]], x[I[0]]};
+            for (int j = 1; j < m; ++j)
+                Primitives::new_factor(x[j * n + I[j]], a[j * n + I[j]], coefficients);
+            for (int k = 0; k <= m; ++k)
+                BOOST_CHECK(polynomials[i * (m + 1) + k] == coefficients[k]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(get_multiple_parallel_test)
+{
+    // large enough to be split between the threads of the pool
+    std::vector<secp_primitives::GroupElement> gens(2 * secp_primitives::MultiExponent::min_parallel_points);
+    std::vector<secp_primitives::Scalar> scalars(gens.size());
+    for (size_t i = 0; i < gens.size(); ++i) {
+        gens[i].randomize();
+        scalars[i].randomize();
+    }
+
+    secp_primitives::MultiExponent mult(gens, scalars);
+    BOOST_CHECK(sigma::get_multiple_parallel(mult) == mult.get_multiple());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(sigma_primitive_types)
 
 BOOST_AUTO_TEST_CASE(scalar_test)
@@ -20,4 +22,39 @@ BOOST_AUTO_TEST_CASE(scalar_test)
     BOOST_CHECK(s == s2);
 }
 
+BOOST_AUTO_TEST_CASE(group_element_normalize)
+{
+    secp_primitives::GroupElement g;
+    g.randomize();
+    BOOST_CHECK(g.isNormalized());
+
+    std::vector<secp_primitives::GroupElement> points;
+    for (int i = 0; i < 10; ++i) {
+        secp_primitives::Scalar s;
+        s.randomize();
+        points.push_back(g * s);
+        BOOST_CHECK(!points.back().isNormalized());
+    }
+    points.push_back(secp_primitives::GroupElement());
+    points.push_back(g + g.inverse());
+
+    std::vector<secp_primitives::GroupElement> normalized(points);
+    secp_primitives::GroupElement::normalize_batch(normalized);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        BOOST_CHECK(normalized[i].isNormalized() != normalized[i].isInfinity());
+        BOOST_CHECK(normalized[i] == points[i]);
+        BOOST_CHECK(normalized[i].getvch() == points[i].getvch());
+        BOOST_CHECK_EQUAL(normalized[i].hash(), points[i].hash());
+
+        secp_primitives::GroupElement single(points[i]);
+        single.normalize();
+        BOOST_CHECK(single.getvch() == normalized[i].getvch());
+
+        // mixed addition gives the same sums
+        BOOST_CHECK(normalized[i] + points[0] == points[i] + points[0]);
+        BOOST_CHECK(points[0] + normalized[i] == points[i] + points[0]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+#define BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Memory resource for node based containers that allocate many small blocks
+ * of a few fixed sizes, like the nodes of std::unordered_map.
+ *
+ * Blocks up to MAX_BLOCK_SIZE_BYTES are carved out of large chunks and kept
+ * in a free list per size once deallocated; larger blocks (the bucket array)
+ * go to operator new. Memory is only given back to the system when the
+ * resource is destroyed, which also makes the memory a container uses easy
+ * to account for exactly: it is the number of chunks times their size.
+ *
+ * Not thread safe, the container using it must be protected as usual.
+ */
+template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+class PoolResource
+{
+private:
+    struct ListNode {
+        ListNode* next;
+    };
+
+    //! Blocks are multiples of this, so every block is aligned and can hold a free list link
+    static constexpr std::size_t ELEM_ALIGN_BYTES = std::max(alignof(ListNode), ALIGN_BYTES);
+    static_assert((ELEM_ALIGN_BYTES & (ELEM_ALIGN_BYTES - 1)) == 0, "alignment must be a power of two");
+    static_assert(ELEM_ALIGN_BYTES <= alignof(std::max_align_t), "operator new does not guarantee this alignment");
+
+    const std::size_t nChunkSizeBytes;
+    std::vector<char*> vChunks;
+    //! Free lists, indexed by block size in units of ELEM_ALIGN_BYTES
+    std::array<ListNode*, MAX_BLOCK_SIZE_BYTES / ELEM_ALIGN_BYTES + 1> freeLists;
+    //! The part of the newest chunk that has not been handed out yet
+    char* pAvailableBegin;
+    char* pAvailableEnd;
+
+    static std::size_t NumElemAlignBytes(std::size_t bytes)
+    {
+        return (bytes + ELEM_ALIGN_BYTES - 1) / ELEM_ALIGN_BYTES + (bytes == 0);
+    }
+
+    static bool IsPooled(std::size_t bytes, std::size_t alignment)
+    {
+        return bytes <= MAX_BLOCK_SIZE_BYTES && alignment <= ELEM_ALIGN_BYTES;
+    }
+
+    void AllocateChunk()
+    {
+        // Put what is left of the current chunk into the free list of its size so it is not lost
+        if (pAvailableBegin != pAvailableEnd) {
+            std::size_t nRemaining = (pAvailableEnd - pAvailableBegin) / ELEM_ALIGN_BYTES;
+            ListNode* node = reinterpret_cast<ListNode*>(pAvailableBegin);
+            node->next = freeLists[nRemaining];
+            freeLists[nRemaining] = node;
+        }
+
+        char* chunk = static_cast<char*>(::operator new(nChunkSizeBytes));
+        vChunks.push_back(chunk);
+        pAvailableBegin = chunk;
+        pAvailableEnd = chunk + nChunkSizeBytes;
+    }
+
+public:
+    static const std::size_t DEFAULT_CHUNK_SIZE_BYTES = 256 * 1024;
+
+    explicit PoolResource(std::size_t nChunkSizeBytesIn = DEFAULT_CHUNK_SIZE_BYTES)
+        : nChunkSizeBytes(nChunkSizeBytesIn / ELEM_ALIGN_BYTES * ELEM_ALIGN_BYTES), pAvailableBegin(nullptr), pAvailableEnd(nullptr)
+    {
+        static_assert(MAX_BLOCK_SIZE_BYTES >= ELEM_ALIGN_BYTES, "blocks must be able to hold a free list link");
+        freeLists.fill(nullptr);
+        vChunks.reserve(64);
+    }
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource()
+    {
+        for (char* chunk : vChunks)
+            ::operator delete(chunk);
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!IsPooled(bytes, alignment))
+            return ::operator new(bytes);
+
+        const std::size_t nIndex = NumElemAlignBytes(bytes);
+        if (freeLists[nIndex] != nullptr) {
+            ListNode* node = freeLists[nIndex];
+            freeLists[nIndex] = node->next;
+            return node;
+        }
+
+        const std::size_t nRoundedBytes = nIndex * ELEM_ALIGN_BYTES;
+        if (static_cast<std::size_t>(pAvailableEnd - pAvailableBegin) < nRoundedBytes)
+            AllocateChunk();
+        void* p = pAvailableBegin;
+        pAvailableBegin += nRoundedBytes;
+        return p;
+    }
+
+    void Deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!IsPooled(bytes, alignment)) {
+            ::operator delete(p);
+            return;
+        }
+
+        const std::size_t nIndex = NumElemAlignBytes(bytes);
+        ListNode* node = static_cast<ListNode*>(p);
+        node->next = freeLists[nIndex];
+        freeLists[nIndex] = node;
+    }
+
+    std::size_t NumberOfChunks() const { return vChunks.size(); }
+    std::size_t ChunkSizeBytes() const { return nChunkSizeBytes; }
+};
+
+/**
+ * Allocator handing out memory from a PoolResource, which must outlive every
+ * container using it. Containers may rebind it to their node and bucket types.
+ */
+template <typename T, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES = alignof(T)>
+class PoolAllocator
+{
+    template <typename U, std::size_t M, std::size_t A>
+    friend class PoolAllocator;
+
+public:
+    typedef T value_type;
+    typedef PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES> ResourceType;
+
+    template <typename U>
+    struct rebind {
+        typedef PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES> other;
+    };
+
+    PoolAllocator(ResourceType* resourceIn) noexcept : resource(resourceIn) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) noexcept : resource(other.resource) {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ResourceType* GetResource() const noexcept { return resource; }
+
+private:
+    ResourceType* resource;
+};
+
+template <typename T, typename U, std::size_t M, std::size_t A>
+bool operator==(const PoolAllocator<T, M, A>& a, const PoolAllocator<U, M, A>& b) noexcept
+{
+    return a.GetResource() == b.GetResource();
+}
+
+template <typename T, typename U, std::size_t M, std::size_t A>
+bool operator!=(const PoolAllocator<T, M, A>& a, const PoolAllocator<U, M, A>& b) noexcept
+{
+    return !(a == b);
+}
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_POOL_H
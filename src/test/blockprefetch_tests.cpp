@@ -0,0 +1,85 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockprefetch.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "validation.h"
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockprefetch_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(prefetch_forward)
+{
+    LOCK(cs_main);
+
+    std::vector<uint256> hashesRead;
+    CBlockPrefetcher prefetcher(Params().GetConsensus(), chainActive.Genesis(), [](const CBlockIndex* pindexPrev) { return chainActive.Next(pindexPrev); },
+        "test-prefetch", 2, false, [](CPrefetchedBlock& prefetchedBlock) {
+            prefetchedBlock.vTxFlags.assign(prefetchedBlock.block->vtx.size(), true);
+        });
+    BOOST_CHECK_EQUAL(prefetcher.GetThreads(), 2);
+
+    int nHeight = 0;
+    while (std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher.Next()) {
+        BOOST_CHECK(prefetchedBlock->pindex == chainActive[nHeight]);
+        BOOST_CHECK(prefetchedBlock->fRead);
+        BOOST_CHECK(prefetchedBlock->block->GetHash() == chainActive[nHeight]->GetBlockHash());
+        BOOST_CHECK_EQUAL(prefetchedBlock->vTxFlags.size(), prefetchedBlock->block->vtx.size());
+        BOOST_CHECK(!prefetchedBlock->fUndoRead);
+        nHeight++;
+    }
+    BOOST_CHECK_EQUAL(nHeight, chainActive.Height() + 1);
+    BOOST_CHECK(prefetcher.Peek() == NULL);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_backward_undo)
+{
+    LOCK(cs_main);
+
+    CBlockPrefetcher prefetcher(Params().GetConsensus(), chainActive.Tip(), [](const CBlockIndex* pindexPrev) -> CBlockIndex* {
+            return pindexPrev->pprev && pindexPrev->pprev->pprev ? pindexPrev->pprev : NULL;
+        }, "test-prefetch", 0, true);
+
+    CBlockIndex* pindex = chainActive.Tip();
+    while (std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher.Next()) {
+        BOOST_CHECK(prefetchedBlock->pindex == pindex);
+        BOOST_CHECK(prefetchedBlock->fRead);
+        BOOST_CHECK(prefetchedBlock->fUndoRead);
+        // every transaction but the coinbase has its spent coins in the undo data
+        BOOST_CHECK_EQUAL(prefetchedBlock->undo.vtxundo.size() + 1, prefetchedBlock->block->vtx.size());
+        pindex = pindex->pprev;
+    }
+    BOOST_CHECK(pindex == chainActive.Genesis());
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_take)
+{
+    LOCK(cs_main);
+
+    CBlockPrefetcher prefetcher(Params().GetConsensus(), chainActive[10], [](const CBlockIndex* pindexPrev) { return chainActive.Next(pindexPrev); },
+        "test-prefetch", 1);
+
+    // a block other than the next one is not handed out, nor skipped
+    BOOST_CHECK(!prefetcher.Take(chainActive[11]));
+    BOOST_CHECK(prefetcher.Peek() == chainActive[10]);
+
+    std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher.Take(chainActive[10]);
+    BOOST_CHECK(prefetchedBlock && prefetchedBlock->fRead);
+    BOOST_CHECK(prefetcher.Peek() == chainActive[11]);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_empty)
+{
+    LOCK(cs_main);
+
+    CBlockPrefetcher prefetcher(Params().GetConsensus(), NULL, [](const CBlockIndex* pindexPrev) { return chainActive.Next(pindexPrev); },
+        "test-prefetch", 1);
+    BOOST_CHECK(prefetcher.Peek() == NULL);
+    BOOST_CHECK(!prefetcher.Next());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -210,6 +210,27 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Random)
 }
 
 
+/** Test that checks are all run when workers have to share deques */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Shared_Slots)
+{
+    auto queue = std::unique_ptr<Correct_Queue>(new Correct_Queue {QUEUE_BATCH_SIZE, 2});
+    boost::thread_group tg;
+    for (auto x = 0; x < nScriptCheckThreads; ++x) {
+       tg.create_thread([&]{queue->Thread();});
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        FakeCheckCheckCompletion::n_calls = 0;
+        {
+            CCheckQueueControl<FakeCheckCheckCompletion> control(queue.get());
+            std::vector<FakeCheckCheckCompletion> vChecks(i * 10);
+            control.Add(vChecks);
+        }
+        BOOST_REQUIRE_EQUAL(FakeCheckCheckCompletion::n_calls, i * 10);
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
 /** Test that failing checks are caught */
 BOOST_AUTO_TEST_CASE(test_CheckQueue_Catches_Failure)
 {
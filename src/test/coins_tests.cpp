@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "coins.h"
+#include "txdb.h"
 #include "script/standard.h"
 #include "uint256.h"
 #include "undo.h"
@@ -579,7 +580,8 @@ void GetCoinsMapEntry(const CCoinsMap& map, CAmount& value, char& flags)
 
 void WriteCoinsViewEntry(CCoinsView& view, CAmount value, char flags)
 {
-    CCoinsMap map;
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &resource);
     InsertCoinsMapEntry(map, value, flags);
     view.BatchWrite(map, {});
 }
@@ -848,4 +850,89 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_pool_memory)
+{
+    CCoinsView root;
+    CCoinsViewCacheTest base{&root};
+    CCoinsViewCacheTest cache{&base};
+
+    const size_t nEmptyUsage = cache.DynamicMemoryUsage();
+    for (uint32_t i = 0; i < 20000; i++) {
+        Coin coin;
+        coin.out.nValue = i + 1;
+        coin.nHeight = 1;
+        cache.AddCoin(COutPoint(GetRandHash(), i), std::move(coin), false);
+    }
+    cache.SelfTest();
+    // every node comes out of a pool chunk, so the accounting covers at least the entries themselves
+    BOOST_CHECK(cache.DynamicMemoryUsage() > 20000 * sizeof(CCoinsMap::value_type));
+
+    // freed nodes are reused by the pool rather than growing it
+    const size_t nFullUsage = cache.DynamicMemoryUsage();
+    for (CCoinsMap::iterator it = cache.map().begin(); it != cache.map().end(); ) {
+        if (it->first.n % 2 == 0) {
+            cache.usage() -= it->second.coin.DynamicMemoryUsage();
+            it = cache.map().erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (uint32_t i = 0; i < 10000; i++) {
+        Coin coin;
+        coin.out.nValue = i + 1;
+        coin.nHeight = 2;
+        cache.AddCoin(COutPoint(GetRandHash(), i), std::move(coin), false);
+    }
+    cache.SelfTest();
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), nFullUsage);
+
+    // flushing hands the memory back, and the parent is accounted the same way
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), nEmptyUsage);
+    BOOST_CHECK_EQUAL(base.GetCacheSize(), 20000U);
+    base.SelfTest();
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_flush_buffer)
+{
+    CCoinsViewDB db(1 << 20, true);
+    CCoinsViewFlushBuffer buffer(&db);
+    CCoinsViewCache cache(&buffer);
+
+    std::vector<COutPoint> outpoints;
+    for (int nFlush = 1; nFlush <= 3; nFlush++) {
+        for (uint32_t i = 0; i < 100; i++) {
+            Coin coin;
+            coin.out.nValue = i + 1;
+            coin.nHeight = nFlush;
+            outpoints.emplace_back(GetRandHash(), i);
+            cache.AddCoin(outpoints.back(), std::move(coin), false);
+        }
+        BOOST_CHECK(cache.SpendCoin(outpoints[nFlush]));
+        uint256 hashBlock = GetRandHash();
+        cache.SetBestBlock(hashBlock);
+
+        bool fAfterCalled = false;
+        BOOST_CHECK(cache.Flush());
+        BOOST_CHECK(buffer.Write(true, [&] { fAfterCalled = true; return true; }));
+
+        // whether or not the write is done, the coins are visible through the buffer
+        BOOST_CHECK(cache.GetBestBlock() == hashBlock);
+        for (size_t i = 0; i < outpoints.size(); i++)
+            BOOST_CHECK_EQUAL(cache.HaveCoin(outpoints[i]), i < 1 || i > (size_t)nFlush);
+
+        BOOST_CHECK(buffer.Wait());
+        BOOST_CHECK(fAfterCalled);
+        BOOST_CHECK(db.GetBestBlock() == hashBlock);
+    }
+
+    for (size_t i = 0; i < outpoints.size(); i++)
+        BOOST_CHECK_EQUAL(db.HaveCoin(outpoints[i]), i < 1 || i > 3);
+
+    CCoinsFlushStats stats = buffer.GetStats();
+    BOOST_CHECK_EQUAL(stats.nFlushes, 3U);
+    BOOST_CHECK_EQUAL(stats.nAsyncFlushes, 3U);
+    BOOST_CHECK(!stats.fWriting);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
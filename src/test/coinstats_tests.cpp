@@ -0,0 +1,97 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinstats.h"
+#include "coins.h"
+#include "random.h"
+#include "streams.h"
+#include "test/test_bitcoin.h"
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(coinstats_tests, BasicTestingSetup)
+
+static std::vector<unsigned char> RandomElement()
+{
+    std::vector<unsigned char> elem(32);
+    GetRandBytes(elem.data(), elem.size());
+    return elem;
+}
+
+BOOST_AUTO_TEST_CASE(muhash_order_independent)
+{
+    std::vector<std::vector<unsigned char>> elems;
+    for (int i = 0; i < 8; i++)
+        elems.push_back(RandomElement());
+
+    CMuHash3072 forward, backward;
+    for (size_t i = 0; i < elems.size(); i++) {
+        forward.Insert(elems[i].data(), elems[i].size());
+        backward.Insert(elems[elems.size() - 1 - i].data(), elems[elems.size() - 1 - i].size());
+    }
+    BOOST_CHECK(forward.Finalize() == backward.Finalize());
+    BOOST_CHECK(forward.Finalize() != CMuHash3072().Finalize());
+
+    // taking elements out in any order, even before they went in, gets back to the same set
+    CMuHash3072 partial;
+    partial.Remove(elems[0].data(), elems[0].size());
+    for (size_t i = 0; i < elems.size(); i++)
+        partial.Insert(elems[i].data(), elems[i].size());
+    partial.Insert(elems[0].data(), elems[0].size());
+    BOOST_CHECK(partial.Finalize() == forward.Finalize());
+
+    for (size_t i = 0; i < elems.size(); i++)
+        forward.Remove(elems[i].data(), elems[i].size());
+    BOOST_CHECK(forward.Finalize() == CMuHash3072().Finalize());
+
+    // combining hashes is the same as inserting into one
+    CMuHash3072 left, right;
+    for (size_t i = 0; i < elems.size(); i++)
+        (i % 2 ? left : right).Insert(elems[i].data(), elems[i].size());
+    left *= right;
+    BOOST_CHECK(left.Finalize() == backward.Finalize());
+    left /= right;
+    right *= left;
+    BOOST_CHECK(right.Finalize() == backward.Finalize());
+}
+
+BOOST_AUTO_TEST_CASE(utxostats_add_remove)
+{
+    CUTXOStats stats;
+    uint256 hashEmpty = stats.muhash.Finalize();
+
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    for (int i = 0; i < 10; i++) {
+        CTxOut out(i * COIN, CScript() << OP_TRUE);
+        coins.emplace_back(COutPoint(GetRandHash(), i), Coin(out, 100 + i, i == 0, false));
+        stats.AddCoin(coins.back().first, coins.back().second);
+    }
+    BOOST_CHECK_EQUAL(stats.nTransactionOutputs, 10U);
+    BOOST_CHECK_EQUAL(stats.nTotalAmount, 45 * COIN);
+
+    // the same coin at another height is a different element
+    CUTXOStats other = stats;
+    other.RemoveCoin(coins[1].first, coins[1].second);
+    other.AddCoin(coins[1].first, Coin(coins[1].second.out, 1, false, false));
+    BOOST_CHECK_EQUAL(other.nTotalAmount, stats.nTotalAmount);
+    BOOST_CHECK(other.muhash.Finalize() != stats.muhash.Finalize());
+
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << stats;
+    CUTXOStats read;
+    ss >> read;
+    BOOST_CHECK_EQUAL(read.nTransactionOutputs, stats.nTransactionOutputs);
+    BOOST_CHECK_EQUAL(read.nTotalAmount, stats.nTotalAmount);
+    BOOST_CHECK(read.muhash.Finalize() == stats.muhash.Finalize());
+
+    for (size_t i = coins.size(); i-- > 0;)
+        read.RemoveCoin(coins[i].first, coins[i].second);
+    BOOST_CHECK_EQUAL(read.nTransactionOutputs, 0U);
+    BOOST_CHECK_EQUAL(read.nTotalAmount, 0);
+    BOOST_CHECK(read.muhash.Finalize() == hashEmpty);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
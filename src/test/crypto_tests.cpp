@@ -9,6 +9,7 @@
 #include "crypto/sha512.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
+#include "hash.h"
 #include "random.h"
 #include "utilstrencodings.h"
 #include "test/test_bitcoin.h"
@@ -506,4 +507,31 @@ BOOST_AUTO_TEST_CASE(countbits_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d64)
+{
+    using namespace sha256_implementation;
+    const UseImplementation implementations[] = {STANDARD, USE_SSE41, USE_AVX2, USE_SHANI, USE_ALL};
+    for (UseImplementation implementation : implementations) {
+        BOOST_TEST_MESSAGE("SHA256 implementation: " << SHA256AutoDetect(implementation));
+
+        // multiple blocks per transform
+        TestSHA256(std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+        for (int i = 0; i <= 32; ++i) {
+            unsigned char in[64 * 32];
+            unsigned char out1[32 * 32], out2[32 * 32];
+            GetRandBytes(in, 64 * i);
+            for (int j = 0; j < i; ++j) {
+                CHash256().Write(in + 64 * j, 64).Finalize(out1 + 32 * j);
+            }
+            SHA256D64(out2, in, i);
+            BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+            // in place, as ComputeMerkleRoot does
+            SHA256D64(in, in, i);
+            BOOST_CHECK(memcmp(out1, in, 32 * i) == 0);
+        }
+    }
+    SHA256AutoDetect();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -81,6 +81,44 @@ BOOST_AUTO_TEST_CASE(dbwrapper_batch)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_profiles_stats)
+{
+    BOOST_CHECK_EQUAL(GetDBProfile("chainstate").nMaxOpenFiles, 384);
+    BOOST_CHECK_EQUAL(GetDBProfile("no such profile").nMaxOpenFiles, GetDBProfile("default").nMaxOpenFiles);
+    // LevelDB maps at most 1000 table files per process, the 8 Elysium databases included
+    BOOST_CHECK(GetDBProfile("chainstate").nMaxOpenFiles + GetDBProfile("blockindex").nMaxOpenFiles +
+        GetDBProfile("evodb").nMaxOpenFiles + GetDBProfile("llmq").nMaxOpenFiles +
+        8 * GetDBProfile("elysium").nMaxOpenFiles <= 1000);
+
+    boost::filesystem::path ph = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    CDBWrapper dbw(ph, (1 << 20), true, false, false, "blockindex");
+
+    char key = 'k';
+    uint256 in = GetRandHash();
+    uint256 res;
+    CDBBatch batch(dbw);
+    batch.Write(key, in);
+    dbw.WriteBatch(batch, true);
+
+    // move the entry from the write buffer into a table, so the read looks in the block cache
+    dbw.CompactFull();
+    BOOST_CHECK(dbw.Read(key, res));
+
+    CDBStats stats = dbw.GetStats();
+    BOOST_CHECK_EQUAL(stats.strProfile, "blockindex");
+    BOOST_CHECK_EQUAL(stats.nBlockCacheSize, (1U << 20) / 4);
+    // blocks of in-memory and mapped tables are never cached, so this is always a miss
+    BOOST_CHECK(stats.nBlockCacheMisses >= 1);
+    BOOST_CHECK_EQUAL(stats.nWriteBatches, 1U);
+    BOOST_CHECK_EQUAL(stats.nSyncWrites, 1U);
+    BOOST_CHECK(!stats.vLevels.empty());
+
+    bool fFound = false;
+    for (const CDBStats& s : GetAllDBStats())
+        fFound |= s.strPath == ph.string();
+    BOOST_CHECK(fFound);
+}
+
 BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
 {
     // Perform tests both obfuscated and non-obfuscated.
@@ -248,4 +248,52 @@ BOOST_AUTO_TEST_CASE(Test_EnforceZnodePayment)
     BOOST_CHECK(true == CheckTransaction(*b.vtx[0], state, true, tx.GetHash(), false, 0));
 }
 
+BOOST_AUTO_TEST_CASE(Test_ZnodeManLookups)
+{
+    CZnodeMan man;
+    std::vector<CZnode> vecNodes;
+    for (int i = 0; i < 20; i++) {
+        CKey keyCollateral, keyZnode;
+        keyCollateral.MakeNewKey(true);
+        keyZnode.MakeNewKey(true);
+        CTxIn vin(GetRandHash(), i);
+        CZnode mn(CService(), vin, keyCollateral.GetPubKey(), keyZnode.GetPubKey(), LEGACY_INDEXNODES_PROTOCOL_VERSION);
+        BOOST_CHECK(man.Add(mn));
+        BOOST_CHECK(!man.Add(mn));
+        vecNodes.push_back(mn);
+    }
+
+    BOOST_FOREACH(CZnode& mn, vecNodes) {
+        CZnode* pmn = man.Find(mn.vin);
+        BOOST_REQUIRE(pmn);
+        BOOST_CHECK(pmn->vin == mn.vin);
+        BOOST_CHECK(man.Find(mn.pubKeyZnode) == pmn);
+        BOOST_CHECK(man.Find(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID())) == pmn);
+        BOOST_CHECK(man.Find(mn.vin.prevout.hash.ToString(), std::to_string(mn.vin.prevout.n)) == pmn);
+        // indexnodes are never paid to a bare pubkey
+        BOOST_CHECK(man.Find(GetScriptForRawPubKey(mn.pubKeyCollateralAddress)) == NULL);
+    }
+    BOOST_CHECK(man.Find(CTxIn(GetRandHash(), 0)) == NULL);
+
+    // ranks are served from the cache on repeated calls and must stay consistent
+    for (int nRound = 0; nRound < 2; nRound++) {
+        std::vector<std::pair<int, CZnode> > vecRanks = man.GetZnodeRanks(100);
+        BOOST_REQUIRE_EQUAL(vecRanks.size(), vecNodes.size());
+        BOOST_FOREACH(PAIRTYPE(int, CZnode)& rank, vecRanks) {
+            BOOST_CHECK_EQUAL(man.GetZnodeRank(rank.second.vin, 100), rank.first);
+            CZnode* pmn = man.GetZnodeByRank(rank.first, 100);
+            BOOST_REQUIRE(pmn);
+            BOOST_CHECK(pmn->vin == rank.second.vin);
+        }
+    }
+
+    // adding a node invalidates the cached ranks
+    CKey key;
+    key.MakeNewKey(true);
+    CZnode mnNew(CService(), CTxIn(GetRandHash(), 0), key.GetPubKey(), key.GetPubKey(), LEGACY_INDEXNODES_PROTOCOL_VERSION);
+    BOOST_CHECK(man.Add(mnNew));
+    BOOST_CHECK_EQUAL(man.GetZnodeRanks(100).size(), vecNodes.size() + 1);
+    BOOST_CHECK(man.GetZnodeRank(mnNew.vin, 100) > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
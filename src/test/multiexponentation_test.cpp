@@ -30,3 +30,47 @@ BOOST_AUTO_TEST_CASE(multiexponentation_test)
     }
 }
 
+
+BOOST_AUTO_TEST_CASE(multiexponentation_parallel_test)
+{
+    // Runs every task on a thread of its own
+    secp_primitives::MultiExponent::TaskRunner runner = [](const std::vector<std::function<void()>>& tasks) {
+        boost::thread_group threads;
+        for (const auto& task : tasks)
+            threads.create_thread(task);
+        threads.join_all();
+    };
+
+    std::vector<int> sizes = {0, 1, 100, 1024, 5000, 16050};
+
+    for (int size : sizes) {
+        std::vector<secp_primitives::GroupElement> gens(size);
+        std::vector<secp_primitives::Scalar> scalars(size);
+
+        secp_primitives::GroupElement r;
+        for (int i = 0; i < size; ++i) {
+            gens[i].randomize();
+            scalars[i].randomize();
+            // points which are not affine, infinity and zero or even scalars all take their own paths
+            if (i % 7 == 3)
+                gens[i] += gens[0];
+            if (i % 13 == 5)
+                scalars[i] = secp_primitives::Scalar(uint64_t(0));
+            if (i % 17 == 6)
+                gens[i] = secp_primitives::GroupElement();
+            if (i % 19 == 2)
+                scalars[i] = secp_primitives::Scalar(uint64_t(2));
+
+            r += gens[i] * scalars[i];
+        }
+
+        secp_primitives::MultiExponent multiexponent(gens.data(), scalars.data(), gens.size());
+        BOOST_CHECK_EQUAL(r, multiexponent.get_multiple());
+        // more tasks than windows split the points as well
+        for (std::size_t tasks : {2, 3, 8, 40})
+            BOOST_CHECK_EQUAL(r, multiexponent.get_multiple(runner, tasks));
+
+        secp_primitives::MultiExponent copy(multiexponent);
+        BOOST_CHECK_EQUAL(r, copy.get_multiple());
+    }
+}
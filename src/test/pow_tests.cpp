@@ -4,9 +4,11 @@
 
 #include "chain.h"
 #include "chainparams.h"
+#include "consensus/validation.h"
 #include "pow.h"
 #include "random.h"
 #include "util.h"
+#include "validation.h"
 #include "test/test_bitcoin.h"
 
 #include <boost/test/unit_test.hpp>
@@ -93,4 +95,44 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+/* The header checks spread over the header check threads give the same results as CheckBlockHeader */
+BOOST_AUTO_TEST_CASE(check_block_headers_parallel)
+{
+    const Consensus::Params& params = Params(CBaseChainParams::REGTEST).GetConsensus();
+
+    std::vector<CBlockHeader> headers(100);
+    uint256 hashPrevBlock;
+    for (size_t i = 0; i < headers.size(); i++) {
+        headers[i].hashPrevBlock = hashPrevBlock;
+        headers[i].nTime = 1269211443 + i * params.nPowTargetSpacing;
+        headers[i].nBits = 0x207fffff;
+        headers[i].nNonce = i + 1;
+        if (i == 10)
+            headers[i].nBits = 0; // no valid target
+        if (i == 20 || i == 30)
+            headers[i].nNonce = 0; // proof of stake, without and with a signature
+        if (i == 30)
+            headers[i].vchBlockSig.assign(72, 1);
+        hashPrevBlock = headers[i].GetHash();
+    }
+
+    for (int nThreads : {1, 4}) {
+        StartHeaderCheckThreads(nThreads);
+        CBlockHeaderChecks checks = CheckBlockHeaders(headers, params);
+        StopHeaderCheckThreads();
+
+        BOOST_CHECK_EQUAL(checks.vChecks.size(), headers.size());
+        for (size_t i = 0; i < headers.size(); i++) {
+            CValidationState state;
+            bool fValid = CheckBlockHeader(headers[i], state, params);
+            BOOST_CHECK(checks.vChecks[i].hash == headers[i].GetHash());
+            BOOST_CHECK_EQUAL(checks.vChecks[i].fValid, fValid);
+            BOOST_CHECK_EQUAL(checks.vChecks[i].state.GetRejectReason(), state.GetRejectReason());
+        }
+        BOOST_CHECK_EQUAL(checks.vChecks[10].state.GetRejectReason(), "high-hash");
+        BOOST_CHECK_EQUAL(checks.vChecks[20].state.GetRejectReason(), "empty-blocksig");
+        BOOST_CHECK(checks.vChecks[30].fValid);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
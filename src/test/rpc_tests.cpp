@@ -4,9 +4,11 @@
 
 #include "rpc/server.h"
 #include "rpc/client.h"
+#include "rpc/jsonstream.h"
 
 #include "base58.h"
 #include "netbase.h"
+#include "validation.h"
 
 #include "test/test_bitcoin.h"
 
@@ -237,6 +239,96 @@ BOOST_AUTO_TEST_CASE(json_parse_errors)
     BOOST_CHECK_THROW(ParseNonRFCJSONValue("3J98t1WpEZ73CNmQviecrnyiWrnqRhWNL"), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_batch_order)
+{
+    BOOST_CHECK(StartRPC());
+
+    // mix concurrent and sequential commands, replies must come back in request order
+    UniValue vReq(UniValue::VARR);
+    for (int i = 0; i < 20; i++) {
+        UniValue req(UniValue::VOBJ);
+        req.push_back(Pair("id", i));
+        req.push_back(Pair("method", i % 5 == 4 ? "help" : "getblockcount"));
+        req.push_back(Pair("params", UniValue(UniValue::VARR)));
+        vReq.push_back(req);
+    }
+    UniValue ret;
+    BOOST_CHECK(ret.read(JSONRPCExecBatch(vReq)));
+    BOOST_REQUIRE_EQUAL(ret.size(), 20);
+    for (int i = 0; i < 20; i++)
+        BOOST_CHECK_EQUAL(find_value(ret[i], "id").get_int(), i);
+
+    UniValue info = CallRPC("getrpcinfo");
+    BOOST_CHECK(find_value(find_value(info, "batches"), "requests").get_int64() >= 20);
+    BOOST_CHECK(find_value(find_value(info, "batches"), "concurrent").get_int64() >= 16);
+
+    InterruptRPC();
+    StopRPC();
+}
+
+BOOST_AUTO_TEST_CASE(rpc_json_stream)
+{
+    UniValue inner(UniValue::VOBJ);
+    inner.push_back(Pair("esc\"aped", "line\nbreak \\ \u00e9"));
+    inner.push_back(Pair("empty", UniValue(UniValue::VARR)));
+    UniValue expected(UniValue::VOBJ);
+    expected.push_back(Pair("a", 1));
+    expected.push_back(Pair("b", inner));
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 100; i++)
+        arr.push_back(inner);
+    arr.push_back(NullUniValue);
+    expected.push_back(Pair("c", arr));
+    expected.push_back(Pair("d", UniValue(UniValue::VOBJ)));
+
+    // a tiny chunk size makes the writer flush in the middle of the document
+    std::string strStreamed;
+    {
+        CJSONStreamWriter writer([&strStreamed](const char* data, size_t size) { strStreamed.append(data, size); }, 16);
+        writer.BeginObject();
+        writer.Key("a");
+        writer.Value(1);
+        writer.Key("b");
+        writer.BeginObject();
+        writer.Members(inner);
+        writer.EndObject();
+        writer.Key("c");
+        writer.BeginArray();
+        for (int i = 0; i < 100; i++)
+            writer.Value(inner);
+        writer.Value(NullUniValue);
+        writer.EndArray();
+        writer.Key("d");
+        writer.BeginObject();
+        writer.EndObject();
+        writer.EndObject();
+    }
+    BOOST_CHECK_EQUAL(strStreamed, expected.write());
+
+    // the streamed getblock result is the same text as the regular one, the actor is
+    // called directly like CallRPC does because the test never leaves RPC warmup
+    std::string strHash = chainActive.Genesis()->GetBlockHash().GetHex();
+    JSONRPCRequest jreq;
+    jreq.strMethod = "getblock";
+    jreq.params = UniValue(UniValue::VARR);
+    jreq.params.push_back(strHash);
+    strStreamed.clear();
+    {
+        CJSONStreamWriter writer([&strStreamed](const char* data, size_t size) { strStreamed.append(data, size); });
+        BOOST_CHECK(tableRPC["getblock"]->streamActor(jreq, writer));
+    }
+    BOOST_CHECK_EQUAL(strStreamed, CallRPC("getblock " + strHash).write());
+
+    // the hex form has no streaming actor
+    jreq.params.push_back(false);
+    strStreamed.clear();
+    {
+        CJSONStreamWriter writer([&strStreamed](const char* data, size_t size) { strStreamed.append(data, size); });
+        BOOST_CHECK(!tableRPC["getblock"]->streamActor(jreq, writer));
+    }
+    BOOST_CHECK(strStreamed.empty());
+}
+
 BOOST_AUTO_TEST_CASE(rpc_ban)
 {
     BOOST_CHECK_NO_THROW(CallRPC(std::string("clearbanned")));
@@ -1128,6 +1128,72 @@ BOOST_AUTO_TEST_CASE(sigma_getcoinsetforspend)
     chainActive.SetTip(NULL);
 }
 
+BOOST_AUTO_TEST_CASE(sigma_state_snapshot)
+{
+    sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
+    sigma::Params* params = sigma::Params::get_default();
+    chainActive.SetTip(NULL);
+
+    std::vector<CBlockIndex> indexes;
+    indexes.reserve(11);
+    for (int i = 0; i <= 10; i++) {
+        indexes.emplace_back(CreateBlockIndex(i));
+        chainActive.SetTip(&indexes.back());
+    }
+
+    std::pair<sigma::CoinDenomination, int> denomination1Group1(sigma::CoinDenomination::SIGMA_DENOM_1, 1);
+    std::pair<sigma::CoinDenomination, int> denomination10Group1(sigma::CoinDenomination::SIGMA_DENOM_10, 1);
+
+    auto pubCoins = getPubcoins(generateCoins(params, 10, sigma::CoinDenomination::SIGMA_DENOM_1));
+    auto pubCoins2 = getPubcoins(generateCoins(params, 2, sigma::CoinDenomination::SIGMA_DENOM_10));
+
+    secp_primitives::Scalar serial;
+    serial.randomize();
+
+    indexes[2].sigmaMintedPubCoins[denomination1Group1] = pubCoins;
+    indexes[5].sigmaMintedPubCoins[denomination10Group1] = pubCoins2;
+    indexes[7].sigmaSpentSerials.insert(std::make_pair(serial, sigma::CSpendCoinInfo::make(sigma::CoinDenomination::SIGMA_DENOM_1, 1)));
+
+    sigma::BuildSigmaStateFromIndex(&chainActive);
+
+    // serialize snapshot and restore the state from it
+    sigma::CSigmaStateSnapshot snapshot;
+    sigmaState->GetSnapshot(chainActive.Tip(), snapshot);
+
+    CDataStream stream(SER_DISK, CLIENT_VERSION);
+    stream << snapshot;
+
+    sigma::CSigmaStateSnapshot restored;
+    stream >> restored;
+
+    sigmaState->Reset();
+    BOOST_CHECK(sigmaState->ApplySnapshot(&chainActive, restored));
+
+    sigma::CSigmaState::SigmaCoinGroupInfo group;
+    BOOST_CHECK(sigmaState->GetCoinGroupInfo(sigma::CoinDenomination::SIGMA_DENOM_1, 1, group));
+    BOOST_CHECK(group.firstBlock == &indexes[2]);
+    BOOST_CHECK(group.lastBlock == &indexes[2]);
+    BOOST_CHECK_EQUAL(group.nCoins, 10);
+
+    BOOST_CHECK(sigmaState->GetCoinGroupInfo(sigma::CoinDenomination::SIGMA_DENOM_10, 1, group));
+    BOOST_CHECK(group.firstBlock == &indexes[5]);
+    BOOST_CHECK_EQUAL(group.nCoins, 2);
+
+    BOOST_CHECK_EQUAL(sigmaState->GetLatestCoinID(sigma::CoinDenomination::SIGMA_DENOM_1), 1);
+    BOOST_CHECK_EQUAL(sigmaState->GetLatestCoinID(sigma::CoinDenomination::SIGMA_DENOM_10), 1);
+    BOOST_CHECK_EQUAL(sigmaState->GetMints().size(), 12);
+    BOOST_CHECK(sigmaState->HasCoin(pubCoins2[1]));
+    BOOST_CHECK(sigmaState->GetMintedCoinHeightAndId(pubCoins[3]) == std::make_pair(2, 1));
+    BOOST_CHECK(sigmaState->IsUsedCoinSerial(serial));
+
+    // snapshot taken at a block which is not in the chain anymore can't be applied
+    restored.nHeight = 11;
+    BOOST_CHECK(!sigmaState->ApplySnapshot(&chainActive, restored));
+
+    sigmaState->Reset();
+    chainActive.SetTip(NULL);
+}
+
 namespace {
     Scalar generateSpend(sigma::CoinDenomination denom) {
         auto params = sigma::Params::get_default();
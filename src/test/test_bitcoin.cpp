@@ -14,6 +14,7 @@
 #include "chainparams.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "crypto/sha256.h"
 #include "key.h"
 #include "validation.h"
 #include "miner.h"
@@ -59,6 +60,7 @@ extern CEvoDB* evoDb;
 
 BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
 {
+    SHA256AutoDetect();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
@@ -0,0 +1,68 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "zerocoin.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_accumulatormemo_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(memo_values)
+{
+    libzerocoin::CoinDenomination denomination = libzerocoin::ZQ_LOVELACE;
+    vector<CBigNum> pubCoins;
+    for (int i = 0; i < 3; i++)
+        pubCoins.push_back(libzerocoin::PrivateCoin(ZCParams, denomination).getPublicCoin().getValue());
+
+    CZerocoinAccumulatorMemo memo;
+    CZerocoinAccumulatorMemo::Key key = {false, (int)denomination, 1, uint256S("01"), false};
+    std::shared_ptr<CZerocoinAccumulatorMemo::Entry> entry = memo.Get(key);
+
+    // the values are the ones of accumulating the coins one at a time, whatever order they are asked in
+    BOOST_CHECK(entry->GetValue(1, pubCoins, ZCParams, denomination) == entry->GetValue(1, pubCoins, ZCParams, denomination));
+    libzerocoin::Accumulator accumulator(ZCParams, denomination);
+    for (size_t i = 0; i < pubCoins.size(); i++) {
+        accumulator += libzerocoin::PublicCoin(ZCParams, pubCoins[i], denomination);
+        BOOST_CHECK(entry->GetValue(i, pubCoins, ZCParams, denomination) == accumulator.getValue());
+    }
+
+    BOOST_CHECK(memo.Get(key) == entry);
+    key.fReverse = true;
+    BOOST_CHECK(memo.Get(key) != entry);
+    key.fReverse = false;
+    key.fModulusV2 = true;
+    BOOST_CHECK(memo.Get(key) != entry);
+}
+
+BOOST_AUTO_TEST_CASE(memo_bounds)
+{
+    CZerocoinAccumulatorMemo memo;
+    CZerocoinAccumulatorMemo::Key key = {false, 1, 1, uint256S("01"), false};
+    std::shared_ptr<CZerocoinAccumulatorMemo::Entry> first = memo.Get(key);
+
+    // entries used recently are kept, the least recently used ones dropped
+    for (int id = 2; id <= (int)CZerocoinAccumulatorMemo::MAX_ENTRIES + 1; id++) {
+        CZerocoinAccumulatorMemo::Key otherKey = {false, 1, id, uint256S("01"), false};
+        memo.Get(otherKey);
+        BOOST_CHECK(memo.Get(key) == first);
+    }
+    CZerocoinAccumulatorMemo::Key evictedKey = {false, 1, 2, uint256S("01"), false};
+    std::shared_ptr<CZerocoinAccumulatorMemo::Entry> evicted = memo.Get(evictedKey);
+    BOOST_CHECK(memo.Get(key) == first);
+    BOOST_CHECK(memo.Get(evictedKey) == evicted);
+
+    // disconnecting a block drops the entries computed up to it
+    CZerocoinAccumulatorMemo::Key otherBlockKey = {false, 1, 1, uint256S("02"), false};
+    std::shared_ptr<CZerocoinAccumulatorMemo::Entry> otherBlock = memo.Get(otherBlockKey);
+    memo.RemoveBlock(uint256S("01"));
+    BOOST_CHECK(memo.Get(key) != first);
+    BOOST_CHECK(memo.Get(otherBlockKey) == otherBlock);
+
+    memo.Clear();
+    BOOST_CHECK(memo.Get(otherBlockKey) != otherBlock);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+// Copyright (c) 2020 The Zcoin Core Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "libzerocoin/Zerocoin.h"
+#include "zerocoin.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_pow_tests, BasicTestingSetup)
+
+static std::vector<CBigNum> TestExponents(const CBigNum& range)
+{
+    std::vector<CBigNum> exponents = {0, 1, range - 1, range, range + 1};
+    for (int i = 0; i < 8; i++) {
+        // Longer than the tables and negative exponents take other paths
+        CBigNum e = CBigNum::randBignum(range * CBigNum(2).pow(i * 40));
+        exponents.push_back(i % 2 ? -e : e);
+    }
+    return exponents;
+}
+
+BOOST_AUTO_TEST_CASE(integer_group_pow)
+{
+    for (const libzerocoin::Params* params : {ZCParams, ZCParamsV2}) {
+        for (const libzerocoin::IntegerGroupParams* group : {&params->coinCommitmentGroup, &params->serialNumberSoKCommitmentGroup,
+                &params->accumulatorParams.accumulatorPoKCommitmentGroup}) {
+            CBigNum base = group->randomElement();
+            for (const CBigNum& e : TestExponents(group->groupOrder)) {
+                BOOST_CHECK(group->powG(e) == group->g.pow_mod(e, group->modulus));
+                BOOST_CHECK(group->powH(e) == group->h.pow_mod(e, group->modulus));
+                BOOST_CHECK(group->pow(base, e) == base.pow_mod(e, group->modulus));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(accumulator_pow)
+{
+    const libzerocoin::AccumulatorAndProofParams& params = ZCParamsV2->accumulatorParams;
+    const CBigNum& g = params.accumulatorQRNCommitmentGroup.g;
+    const CBigNum& h = params.accumulatorQRNCommitmentGroup.h;
+    for (const CBigNum& e : TestExponents(params.accumulatorModulus)) {
+        BOOST_CHECK(params.powQRNG(e) == g.pow_mod(e, params.accumulatorModulus));
+        BOOST_CHECK(params.powQRNH(e) == h.pow_mod(e, params.accumulatorModulus));
+        BOOST_CHECK(params.powAccumulator(params.accumulatorBase, e) == params.accumulatorBase.pow_mod(e, params.accumulatorModulus));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(spend_verify)
+{
+    const libzerocoin::Params* params = ZCParamsV2;
+    libzerocoin::PrivateCoin coin(params, libzerocoin::ZQ_LOVELACE, ZEROCOIN_TX_VERSION_2);
+    libzerocoin::PrivateCoin otherCoin(params, libzerocoin::ZQ_LOVELACE, ZEROCOIN_TX_VERSION_2);
+
+    libzerocoin::Accumulator accumulator(&params->accumulatorParams, libzerocoin::ZQ_LOVELACE);
+    libzerocoin::AccumulatorWitness witness(params, accumulator, coin.getPublicCoin());
+    accumulator += coin.getPublicCoin();
+    accumulator += otherCoin.getPublicCoin();
+    witness += otherCoin.getPublicCoin();
+
+    libzerocoin::SpendMetaData metaData(arith_uint256(0), uint256());
+    libzerocoin::CoinSpend spend(params, coin, accumulator, witness, metaData);
+    BOOST_CHECK(spend.Verify(accumulator, metaData));
+
+    // The spend does not verify against an accumulator without the coin
+    libzerocoin::Accumulator otherAccumulator(&params->accumulatorParams, libzerocoin::ZQ_LOVELACE);
+    otherAccumulator += otherCoin.getPublicCoin();
+    BOOST_CHECK(!spend.Verify(otherAccumulator, metaData));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
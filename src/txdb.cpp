@@ -6,12 +6,14 @@
 #include "txdb.h"
 
 #include "chainparams.h"
+#include "coinstats.h"
 #include "hash.h"
 #include "pow.h"
 #include "uint256.h"
 #include "validation.h"
 #include "consensus/consensus.h"
 #include "base58.h"
+#include "sigma.h"
 
 #include <stdint.h>
 
@@ -32,6 +34,8 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 static const char DB_TOTAL_SUPPLY = 'S';
+static const char DB_SIGMA_STATE = 'Z';
+static const char DB_UTXO_STATS = 'U';
 
 namespace {
 
@@ -57,7 +61,7 @@ struct CoinEntry {
 
 }
 
-CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true)
+CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, "chainstate")
 {
 }
 
@@ -80,7 +84,9 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     CDBBatch batch(db);
     size_t count = 0;
     size_t changed = 0;
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+    // mapCoins is left as it is, the caller clears it. CCoinsViewFlushBuffer relies on
+    // this to serve reads from the map while it is being written.
+    for (CCoinsMap::const_iterator it = mapCoins.begin(); it != mapCoins.end(); ++it) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
             if (it->second.coin.IsSpent())
@@ -90,8 +96,6 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
     }
     if (!hashBlock.IsNull())
         batch.Write(DB_BEST_BLOCK, hashBlock);
@@ -106,7 +110,174 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
-CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+CCoinsViewFlushBuffer::CCoinsViewFlushBuffer(CCoinsView* viewIn) : CCoinsViewBacked(viewIn),
+    pendingCoins(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &pendingResource), fWriteFailed(false)
+{
+}
+
+CCoinsViewFlushBuffer::~CCoinsViewFlushBuffer()
+{
+    Wait();
+}
+
+bool CCoinsViewFlushBuffer::GetCoin(const COutPoint &outpoint, Coin &coin) const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        CCoinsMap::const_iterator it = pendingCoins.find(outpoint);
+        if (it != pendingCoins.end()) {
+            if (it->second.coin.IsSpent())
+                return false;
+            coin = it->second.coin;
+            return true;
+        }
+    }
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewFlushBuffer::HaveCoin(const COutPoint &outpoint) const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        CCoinsMap::const_iterator it = pendingCoins.find(outpoint);
+        if (it != pendingCoins.end())
+            return !it->second.coin.IsSpent();
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewFlushBuffer::GetBestBlock() const
+{
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (!hashPendingBlock.IsNull())
+            return hashPendingBlock;
+    }
+    return base->GetBestBlock();
+}
+
+bool CCoinsViewFlushBuffer::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock)
+{
+    {
+        std::lock_guard<std::mutex> lockWriter(csWriter);
+        bool fRunning;
+        {
+            std::lock_guard<std::mutex> lockStats(csStats);
+            fRunning = stats.fWriting;
+        }
+        int64_t nStart = GetTimeMicros();
+        if (!WaitLocked())
+            return false;
+        if (fRunning) {
+            int64_t nMicros = GetTimeMicros() - nStart;
+            LogPrint("coindb", "Coins flush waited %.2fms for the previous write\n", nMicros * 0.001);
+            std::lock_guard<std::mutex> lockStats(csStats);
+            stats.nStalls++;
+            stats.nTotalStallMicros += nMicros;
+            stats.nMaxStallMicros = std::max(stats.nMaxStallMicros, nMicros);
+        }
+    }
+
+    // No write is running now, so nothing reads the entries without holding cs
+    std::lock_guard<std::mutex> lock(cs);
+    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); it = mapCoins.erase(it)) {
+        if (!(it->second.flags & CCoinsCacheEntry::DIRTY))
+            continue;
+        // Spent and never seen by the database, there is nothing to write
+        if ((it->second.flags & CCoinsCacheEntry::FRESH) && it->second.coin.IsSpent())
+            continue;
+        CCoinsCacheEntry& entry = pendingCoins[it->first];
+        entry.coin = std::move(it->second.coin);
+        entry.flags = CCoinsCacheEntry::DIRTY;
+    }
+    if (!hashBlock.IsNull())
+        hashPendingBlock = hashBlock;
+    return true;
+}
+
+CCoinsViewCursor *CCoinsViewFlushBuffer::Cursor() const
+{
+    // The cursor iterates over the database, which has to be up to date
+    Wait();
+    return base->Cursor();
+}
+
+bool CCoinsViewFlushBuffer::WritePending(const std::function<bool()>& fnAfter)
+{
+    int64_t nStart = GetTimeMicros();
+    bool fOk = false;
+    try {
+        // Nothing modifies pendingCoins or hashPendingBlock until the write is done, GetCoin() may read them concurrently
+        fOk = base->BatchWrite(pendingCoins, hashPendingBlock) && (!fnAfter || fnAfter());
+    } catch (const std::exception& e) {
+        LogPrintf("%s: %s\n", __func__, e.what());
+    }
+    int64_t nMicros = GetTimeMicros() - nStart;
+
+    size_t nCoins = pendingCoins.size();
+    if (fOk) {
+        // Recreate the map so its memory goes back to the system, like CCoinsViewCache::Flush() does
+        std::lock_guard<std::mutex> lock(cs);
+        pendingCoins.~CCoinsMap();
+        pendingResource.~CCoinsMapMemoryResource();
+        ::new (&pendingResource) CCoinsMapMemoryResource();
+        ::new (&pendingCoins) CCoinsMap(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &pendingResource);
+        hashPendingBlock.SetNull();
+    }
+    LogPrint("coindb", "Wrote %u coins to the coin database in %.2fms\n", (unsigned int)nCoins, nMicros * 0.001);
+
+    std::lock_guard<std::mutex> lockStats(csStats);
+    stats.nLastCoins = nCoins;
+    stats.nLastWriteMicros = nMicros;
+    stats.nTotalWriteMicros += nMicros;
+    stats.nMaxWriteMicros = std::max(stats.nMaxWriteMicros, nMicros);
+    stats.fWriting = false;
+    return fOk;
+}
+
+bool CCoinsViewFlushBuffer::Write(bool fAsync, std::function<bool()> fnAfter)
+{
+    std::lock_guard<std::mutex> lockWriter(csWriter);
+    if (!WaitLocked())
+        return false;
+    {
+        std::lock_guard<std::mutex> lockStats(csStats);
+        stats.nFlushes++;
+        if (fAsync)
+            stats.nAsyncFlushes++;
+        stats.fWriting = true;
+    }
+    if (!fAsync)
+        return WritePending(fnAfter);
+
+    writer = std::thread([this, fnAfter] {
+        RenameThread("index-flush");
+        if (!WritePending(fnAfter))
+            fWriteFailed = true;
+    });
+    return true;
+}
+
+bool CCoinsViewFlushBuffer::WaitLocked() const
+{
+    if (writer.joinable())
+        writer.join();
+    return !fWriteFailed;
+}
+
+bool CCoinsViewFlushBuffer::Wait() const
+{
+    std::lock_guard<std::mutex> lockWriter(csWriter);
+    return WaitLocked();
+}
+
+CCoinsFlushStats CCoinsViewFlushBuffer::GetStats() const
+{
+    std::lock_guard<std::mutex> lockStats(csStats);
+    return stats;
+}
+
+CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe, false, "blockindex") {
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -452,6 +623,31 @@ bool CBlockTreeDB::ReadTotalSupply(CAmount & supply)
     return false;
 }
 
+bool CBlockTreeDB::WriteSigmaStateSnapshot(const sigma::CSigmaStateSnapshot &snapshot)
+{
+    return Write(DB_SIGMA_STATE, snapshot, true);
+}
+
+bool CBlockTreeDB::ReadSigmaStateSnapshot(sigma::CSigmaStateSnapshot &snapshot)
+{
+    return Read(DB_SIGMA_STATE, snapshot);
+}
+
+bool CBlockTreeDB::WriteUTXOStats(int nHeight, const CUTXOStats &stats)
+{
+    return Write(std::make_pair(DB_UTXO_STATS, nHeight), stats);
+}
+
+bool CBlockTreeDB::ReadUTXOStats(int nHeight, CUTXOStats &stats)
+{
+    return Read(std::make_pair(DB_UTXO_STATS, nHeight), stats);
+}
+
+bool CBlockTreeDB::EraseUTXOStats(int nHeight)
+{
+    return Erase(std::make_pair(DB_UTXO_STATS, nHeight));
+}
+
 /******************************************************************************/
 
 CDbIndexHelper::CDbIndexHelper(bool addressIndex_, bool spentIndex_)
@@ -11,8 +11,11 @@
 #include "chain.h"
 #include "spentindex.h"
 
+#include <functional>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -20,8 +23,11 @@
 
 class CBlockIndex;
 class CCoinsViewDBCursor;
+class CUTXOStats;
 class uint256;
 
+namespace sigma { class CSigmaStateSnapshot; }
+
 //! Compensate for extra memory peak (x1.5-x1.9) at flush time.
 static constexpr int DB_PEAK_USAGE_FACTOR = 2;
 //! Factor to estimate actual memory usage.
@@ -68,6 +74,23 @@ struct CDiskTxPos : public CDiskBlockPos
     }
 };
 
+/** Statistics about flushes of the coins cache, see CCoinsViewFlushBuffer */
+struct CCoinsFlushStats
+{
+    uint64_t nFlushes = 0;
+    uint64_t nAsyncFlushes = 0;
+    //! coins taken over by the most recent flush
+    uint64_t nLastCoins = 0;
+    int64_t nLastWriteMicros = 0;
+    int64_t nTotalWriteMicros = 0;
+    int64_t nMaxWriteMicros = 0;
+    //! flushes that had to wait for the previous write to finish
+    uint64_t nStalls = 0;
+    int64_t nTotalStallMicros = 0;
+    int64_t nMaxStallMicros = 0;
+    bool fWriting = false;
+};
+
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB : public CCoinsView
 {
@@ -87,6 +110,66 @@ public:
     size_t EstimateSize() const override;
 };
 
+/**
+ * Lets the coins cache be flushed in the background. It sits between the
+ * cache and the coin database: BatchWrite() takes over the dirty entries and
+ * returns, then Write() stores them in the base view, on a writer thread if
+ * asked to. Until that finishes the entries are served from here, so
+ * validation continues on the emptied cache.
+ *
+ * Only one write runs at a time; BatchWrite() waits for the previous one,
+ * which is counted as a stall. The best block marker is written in the same
+ * batch as the coins, so a crash leaves the database at the previous flush.
+ *
+ * The base view must not modify the map passed to its BatchWrite() since it
+ * is read concurrently; CCoinsViewDB does not.
+ */
+class CCoinsViewFlushBuffer : public CCoinsViewBacked
+{
+private:
+    //! Protects the entries below against the writer thread clearing them
+    mutable std::mutex cs;
+    CCoinsMapMemoryResource pendingResource;
+    CCoinsMap pendingCoins;
+    uint256 hashPendingBlock;
+
+    //! Serializes waiting for, and starting, the writer thread
+    mutable std::mutex csWriter;
+    mutable std::thread writer;
+    mutable bool fWriteFailed;
+
+    mutable std::mutex csStats;
+    mutable CCoinsFlushStats stats;
+
+    //! Write the pending entries to the base view, followed by fnAfter
+    bool WritePending(const std::function<bool()>& fnAfter);
+    //! Wait for the writer thread, csWriter must be held
+    bool WaitLocked() const;
+
+public:
+    CCoinsViewFlushBuffer(CCoinsView* viewIn);
+    ~CCoinsViewFlushBuffer();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    uint256 GetBestBlock() const override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    CCoinsViewCursor *Cursor() const override;
+
+    /**
+     * Write the entries taken over by the last BatchWrite() to the base view
+     * and then call fnAfter, which writes state that has to follow the coins.
+     * With fAsync this happens on a writer thread and errors are reported by
+     * the next Wait() or BatchWrite().
+     */
+    bool Write(bool fAsync, std::function<bool()> fnAfter = nullptr);
+
+    //! Wait until the coins handed over are in the base view, false if writing them failed
+    bool Wait() const;
+
+    CCoinsFlushStats GetStats() const;
+};
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
@@ -145,6 +228,11 @@ public:
     int GetBlockIndexVersion(uint256 const & blockHash);
     bool AddTotalSupply(CAmount const & supply);
     bool ReadTotalSupply(CAmount & supply);
+    bool WriteSigmaStateSnapshot(const sigma::CSigmaStateSnapshot &snapshot);
+    bool ReadSigmaStateSnapshot(sigma::CSigmaStateSnapshot &snapshot);
+    bool WriteUTXOStats(int nHeight, const CUTXOStats &stats);
+    bool ReadUTXOStats(int nHeight, CUTXOStats &stats);
+    bool EraseUTXOStats(int nHeight);
 };
 
 
@@ -13,9 +13,12 @@
 
 #include "arith_uint256.h"
 #include "blacklist/blacklist.h"
+#include "blockprefetch.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "checkqueue.h"
+#include "coinstats.h"
+#include "ctpl.h"
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
@@ -113,9 +116,12 @@ bool fPruneMode = false;
 bool fAddressIndex = false;
 bool fSpentIndex = false;
 bool fTimestampIndex = false;
+bool fUTXOStats = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+/** UTXO set statistics as of utxoStatsTip.hashBlock, a null hash when they are not known. Guarded by cs_main */
+static CUTXOStats utxoStatsTip;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
@@ -265,6 +271,7 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 CCoinsViewCache *pcoinsTip = NULL;
+CCoinsViewFlushBuffer *pcoinsFlushBuffer = NULL;
 CBlockTreeDB *pblocktree = NULL;
 
 enum FlushStateMode {
@@ -1485,6 +1492,62 @@ bool GetAddressUnspent(uint160 addressHash, AddressType type,
     return true;
 }
 
+bool GetUTXOStatsAtHeight(int nHeight, CUTXOStats &stats)
+{
+    AssertLockHeld(cs_main);
+
+    if (!fUTXOStats)
+        return error("UTXO stats not enabled");
+
+    if (!chainActive.Tip() || utxoStatsTip.hashBlock != chainActive.Tip()->GetBlockHash())
+        return error("UTXO stats not available for the chain tip");
+
+    if (nHeight < 0 || nHeight == chainActive.Height()) {
+        stats = utxoStatsTip;
+        return true;
+    }
+
+    if (nHeight > chainActive.Height())
+        return error("UTXO stats requested beyond the chain tip");
+
+    if (!pblocktree->ReadUTXOStats(nHeight, stats) || stats.hashBlock != chainActive[nHeight]->GetBlockHash())
+        return error("no UTXO stats for height %d", nHeight);
+
+    return true;
+}
+
+/** Pick up the UTXO stats of the chain tip, they are only carried forward from there */
+static void LoadUTXOStatsTip()
+{
+    AssertLockHeld(cs_main);
+
+    utxoStatsTip = CUTXOStats();
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    if (!pindexTip)
+        return;
+
+    CUTXOStats stats;
+    if (pblocktree->ReadUTXOStats(pindexTip->nHeight, stats) && stats.hashBlock == pindexTip->GetBlockHash())
+        utxoStatsTip = stats;
+    else
+        LogPrintf("%s: no UTXO stats for the chain tip, use -reindex-chainstate to rebuild them\n", __func__);
+}
+
+/** Account for the coins a transaction spent and created in the UTXO stats, txundo holds the spent coins */
+static void UpdateUTXOStats(CUTXOStats& stats, const CTransaction& tx, const CTxUndo& txundo, int nHeight)
+{
+    for (size_t j = 0; j < txundo.vprevout.size(); j++)
+        stats.RemoveCoin(tx.vin[j].prevout, txundo.vprevout[j]);
+
+    const uint256& txid = tx.GetHash();
+    for (size_t o = 0; o < tx.vout.size(); o++) {
+        // AddCoins() never stores these
+        if (tx.vout[o].scriptPubKey.IsUnspendable())
+            continue;
+        stats.AddCoin(COutPoint(txid, o), Coin(tx.vout[o], nHeight, tx.IsCoinBase(), tx.IsCoinStake()));
+    }
+}
+
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1548,6 +1611,62 @@ bool ReadBlockFromDisk(CBlock &block, const CBlockIndex *pindex, const Consensus
     return true;
 }
 
+/** Read the record written at pos, after its message start and size, into data */
+static bool ReadRawRecordFromDisk(std::vector<unsigned char>& data, CAutoFile& filein, const CMessageHeader::MessageStartChars& messageStart)
+{
+    try {
+        CMessageHeader::MessageStartChars recordStart;
+        unsigned int nSize;
+        filein >> FLATDATA(recordStart) >> nSize;
+        if (memcmp(recordStart, messageStart, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch", __func__);
+        if (nSize > MAX_SIZE)
+            return error("%s: Record size %u too large", __func__, nSize);
+        data.resize(nSize);
+        filein.read((char*)data.data(), nSize);
+    }
+    catch (const std::exception& e) {
+        return error("%s: Read from disk failed: %s", __func__, e.what());
+    }
+    return true;
+}
+
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    // The record header is right before the position the index points to
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int);
+    CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+    return ReadRawRecordFromDisk(block, filein, messageStart);
+}
+
+bool ReadRawUndoFromDisk(std::vector<unsigned char>& undo, const CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
+{
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int);
+    CAutoFile filein(OpenUndoFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenUndoFile failed for %s", __func__, pos.ToString());
+    if (!ReadRawRecordFromDisk(undo, filein, messageStart))
+        return false;
+
+    uint256 hashChecksum;
+    try {
+        filein >> hashChecksum;
+    }
+    catch (const std::exception& e) {
+        return error("%s: Read from disk failed: %s", __func__, e.what());
+    }
+    CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
+    hasher << hashBlock;
+    hasher.write((const char*)undo.data(), undo.size());
+    if (hashChecksum != hasher.GetHash())
+        return error("%s: Checksum mismatch", __func__);
+    return true;
+}
+
 bool ReadBlockHeaderFromDisk(CBlock &block, const CDiskBlockPos &pos) {
     CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
     if (filein.IsNull())
@@ -2007,6 +2126,8 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
+} // anon namespace
+
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock)
 {
     // Open history file to read
@@ -2033,8 +2154,6 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uin
     return true;
 }
 
-} // anon namespace
-
 /** Abort with a message */
 bool AbortNode(const std::string& strMessage, const std::string& userMessage)
 {
@@ -2127,6 +2246,12 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
 
     CDbIndexHelper dbIndexHelper(fAddressIndex, fSpentIndex);
 
+    // VerifyDB disconnects blocks without really doing so, the stats must not follow it
+    bool fUpdateUTXOStats = fUTXOStats && !pfClean && utxoStatsTip.hashBlock == pindex->GetBlockHash();
+    CUTXOStats utxoStats;
+    if (fUpdateUTXOStats)
+        utxoStats = utxoStatsTip;
+
     CAmount nFees = 0;
 
     if (!UndoSpecialTxsInBlock(block, pindex)) {
@@ -2151,6 +2276,8 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
                 if (!is_spent || tx.vout[o] != coin.out || pindex->nHeight != coin.nHeight || is_coinbase != coin.fCoinBase || is_coinstake != coin.fCoinStake) {
                     fClean = false; // transaction output mismatch
                 }
+                if (is_spent && fUpdateUTXOStats)
+                    utxoStats.RemoveCoin(out, coin);
             }
         }
 
@@ -2166,6 +2293,8 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
                 int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
+                if (fUpdateUTXOStats)
+                    utxoStats.AddCoin(out, view.AccessCoin(out));
             }
             // At this point, all of txundo.vprevout should have been moved out.
         }
@@ -2199,6 +2328,15 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
                 return DISCONNECT_FAILED;
             }
         }
+        if (fUpdateUTXOStats && fClean) {
+            utxoStats.hashBlock = pindex->pprev->GetBlockHash();
+            if (!pblocktree->EraseUTXOStats(pindex->nHeight)) {
+                AbortNode(state, "Failed to erase UTXO stats");
+                error("Failed to erase UTXO stats");
+                return DISCONNECT_FAILED;
+            }
+            utxoStatsTip = utxoStats;
+        }
     }
 
     /*
@@ -2413,8 +2551,15 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     // Special case for the genesis block, skipping connection of its transactions
     // (its coinbase is unspendable)
     if (block.GetHash() == chainparams.GetConsensus().hashGenesisBlock) {
-        if (!fJustCheck)
+        if (!fJustCheck) {
             view.SetBestBlock(pindex->GetBlockHash());
+            if (fUTXOStats) {
+                utxoStatsTip = CUTXOStats();
+                utxoStatsTip.hashBlock = pindex->GetBlockHash();
+                if (!pblocktree->WriteUTXOStats(pindex->nHeight, utxoStatsTip))
+                    return AbortNode(state, "Failed to write UTXO stats");
+            }
+        }
         return true;
     }
 	// Set proof-of-stake hash modifier
@@ -2557,6 +2702,12 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     CDbIndexHelper dbIndexHelper(fAddressIndex, fSpentIndex);
 
+    // VerifyDB reconnects blocks below the tip, the stats only move forward from the block they describe
+    bool fUpdateUTXOStats = fUTXOStats && !fJustCheck && utxoStatsTip.hashBlock == pindex->pprev->GetBlockHash();
+    CUTXOStats utxoStats;
+    if (fUpdateUTXOStats)
+        utxoStats = utxoStatsTip;
+
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
 
@@ -2644,8 +2795,12 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         }
         // Historically there were duplicate transactions in the block, they were allowed until block 66550
         // Don't update coins for such a transaction
-        if (!hasDuplicateInTheSameBlock)
-            UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
+        if (!hasDuplicateInTheSameBlock) {
+            CTxUndo& txundo = i == 0 ? undoDummy : blockundo.vtxundo.back();
+            UpdateCoins(tx, view, txundo, pindex->nHeight);
+            if (fUpdateUTXOStats)
+                UpdateUTXOStats(utxoStats, tx, txundo, pindex->nHeight);
+        }
 
         vPos.push_back(std::make_pair(tx.GetHash(), pos));
         pos.nTxOffset += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
@@ -2756,6 +2911,13 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         if (!pblocktree->WriteTimestampIndex(CTimestampIndexKey(pindex->nTime, pindex->GetBlockHash())))
             return AbortNode(state, "Failed to write timestamp index");
 
+    if (fUpdateUTXOStats) {
+        utxoStats.hashBlock = pindex->GetBlockHash();
+        if (!pblocktree->WriteUTXOStats(pindex->nHeight, utxoStats))
+            return AbortNode(state, "Failed to write UTXO stats");
+        utxoStatsTip = utxoStats;
+    }
+
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
 
@@ -2934,11 +3096,21 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
         if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
             return state.Error("out of disk space");
         // Flush the chainstate (which may refer to block index entries).
+        // With the flush buffer this only hands the dirty coins over, once any earlier write is done.
         if (!pcoinsTip->Flush())
             return AbortNode(state, "Failed to write to coin database");
-        if (!evoDb->CommitRootTransaction()) {
+        if (pcoinsFlushBuffer) {
+            // Write the coins and then the EvoDB, in this order like below. Only callers that
+            // need the state on disk right away (shutdown, RPC) wait for it.
+            evoDb->BeginRootCommit();
+            if (!pcoinsFlushBuffer->Write(mode != FLUSH_STATE_ALWAYS, [] { return evoDb->WritePendingCommit(); }))
+                return AbortNode(state, "Failed to write to coin database or EvoDB");
+        } else if (!evoDb->CommitRootTransaction()) {
             return AbortNode(state, "Failed to commit EvoDB");
         }
+        // Sigma state snapshot is large, write it only on explicit flushes (e.g. on shutdown)
+        if (mode == FLUSH_STATE_ALWAYS && chainActive.Tip() && !sigma::WriteSigmaStateSnapshot(chainActive.Tip()))
+            LogPrintf("%s: failed to write sigma state snapshot\n", __func__);
         nLastFlush = nNow;
     }
     if (fDoFullFlush || ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) && nNow > nLastSetChain + (int64_t)DATABASE_WRITE_INTERVAL * 1000000)) {
@@ -3176,13 +3348,16 @@ struct ConnectTrace {
  * pblock) - if that is not intended, care must be taken to remove the last entry in
  * blocksConnected in case of failure.
  */
-bool static ConnectTip(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace)
+bool static ConnectTip(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, CBlockPrefetcher* prefetcher)
 {
     LogPrintf("ConnectTip() nHeight=%s\n", pindexNew->nHeight);
     assert(pindexNew->pprev == chainActive.Tip());
-    // Read block from disk.
+    // Read block from disk, unless it was read ahead already.
     int64_t nTime1 = GetTimeMicros();
-    if (!pblock) {
+    std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher ? prefetcher->Take(pindexNew) : nullptr;
+    if (!pblock && prefetchedBlock && prefetchedBlock->fRead) {
+        connectTrace.blocksConnected.emplace_back(pindexNew, prefetchedBlock->block);
+    } else if (!pblock) {
         std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
         connectTrace.blocksConnected.emplace_back(pindexNew, pblockNew);
         if (!ReadBlockFromDisk(*pblockNew, pindexNew, chainparams.GetConsensus()))
@@ -3430,7 +3605,7 @@ static void PruneBlockIndexCandidates() {
  * Try to make some progress towards making pindexMostWork the active block.
  * pblock is either NULL or a pointer to a CBlock corresponding to pindexMostWork.
  */
-static bool ActivateBestChainStep(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace)
+static bool ActivateBestChainStep(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace, CBlockPrefetcher* prefetcher)
 {
     LogPrintf("ActivateBestChainStep()\n");
     AssertLockHeld(cs_main);
@@ -3464,7 +3639,7 @@ static bool ActivateBestChainStep(CValidationState& state, const CChainParams& c
 
         // Connect new blocks.
         BOOST_REVERSE_FOREACH(CBlockIndex *pindexConnect, vpindexToConnect) {
-            if (!ConnectTip(state, chainparams, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace)) {
+            if (!ConnectTip(state, chainparams, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, prefetcher)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
                     if (!state.CorruptionPossible())
@@ -3550,6 +3725,9 @@ bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams,
 
     CBlockIndex *pindexMostWork = NULL;
     CBlockIndex *pindexNewTip = NULL;
+    // Reads the blocks towards pindexMostWork ahead of ConnectTip, when there are many of them
+    std::unique_ptr<CBlockPrefetcher> prefetcher;
+    CBlockIndex *pindexPrefetchTarget = NULL;
     do {
         boost::this_thread::interruption_point();
         if (ShutdownRequested())
@@ -3577,9 +3755,26 @@ bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams,
             if (pindexMostWork == NULL || pindexMostWork == chainActive.Tip())
                 return true;
 
+            if (pindexPrefetchTarget != pindexMostWork) {
+                prefetcher.reset();
+                pindexPrefetchTarget = pindexMostWork;
+                const CBlockIndex *pindexPrefetchFork = chainActive.FindFork(pindexMostWork);
+                int nForkHeight = pindexPrefetchFork ? pindexPrefetchFork->nHeight : -1;
+                if (pindexMostWork->nHeight - nForkHeight >= MIN_BLOCK_PREFETCH_DISTANCE) {
+                    CBlockIndex *pindexTarget = pindexMostWork;
+                    prefetcher.reset(new CBlockPrefetcher(chainparams.GetConsensus(), pindexMostWork->GetAncestor(nForkHeight + 1),
+                        [pindexTarget](const CBlockIndex* pindexPrev) -> CBlockIndex* {
+                            if (pindexPrev->nHeight >= pindexTarget->nHeight)
+                                return NULL;
+                            CBlockIndex *pindex = pindexTarget->GetAncestor(pindexPrev->nHeight + 1);
+                            return (pindex->nStatus & BLOCK_HAVE_DATA) ? pindex : NULL;
+                        }, "index-connect"));
+                }
+            }
+
             bool fInvalidFound = false;
             std::shared_ptr<const CBlock> nullBlockPtr;
-            if (!ActivateBestChainStep(state, chainparams, pindexMostWork, pblock && pblock->GetHash() == pindexMostWork->GetBlockHash() ? pblock : nullBlockPtr, fInvalidFound, connectTrace))
+            if (!ActivateBestChainStep(state, chainparams, pindexMostWork, pblock && pblock->GetHash() == pindexMostWork->GetBlockHash() ? pblock : nullBlockPtr, fInvalidFound, connectTrace, prefetcher.get()))
                 return false;
 
             if (fInvalidFound) {
@@ -3731,10 +3926,9 @@ bool ResetBlockFailureFlags(CBlockIndex *pindex) {
     return true;
 }
 
-CBlockIndex* AddToBlockIndex(const CBlockHeader& block)
+static CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256& hash)
 {
     // Check for duplicate
-    uint256 hash = block.GetHash();
     BlockMap::iterator it = mapBlockIndex.find(hash);
     if (it != mapBlockIndex.end())
         return it->second;
@@ -3771,6 +3965,11 @@ CBlockIndex* AddToBlockIndex(const CBlockHeader& block)
     return pindexNew;
 }
 
+CBlockIndex* AddToBlockIndex(const CBlockHeader& block)
+{
+    return AddToBlockIndex(block, block.GetHash());
+}
+
 /** Mark a block as having its data received and checked (up to BLOCK_VALID_TRANSACTIONS). */
 bool ReceivedBlockTransactions(const CBlock &block, CValidationState& state, CBlockIndex *pindexNew, const CDiskBlockPos& pos)
 {
@@ -3909,18 +4108,78 @@ bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos, unsigne
 }
 
 //btzc: code from vertcoin, add
-bool CheckBlockHeader(const CBlockHeader &block, CValidationState &state, const Consensus::Params &consensusParams, bool fCheckPOW) {
+/** CheckBlockHeader with the hash of the header computed by the caller; it is only used for the proof of work */
+static bool CheckBlockHeader(const CBlockHeader &block, const uint256 &hash, CValidationState &state, const Consensus::Params &consensusParams, bool fCheckPOW) {
     fCheckPOW = !block.IsProofOfStake() && fCheckPOW;
-    if (fCheckPOW && !CheckProofOfWork(block.GetHash(), block.nBits, consensusParams)) {
-            if (fCheckPOW && !CheckProofOfWork(block.GetHash(), block.nBits, consensusParams)) {
-               return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
-        }
-    }
+    if (fCheckPOW && !CheckProofOfWork(hash, block.nBits, consensusParams))
+        return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
     if(block.IsProofOfStake() && block.vchBlockSig.empty())
         return state.DoS(100,false,REJECT_INVALID,"empty-blocksig",false,"Empty block signature for PoS block");
     return true;
 }
 
+bool CheckBlockHeader(const CBlockHeader &block, CValidationState &state, const Consensus::Params &consensusParams, bool fCheckPOW) {
+    fCheckPOW = !block.IsProofOfStake() && fCheckPOW;
+    return CheckBlockHeader(block, fCheckPOW ? block.GetHash() : uint256(), state, consensusParams, fCheckPOW);
+}
+
+static std::unique_ptr<ctpl::thread_pool> headerCheckPool;
+
+void StartHeaderCheckThreads(int nThreads)
+{
+    if (nThreads <= 1)
+        return;
+    headerCheckPool.reset(new ctpl::thread_pool(nThreads));
+    RenameThreadPool(*headerCheckPool, "headercheck");
+}
+
+void StopHeaderCheckThreads()
+{
+    if (headerCheckPool) {
+        headerCheckPool->stop(true);
+        headerCheckPool.reset();
+    }
+}
+
+static void CheckBlockHeaderRange(const std::vector<CBlockHeader>& headers, std::vector<CBlockHeaderCheck>& checks, size_t nBegin, size_t nEnd, const Consensus::Params& consensusParams)
+{
+    for (size_t i = nBegin; i < nEnd; i++) {
+        const CBlockHeader& header = headers[i];
+        CBlockHeaderCheck& check = checks[i];
+        check.hash = header.GetHash();
+        check.fValid = CheckBlockHeader(header, check.hash, check.state, consensusParams, true);
+    }
+}
+
+CBlockHeaderChecks CheckBlockHeaders(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams)
+{
+    int64_t nTimeStart = GetTimeMicros();
+    CBlockHeaderChecks checks;
+    checks.vChecks.resize(headers.size());
+
+    if (!headerCheckPool || headers.size() < MIN_PARALLEL_HEADER_CHECKS) {
+        CheckBlockHeaderRange(headers, checks.vChecks, 0, headers.size(), consensusParams);
+    } else {
+        // One contiguous range per thread, as every header costs about the same
+        size_t nTasks = std::min((size_t)headerCheckPool->size(), headers.size());
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(nTasks);
+        for (size_t i = 0; i < nTasks; i++) {
+            size_t nBegin = headers.size() * i / nTasks;
+            size_t nEnd = headers.size() * (i + 1) / nTasks;
+            std::vector<CBlockHeaderCheck>& vChecks = checks.vChecks;
+            tasks.push_back(headerCheckPool->push([&headers, &vChecks, nBegin, nEnd, &consensusParams](int) {
+                CheckBlockHeaderRange(headers, vChecks, nBegin, nEnd, consensusParams);
+            }));
+        }
+        for (auto& task : tasks)
+            task.get();
+    }
+
+    checks.nTimeMicros = GetTimeMicros() - nTimeStart;
+    return checks;
+}
+
 bool GetBlockPublicKey(const CBlock& block, std::vector<unsigned char>& vchPubKey)
 {
     if (block.IsProofOfWork())
@@ -4406,11 +4665,11 @@ bool BroadcastPoSBlock(CBlock* pblock, CWallet& wallet, const CChainParams& chai
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true)
+static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const CBlockHeaderCheck* pcheck = NULL)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    uint256 hash = pcheck ? pcheck->hash : block.GetHash();
     BlockMap::iterator miSelf = mapBlockIndex.find(hash);
     CBlockIndex *pindex = NULL;
     if (hash != chainparams.GetConsensus().hashGenesisBlock) {
@@ -4425,7 +4684,15 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), !block.IsProofOfStake()))
+        bool fValid;
+        if (pcheck) {
+            fValid = pcheck->fValid;
+            if (!fValid)
+                state = pcheck->state;
+        } else {
+            fValid = CheckBlockHeader(block, hash, state, chainparams.GetConsensus(), true);
+        }
+        if (!fValid)
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -4445,7 +4712,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return error("%s: Consensus::ContextualCheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
     }
     if (pindex == NULL)
-        pindex = AddToBlockIndex(block);
+        pindex = AddToBlockIndex(block, hash);
 
     if (ppindex)
         *ppindex = pindex;
@@ -4458,20 +4725,56 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
     return true;
 }
 
+//! Rate of the last ProcessNewBlockHeaders call of more than one header, protected by cs_main
+static double dHeadersPerSecond = 0;
+
+double GetHeadersPerSecond()
+{
+    AssertLockHeld(cs_main);
+    return dHeadersPerSecond;
+}
+
 // Exposed wrapper for AcceptBlockHeader
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, const CBlockHeaderChecks* pchecks)
 {
+    // The hashes and proofs of work first, without cs_main, then the rest in order.
+    // Headers that do not connect are rejected on the first one, they are checked
+    // one at a time so that only that one is hashed.
+    CBlockHeaderChecks checks;
+    if (!pchecks && !headers.empty()) {
+        bool fConnects;
+        {
+            LOCK(cs_main);
+            fConnects = mapBlockIndex.count(headers[0].hashPrevBlock) != 0;
+        }
+        if (fConnects) {
+            checks = CheckBlockHeaders(headers, chainparams.GetConsensus());
+            pchecks = &checks;
+        }
+    }
+    assert(!pchecks || pchecks->vChecks.size() == headers.size());
+    int64_t nTimeStart = GetTimeMicros();
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
             CBlockIndex *pindex = NULL; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(headers[i], state, chainparams, &pindex, pchecks ? &pchecks->vChecks[i] : NULL)) {
                 return false;
             }
             if (ppindex) {
                 *ppindex = pindex;
             }
         }
+
+        if (headers.size() > 1) {
+            int64_t nTimeAccept = GetTimeMicros() - nTimeStart;
+            int64_t nTimeChecks = pchecks ? pchecks->nTimeMicros : 0;
+            int64_t nTime = nTimeChecks + nTimeAccept;
+            dHeadersPerSecond = headers.size() * 1000000.0 / std::max(nTime, (int64_t)1);
+            LogPrint("bench", "ProcessNewBlockHeaders: %u headers, checks %.2fms, accept %.2fms (%.0f headers/s)\n",
+                headers.size(), 0.001 * nTimeChecks, 0.001 * nTimeAccept, dHeadersPerSecond);
+        }
     }
     NotifyHeaderTip();
     return true;
@@ -4937,6 +5240,10 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     pblocktree->ReadFlag("spentindex", fSpentIndex);
     LogPrintf("%s: spent index %s\n", __func__, fSpentIndex ? "enabled" : "disabled");
 
+    // Check whether we maintain UTXO set statistics
+    pblocktree->ReadFlag("utxostats", fUTXOStats);
+    LogPrintf("%s: UTXO stats %s\n", __func__, fUTXOStats ? "enabled" : "disabled");
+
 
     // Load pointer to end of best chain
     BlockMap::iterator it = mapBlockIndex.find(pcoinsTip->GetBestBlock());
@@ -4944,12 +5251,15 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
         return true;
     chainActive.SetTip(it->second);
 
+    if (fUTXOStats)
+        LoadUTXOStatsTip();
+
     PruneBlockIndexCandidates();
 
     // some blocks in index can change as a result of ZerocoinBuildStateFromIndex() call
     set<CBlockIndex *> changes;
     ZerocoinBuildStateFromIndex(&chainActive, changes);
-    sigma::BuildSigmaStateFromIndex(&chainActive);
+    sigma::BuildSigmaStateFromSnapshot(&chainActive);
     if (!changes.empty()) {
         setDirtyBlockIndex.insert(changes.begin(), changes.end());
         FlushStateToDisk();
@@ -4995,6 +5305,14 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     int nGoodTransactions = 0;
     CValidationState state;
     int reportDone = 0;
+    // Read the blocks ahead, down to where the checks below stop
+    const int nHeightStop = chainActive.Height() - nCheckDepth;
+    CBlockPrefetcher prefetcher(chainparams.GetConsensus(), chainActive.Tip(), [nHeightStop](const CBlockIndex* pindexPrev) -> CBlockIndex* {
+            CBlockIndex* pindex = pindexPrev->pprev;
+            if (!pindex || !pindex->pprev || pindex->nHeight < nHeightStop || (fPruneMode && !(pindex->nStatus & BLOCK_HAVE_DATA)))
+                return NULL;
+            return pindex;
+        }, "index-verify", 0, nCheckLevel >= 2);
     LogPrintf("[0%%]...");
     for (CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->pprev; pindex = pindex->pprev)
     {
@@ -5013,9 +5331,12 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
             LogPrintf("VerifyDB(): block verification stopping at height %d (pruning, no data)\n", pindex->nHeight);
             break;
         }
-        CBlock block;
+        std::shared_ptr<CPrefetchedBlock> prefetchedBlock = prefetcher.Take(pindex);
+        if (!prefetchedBlock)
+            return error("VerifyDB(): *** block at %d, hash=%s was not read", pindex->nHeight, pindex->GetBlockHash().ToString());
+        const CBlock& block = *prefetchedBlock->block;
         // check level 0: read from disk
-        if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
+        if (!prefetchedBlock->fRead)
             return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
         LogPrintf("VerifyDB->CheckBlock() nHeight=%s\n", pindex->nHeight);
         // check level 1: verify block validity
@@ -5024,10 +5345,8 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
                          pindex->nHeight, pindex->GetBlockHash().ToString(), FormatStateMessage(state));
         // check level 2: verify undo validity
         if (nCheckLevel >= 2 && pindex) {
-            CBlockUndo undo;
-            CDiskBlockPos pos = pindex->GetUndoPos();
-            if (!pos.IsNull()) {
-                if (!UndoReadFromDisk(undo, pos, pindex->pprev->GetBlockHash()))
+            if (!pindex->GetUndoPos().IsNull()) {
+                if (!prefetchedBlock->fUndoRead)
                     return error("VerifyDB(): *** found bad undo data at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
             }
         }
@@ -5054,13 +5373,16 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     // check level 4: try reconnecting blocks
     if (nCheckLevel >= 4) {
         CBlockIndex *pindex = pindexState;
+        CBlockPrefetcher reconnectPrefetcher(chainparams.GetConsensus(), chainActive.Next(pindexState),
+            [](const CBlockIndex* pindexPrev) { return chainActive.Next(pindexPrev); }, "index-verify");
         while (pindex != chainActive.Tip()) {
             boost::this_thread::interruption_point();
             uiInterface.ShowProgress(_("Verifying blocks..."), std::max(1, std::min(99, 100 - (int)(((double)(chainActive.Height() - pindex->nHeight)) / (double)nCheckDepth * 50))));
             pindex = chainActive.Next(pindex);
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
+            std::shared_ptr<CPrefetchedBlock> prefetchedBlock = reconnectPrefetcher.Take(pindex);
+            if (!prefetchedBlock || !prefetchedBlock->fRead)
                 return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
+            const CBlock& block = *prefetchedBlock->block;
             if (!ConnectBlock(block, state, pindex, coins, chainparams))
                 return error("VerifyDB(): *** found unconnectable block at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
         }
@@ -5183,6 +5505,7 @@ void UnloadBlockIndex()
     }
     mapBlockIndex.clear();
     fHavePruned = false;
+    utxoStatsTip = CUTXOStats();
 }
 
 bool LoadBlockIndex(const CChainParams& chainparams)
@@ -5216,6 +5539,10 @@ bool InitBlockIndex(const CChainParams& chainparams)
     fSpentIndex = GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
     pblocktree->WriteFlag("spentindex", fSpentIndex);
 
+    // Use the provided setting for -utxostats in the new database
+    fUTXOStats = GetBoolArg("-utxostats", DEFAULT_UTXOSTATS);
+    pblocktree->WriteFlag("utxostats", fUTXOStats);
+
     LogPrintf("Initializing databases...\n");
 
     // Only add the genesis block if not reindexing (in which case we reuse the one already on disk)
@@ -13,6 +13,7 @@
 #include "amount.h"
 #include "chain.h"
 #include "coins.h"
+#include "consensus/validation.h"
 #include "protocol.h" // For CMessageHeader::MessageStartChars
 #include "script/script_error.h"
 #include "sync.h"
@@ -39,6 +40,8 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
+class CCoinsViewFlushBuffer;
 class CBloomFilter;
 class CChainParams;
 class CInv;
@@ -46,6 +49,7 @@ class CConnman;
 class CScriptCheck;
 class CTxMemPool;
 class CTxPoolAggregate;
+class CUTXOStats;
 class CValidationInterface;
 class CValidationState;
 struct ChainTxData;
@@ -91,6 +95,12 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** -parheaders default (number of header proof of work checking threads, 0 = auto) */
+static const int DEFAULT_HEADERCHECK_THREADS = 0;
+/** Maximum number of header proof of work checking threads allowed */
+static const int MAX_HEADERCHECK_THREADS = 16;
+/** Header batches smaller than this are checked on the calling thread */
+static const size_t MIN_PARALLEL_HEADER_CHECKS = 16;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -146,6 +156,9 @@ static const bool DEFAULT_TXINDEX = true;
 static const bool DEFAULT_TIMESTAMPINDEX = false;
 static const bool DEFAULT_ADDRESSINDEX = false;
 static const bool DEFAULT_SPENTINDEX = false;
+static const bool DEFAULT_UTXOSTATS = false;
+/** Default for -asyncflush, write the coins cache to disk in the background */
+static const bool DEFAULT_ASYNC_FLUSH = true;
 static const bool DEFAULT_TOR_SETUP = false;
 static const bool DEFAULT_ZAP_WALLET = false;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
@@ -169,6 +182,26 @@ static const bool DEFAULT_PEERBLOOMFILTERS = true;
 #define SWITCH_TO_MORE_SPEND_TXS 60000
 
 
+/** The hash of a block header and the result of CheckBlockHeader on it, computed ahead of the contextual checks */
+struct CBlockHeaderCheck
+{
+    uint256 hash;
+    bool fValid;
+    CValidationState state;
+
+    CBlockHeaderCheck() : fValid(false) {}
+};
+
+/** The results of CheckBlockHeaders on a batch of headers, in the order of the headers */
+struct CBlockHeaderChecks
+{
+    std::vector<CBlockHeaderCheck> vChecks;
+    //! Time the checks took, counted in the headers per second of ProcessNewBlockHeaders
+    int64_t nTimeMicros;
+
+    CBlockHeaderChecks() : nTimeMicros(0) {}
+};
+
 struct BlockHasher
 {
     size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
@@ -192,6 +225,8 @@ extern std::atomic_bool fImporting;
 extern bool fReindex;
 extern int nScriptCheckThreads;
 extern bool fTxIndex;
+/** Whether UTXO set statistics are maintained as blocks are connected (-utxostats) */
+extern bool fUTXOStats;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
@@ -275,8 +310,24 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
  * @param[out] state This may be set to an Error state if any error occurred processing them
  * @param[in]  chainparams The params for the chain we want to connect to
  * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers
+ * @param[in]  pchecks If set, the results of CheckBlockHeaders for the given headers, which are computed otherwise if the first header connects
+ */
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=NULL, const CBlockHeaderChecks* pchecks=NULL);
+
+/**
+ * Hash a batch of block headers and run the context-free CheckBlockHeader on
+ * them, on the header check threads for batches large enough, as the X16Rv2
+ * hashes of the headers do not depend on each other. The contextual checks
+ * are left to ProcessNewBlockHeaders, in order. Call without cs_main held.
  */
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=NULL);
+CBlockHeaderChecks CheckBlockHeaders(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams);
+
+/** Start the threads CheckBlockHeaders spreads large batches over; none if nThreads <= 1 */
+void StartHeaderCheckThreads(int nThreads);
+/** Stop the header check threads, once nothing processes headers anymore */
+void StopHeaderCheckThreads();
+/** Headers accepted per second by the last ProcessNewBlockHeaders call of more than one header. Requires cs_main. */
+double GetHeadersPerSecond();
 
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0);
@@ -527,11 +578,18 @@ bool GetAddressIndex(uint160 addressHash, AddressType type,
                      int start = 0, int end = 0);
 bool GetAddressUnspent(uint160 addressHash, AddressType type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
+/** UTXO set statistics as of the active chain block at the given height, or of the tip if nHeight is -1 */
+bool GetUTXOStatsAtHeight(int nHeight, CUTXOStats &stats);
 
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock);
+/** Read a block as it is serialized on disk, without deserializing it */
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
+/** Read the undo data of a block as it is serialized on disk; the checksum is still verified */
+bool ReadRawUndoFromDisk(std::vector<unsigned char>& undo, const CDiskBlockPos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -610,6 +668,9 @@ extern CChain chainActive;
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern CCoinsViewCache *pcoinsTip;
 
+/** The layer below pcoinsTip that writes flushes in the background, NULL with -asyncflush=0 (protected by cs_main) */
+extern CCoinsViewFlushBuffer *pcoinsFlushBuffer;
+
 /** Global variable that points to the active block tree (protected by cs_main) */
 extern CBlockTreeDB *pblocktree;
 
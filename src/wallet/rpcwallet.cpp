@@ -3622,7 +3622,8 @@ UniValue spendmany(const JSONRPCRequest& request) {
 
     EnsureSigmaWalletIsAvailable();
 
-    LOCK2(cs_main, pwallet->cs_wallet);
+    // No locks here, SpendSigma takes them for coin selection and the commit only and
+    // lets the proofs run without them.
 
     // Only account "" have sigma coins.
     std::string strAccount = AccountFromValue(request.params[0]);
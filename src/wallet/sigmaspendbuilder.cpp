@@ -14,16 +14,28 @@
 #include "../version.h"
 #include "../sigma.h"
 #include "../hdmint/wallet.h"
+#include "../ctpl.h"
 
+#include <algorithm>
+#include <future>
+#include <map>
 #include <stdexcept>
 #include <tuple>
 
+/** An anonymity set as of the block it was fetched at, shared by the inputs spending from it */
+struct SigmaSpendGroup
+{
+    std::vector<sigma::PublicCoin> coins;
+    uint256 lastBlockOfGroup;
+};
+
+typedef std::map<std::pair<sigma::CoinDenomination, int>, std::shared_ptr<const SigmaSpendGroup>> SigmaSpendGroups;
+
 class SigmaSpendSigner : public InputSigner
 {
 public:
     const sigma::PrivateCoin coin;
-    std::vector<sigma::PublicCoin> group;
-    uint256 lastBlockOfGroup;
+    std::shared_ptr<const SigmaSpendGroup> group;
     bool fPadding;
 
 public:
@@ -35,12 +47,12 @@ public:
     CScript Sign(const CMutableTransaction& tx, const uint256& sig) override
     {
         // construct spend
-        sigma::SpendMetaData meta(output.n, lastBlockOfGroup, sig);
-        sigma::CoinSpend spend(coin.getParams(), coin, group, meta, fPadding);
+        sigma::SpendMetaData meta(output.n, group->lastBlockOfGroup, sig);
+        sigma::CoinSpend spend(coin.getParams(), coin, group->coins, meta, fPadding);
 
         spend.setVersion(coin.getVersion());
 
-        if (!spend.Verify(group, meta, fPadding)) {
+        if (!spend.Verify(group->coins, meta, fPadding)) {
             throw std::runtime_error(_("The spend coin transaction failed to verify"));
         }
 
@@ -57,7 +69,7 @@ public:
     }
 };
 
-static std::unique_ptr<SigmaSpendSigner> CreateSigner(const CSigmaEntry& coin)
+static std::unique_ptr<SigmaSpendSigner> CreateSigner(const CSigmaEntry& coin, SigmaSpendGroups& groups)
 {
     sigma::CSigmaState* state = sigma::CSigmaState::GetState();
     auto params = sigma::Params::get_default();
@@ -94,39 +106,49 @@ static std::unique_ptr<SigmaSpendSigner> CreateSigner(const CSigmaEntry& coin)
     signer->output.n = static_cast<uint32_t>(groupId);
     signer->sequence = CTxIn::SEQUENCE_FINAL;
 
-    if (state->GetCoinSetForSpend(
-        &chainActive,
-        chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 6 confirmation for mint to spend
-        denom,
-        groupId,
-        signer->lastBlockOfGroup,
-        signer->group) < 2) {
-        throw std::runtime_error(_("Has to have at least two mint coins with at least 6 confirmation in order to spend a coin"));
+    // inputs from the same group share the set, which only has to be fetched once
+    std::shared_ptr<const SigmaSpendGroup>& group = groups[std::make_pair(denom, groupId)];
+    if (!group) {
+        auto fetched = std::make_shared<SigmaSpendGroup>();
+        if (state->GetCoinSetForSpend(
+            &chainActive,
+            chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 6 confirmation for mint to spend
+            denom,
+            groupId,
+            fetched->lastBlockOfGroup,
+            fetched->coins) < 2) {
+            throw std::runtime_error(_("Has to have at least two mint coins with at least 6 confirmation in order to spend a coin"));
+        }
+        group = fetched;
     }
+    signer->group = group;
 
     return signer;
 }
 
+/**
+ * Makes the proofs of the spends of more than one input, for all spends alike so that its
+ * threads start once. Never destroyed, the idle threads do not keep the process from exiting.
+ */
+static ctpl::thread_pool& GetProvingPool()
+{
+    static ctpl::thread_pool* pool = []() {
+        ctpl::thread_pool* newPool = new ctpl::thread_pool(std::max(1, GetNumCores()));
+        RenameThreadPool(*newPool, "sigma-prove");
+        return newPool;
+    }();
+    return *pool;
+}
+
 SigmaSpendBuilder::SigmaSpendBuilder(CWallet& wallet, CHDMintWallet& mintWallet, const CCoinControl *coinControl) :
     TxBuilder(wallet),
     mintWallet(mintWallet)
 {
-    cs_main.lock();
-
-    try {
-        wallet.cs_wallet.lock();
-    } catch (...) {
-        cs_main.unlock();
-        throw;
-    }
-
     this->coinControl = coinControl;
 }
 
 SigmaSpendBuilder::~SigmaSpendBuilder()
 {
-    wallet.cs_wallet.unlock();
-    cs_main.unlock();
 }
 
 CAmount SigmaSpendBuilder::GetInputs(std::vector<std::unique_ptr<InputSigner>>& signers, CAmount required)
@@ -145,9 +167,10 @@ CAmount SigmaSpendBuilder::GetInputs(std::vector<std::unique_ptr<InputSigner>>&
 
     // construct signers
     CAmount total = 0;
+    SigmaSpendGroups groups;
     for (auto& coin : selected) {
         total += coin.get_denomination_value();
-        signers.push_back(CreateSigner(coin));
+        signers.push_back(CreateSigner(coin, groups));
     }
 
     return total;
@@ -188,3 +211,44 @@ CAmount SigmaSpendBuilder::GetChanges(std::vector<CTxOut>& outputs, CAmount amou
 
     return amount;
 }
+
+void SigmaSpendBuilder::SignInputs(CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers)
+{
+    if (signers.size() < 2) {
+        TxBuilder::SignInputs(tx, sig, signers);
+        return;
+    }
+
+    // The proofs take seconds each, and need neither the chain nor the wallet: the signers have
+    // their coins and anonymity sets already.
+    ctpl::thread_pool& workerPool = GetProvingPool();
+
+    std::vector<std::future<CScript>> scripts;
+    scripts.reserve(signers.size());
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        InputSigner* signer = signers[i].get();
+        scripts.push_back(workerPool.push([signer, &tx, &sig](int) {
+            return signer->Sign(tx, sig);
+        }));
+    }
+
+    // Wait for every proof before touching tx or letting anything go out of scope, even if one of them failed
+    std::vector<CScript> scriptSigs(scripts.size());
+    std::exception_ptr error;
+    for (size_t i = 0; i < scripts.size(); i++) {
+        try {
+            scriptSigs[i] = scripts[i].get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        tx.vin[i].scriptSig = std::move(scriptSigs[i]);
+    }
+}
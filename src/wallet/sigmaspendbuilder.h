@@ -22,6 +22,8 @@ protected:
     CAmount GetInputs(std::vector<std::unique_ptr<InputSigner>>& signers, CAmount required) override;
     // remint change
     CAmount GetChanges(std::vector<CTxOut>& outputs, CAmount amount, CWalletDB& walletdb) override;
+    // prove the inputs in parallel, without holding cs_main and cs_wallet
+    void SignInputs(CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers) override;
 
 private:
     CHDMintWallet& mintWallet;
@@ -66,6 +66,13 @@ CWalletTx TxBuilder::Build(const std::vector<CRecipient>& recipients, CAmount& f
     CWalletTx result;
     CMutableTransaction tx;
 
+    // The locks are only held where the chain and the wallet are used, proofs may run long without them
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+
     result.fTimeReceivedIsTxTime = true;
     result.BindWallet(&wallet);
 
@@ -89,7 +96,7 @@ CWalletTx TxBuilder::Build(const std::vector<CRecipient>& recipients, CAmount& f
     // enough, that fee sniping isn't a problem yet, but by implementing a fix
     // now we ensure code won't be written that makes assumptions about
     // nLockTime that preclude a fix later.
-    tx.nLockTime = chainActive.Height();
+    tx.nLockTime = nHeight;
 
     // Secondly occasionally randomly pick a nLockTime even further back, so
     // that transactions that are delayed after signing for whatever reason,
@@ -99,18 +106,23 @@ CWalletTx TxBuilder::Build(const std::vector<CRecipient>& recipients, CAmount& f
         tx.nLockTime = std::max(0, static_cast<int>(tx.nLockTime) - GetRandInt(100));
     }
 
-    assert(tx.nLockTime <= static_cast<unsigned>(chainActive.Height()));
+    assert(tx.nLockTime <= static_cast<unsigned>(nHeight));
     assert(tx.nLockTime < LOCKTIME_THRESHOLD);
 
     // Start with no fee and loop until there is enough fee;
-    uint32_t nCountNextUse;
+    uint32_t nCountNextUse, nCountLastUse;
     if (pwalletMain->zwallet) {
-        nCountNextUse = pwalletMain->zwallet->GetCount();
+        LOCK(wallet.cs_wallet);
+        nCountNextUse = nCountLastUse = pwalletMain->zwallet->GetCount();
     }
     for (fee = payTxFee.GetFeePerK();;) {
-        // In case of not enough fee, reset mint seed counter
+        // In case of not enough fee, reset mint seed counter. Signing runs without the wallet lock,
+        // other mints may have taken the seeds after ours meanwhile, those must not be handed out twice.
         if (pwalletMain->zwallet) {
-            pwalletMain->zwallet->SetCount(nCountNextUse);
+            LOCK(wallet.cs_wallet);
+            if (pwalletMain->zwallet->GetCount() == nCountLastUse) {
+                pwalletMain->zwallet->SetCount(nCountNextUse);
+            }
         }
         CAmount required = spend;
 
@@ -162,63 +174,68 @@ CWalletTx TxBuilder::Build(const std::vector<CRecipient>& recipients, CAmount& f
             tx.vout.push_back(vout);
         }
 
-        // get inputs
+        // get inputs and changes under the locks, the signers need neither of them afterwards
         std::vector<std::unique_ptr<InputSigner>> signers;
-        CAmount total = GetInputs(signers, required);
-
-        // add changes
-        CAmount change = total - required;
-
-        if (change > 0) {
-            // get changes outputs
-            std::vector<CTxOut> changes;
-            CAmount addToFee = GetChanges(changes, change, walletdb);
-            if(addToFee > 0)
-                fChangeAddedToFee = true;
-            fee += addToFee;
-
-            // shuffle changes to provide some privacy
-            std::vector<std::pair<std::reference_wrapper<CTxOut>, bool>> outputs;
-            outputs.reserve(tx.vout.size() + changes.size());
-
-            for (auto& output : tx.vout) {
-                outputs.push_back(std::make_pair(std::ref(output), false));
-            }
+        {
+            LOCK2(cs_main, wallet.cs_wallet);
+            CAmount total = GetInputs(signers, required);
+
+            // add changes
+            CAmount change = total - required;
+
+            if (change > 0) {
+                // get changes outputs
+                std::vector<CTxOut> changes;
+                CAmount addToFee = GetChanges(changes, change, walletdb);
+                if(addToFee > 0)
+                    fChangeAddedToFee = true;
+                fee += addToFee;
+
+                // shuffle changes to provide some privacy
+                std::vector<std::pair<std::reference_wrapper<CTxOut>, bool>> outputs;
+                outputs.reserve(tx.vout.size() + changes.size());
+
+                for (auto& output : tx.vout) {
+                    outputs.push_back(std::make_pair(std::ref(output), false));
+                }
 
-            for (auto& output : changes) {
-                outputs.push_back(std::make_pair(std::ref(output), true));
-            }
+                for (auto& output : changes) {
+                    outputs.push_back(std::make_pair(std::ref(output), true));
+                }
 
-            std::shuffle(outputs.begin(), outputs.end(), std::random_device());
+                std::shuffle(outputs.begin(), outputs.end(), std::random_device());
 
-            // replace outputs with shuffled one
-            std::vector<CTxOut> shuffled;
-            shuffled.reserve(outputs.size());
+                // replace outputs with shuffled one
+                std::vector<CTxOut> shuffled;
+                shuffled.reserve(outputs.size());
 
-            for (size_t i = 0; i < outputs.size(); i++) {
-                auto& output = outputs[i];
+                for (size_t i = 0; i < outputs.size(); i++) {
+                    auto& output = outputs[i];
 
-                shuffled.push_back(output.first);
+                    shuffled.push_back(output.first);
 
-                if (output.second) {
-                    result.changes.insert(static_cast<uint32_t>(i));
+                    if (output.second) {
+                        result.changes.insert(static_cast<uint32_t>(i));
+                    }
                 }
+
+                tx.vout = std::move(shuffled);
             }
 
-            tx.vout = std::move(shuffled);
-        }
+            // fill inputs
+            for (auto& signer : signers) {
+                tx.vin.emplace_back(signer->output, CScript(), signer->sequence);
+            }
 
-        // fill inputs
-        for (auto& signer : signers) {
-            tx.vin.emplace_back(signer->output, CScript(), signer->sequence);
+            if (pwalletMain->zwallet) {
+                nCountLastUse = pwalletMain->zwallet->GetCount();
+            }
         }
 
         // now every fields is populated then we can sign transaction
         uint256 sig = tx.GetHash();
 
-        for (size_t i = 0; i < tx.vin.size(); i++) {
-            tx.vin[i].scriptSig = signers[i]->Sign(tx, sig);
-        }
+        SignInputs(tx, sig, signers);
 
         // check fee
         result.SetTx(MakeTransactionRef(tx));
@@ -268,3 +285,10 @@ CAmount TxBuilder::AdjustFee(CAmount needed, unsigned txSize)
 {
     return needed;
 }
+
+void TxBuilder::SignInputs(CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers)
+{
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        tx.vin[i].scriptSig = signers[i]->Sign(tx, sig);
+    }
+}
@@ -40,9 +40,14 @@ public:
     CWalletTx Build(const std::vector<CRecipient>& recipients, CAmount& fee,  bool& fChangeAddedToFee, CWalletDB& walletdb);
 
 protected:
+    // Called with cs_main and cs_wallet held
     virtual CAmount GetInputs(std::vector<std::unique_ptr<InputSigner>>& signers, CAmount required) = 0;
     virtual CAmount GetChanges(std::vector<CTxOut>& outputs, CAmount amount, CWalletDB& walletdb) = 0;
     virtual CAmount AdjustFee(CAmount needed, unsigned txSize);
+
+    // Fills in the scriptSig of every input, the signers do not depend on each other. Called without
+    // cs_main and cs_wallet, unless the caller of Build() holds them.
+    virtual void SignInputs(CMutableTransaction& tx, const uint256& sig, const std::vector<std::unique_ptr<InputSigner>>& signers);
 };
 
 #endif
@@ -45,6 +45,7 @@
 #include "rpc/protocol.h"
 
 #include "hdmint/tracker.h"
+#include "blockprefetch.h"
 
 #include <assert.h>
 #include <boost/algorithm/string.hpp>
@@ -2376,11 +2377,35 @@ void CWalletTx::GetAccountAmounts(const string& strAccount, CAmount& nReceived,
     }
 }
 
+namespace {
+
+/**
+ * Check whether transaction can be ours judging only by the keystore. Zerocoin and sigma
+ * transactions are always passed as their ownership is decided by wallet database lookups.
+ * The keystore locks itself, so this is safe to call without cs_wallet.
+ */
+bool MaybeMine(const CKeyStore& keystore, const CTransaction& tx)
+{
+    if (tx.IsZerocoinTransaction() || tx.IsZerocoinV3SigmaTransaction())
+        return true;
+
+    BOOST_FOREACH(const CTxOut& txout, tx.vout) {
+        if (txout.scriptPubKey.IsSigmaMint() || ::IsMine(keystore, txout.scriptPubKey) != ISMINE_NO)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
  * exist in the wallet will be updated.
  *
+ * Blocks are read, deserialized and prefiltered ahead of the scan by
+ * -rescanthreads worker threads and handed to the wallet in chain order.
+ *
  * Returns pointer to the first block in the last contiguous range that was
  * successfully scanned.
  *
@@ -2409,33 +2434,75 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex *pindexStart, bool f
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
         double dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
         double dProgressTip = GuessVerificationProgress(chainParams.TxData(), chainActive.Tip());
-        while (pindex)
+
+        // Blocks are prefiltered by the workers, tx flags tell which transactions may be ours
+        const CKeyStore& keystore = *this;
+        CBlockPrefetcher prefetcher(chainParams.GetConsensus(), pindex, [](const CBlockIndex* pindexPrev) { return chainActive.Next(pindexPrev); },
+            "index-rescan", GetArg("-rescanthreads", DEFAULT_RESCAN_THREADS), false, [&keystore](CPrefetchedBlock& prefetchedBlock) {
+                prefetchedBlock.vTxFlags.reserve(prefetchedBlock.block->vtx.size());
+                for (const auto& tx : prefetchedBlock.block->vtx)
+                    prefetchedBlock.vTxFlags.push_back(MaybeMine(keystore, *tx));
+            });
+
+        int64_t nStartTime = GetTimeMillis();
+        int nBlocks = 0;
+        size_t nTxs = 0, nPassed = 0;
+
+        while (std::shared_ptr<CPrefetchedBlock> rescanBlock = prefetcher.Next())
         {
+            pindex = rescanBlock->pindex;
+
             if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
                 ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
             if (GetTime() >= nNow + 60) {
                 nNow = GetTime();
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+                LogPrintf("Still rescanning. At block %d. Progress=%f, %.1f blocks/s\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex),
+                    nBlocks * 1000.0 / std::max<int64_t>(1, GetTimeMillis() - nStartTime));
             }
 
-            CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            if (rescanBlock->fRead) {
+                const CBlock& block = *rescanBlock->block;
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    AddToWalletIfInvolvingMe(*block.vtx[posInBlock], pindex, posInBlock, fUpdate);
+                    const CTransaction& tx = *block.vtx[posInBlock];
+                    // Transactions not paying to us can still be known, spend our coins or conflict with ours,
+                    // check these against the current wallet state which is cheap
+                    if (!rescanBlock->vTxFlags[posInBlock] && !IsKnownOrSpendsKnown(tx))
+                        continue;
+                    nPassed++;
+                    AddToWalletIfInvolvingMe(tx, pindex, posInBlock, fUpdate);
                 }
+                nTxs += block.vtx.size();
+                nBlocks++;
                 if (!ret) {
                     ret = pindex;
                 }
             } else {
                 ret = nullptr;
             }
-            pindex = chainActive.Next(pindex);
         }
         ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
+
+        int64_t nElapsed = std::max<int64_t>(1, GetTimeMillis() - nStartTime);
+        LogPrintf("Rescan: scanned %d blocks with %u transactions (%u passed prefilter) in %dms, %.1f blocks/s, %d threads\n",
+            nBlocks, nTxs, nPassed, nElapsed, nBlocks * 1000.0 / nElapsed, prefetcher.GetThreads());
     }
     return ret;
 }
 
+bool CWallet::IsKnownOrSpendsKnown(const CTransaction& tx) const
+{
+    AssertLockHeld(cs_wallet);
+
+    if (mapWallet.count(tx.GetHash()))
+        return true;
+
+    BOOST_FOREACH(const CTxIn& txin, tx.vin) {
+        if (mapWallet.count(txin.prevout.hash) || mapTxSpends.count(txin.prevout))
+            return true;
+    }
+    return false;
+}
+
 void CWallet::ReacceptWalletTransactions()
 {
     // If transactions aren't being broadcasted, don't let them into local mempool either
@@ -6164,6 +6231,16 @@ std::vector<CSigmaEntry> CWallet::SpendSigma(
     bool fChangeAddedToFee;
     result = CreateSigmaSpendTransaction(recipients, fee, coins, changes, fChangeAddedToFee);
 
+    LOCK2(cs_main, cs_wallet);
+
+    // The coins were not locked while the proofs were made, another spend may have used them meanwhile
+    for (const auto& coin : coins) {
+        CMintMeta meta;
+        if (zwallet->GetTracker().GetMetaFromPubcoin(primitives::GetPubCoinValueHash(coin.value), meta) && meta.isUsed) {
+            throw std::runtime_error(_("Some of the selected coins were spent by another transaction meanwhile, please try again"));
+        }
+    }
+
     CommitSigmaTransaction(result, coins, changes);
 
     return coins;
@@ -7126,6 +7203,7 @@ std::string CWallet::GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-paytxfee=<amt>", strprintf(_("Fee (in %s/kB) to add to transactions you send (default: %s)"),
                                                             CURRENCY_UNIT, FormatMoney(payTxFee.GetFeePerK())));
     strUsage += HelpMessageOpt("-rescan", _("Rescan the block chain for missing wallet transactions on startup"));
+    strUsage += HelpMessageOpt("-rescanthreads=<n>", strprintf(_("Number of threads reading blocks ahead of a wallet rescan (default: %u)"), DEFAULT_RESCAN_THREADS));
     strUsage += HelpMessageOpt("-salvagewallet", _("Attempt to recover private keys from a corrupt wallet on startup"));
     if (showDebug)
         strUsage += HelpMessageOpt("-sendfreetransactions", strprintf(_("Send transactions as zero-fee transactions if possible (default: %u)"), DEFAULT_SEND_FREE_TRANSACTIONS));
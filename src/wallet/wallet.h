@@ -89,6 +89,9 @@ static const bool DEFAULT_DISABLE_WALLET = false;
 
 static const bool DEFAULT_UPGRADE_CHAIN = false;
 
+//! Number of threads reading and prefiltering blocks during a rescan
+static const int DEFAULT_RESCAN_THREADS = 4;
+
 //! if set, all keys will be derived by using BIP32
 static const bool DEFAULT_USE_HD_WALLET = true;
 
@@ -907,6 +910,8 @@ public:
     bool LoadToWallet(const CWalletTx& wtxIn);
     void SyncTransaction(const CTransaction& tx, const CBlockIndex *pindex, int posInBlock) override;
     bool AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex* pIndex, int posInBlock, bool fUpdate);
+    //! Whether tx is in the wallet or spends outputs known to the wallet
+    bool IsKnownOrSpendsKnown(const CTransaction& tx) const;
     CBlockIndex* ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate = false, bool fRecoverMnemonic = false);
     void ReacceptWalletTransactions();
     void ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman) override;
@@ -12,9 +12,11 @@
 #include "indexnode-sync.h"
 #include "sigma/remint.h"
 
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 #include <chrono>
+#include <tuple>
 
 #include <boost/foreach.hpp>
 
@@ -424,9 +426,13 @@ bool CheckSpendIndexTransaction(const CTransaction &tx,
                 } while (index != coinGroup.firstBlock);
             }
 
-            libzerocoin::Accumulator accumulator(zcParams, targetDenominations[vinIndex]);
-            BOOST_FOREACH(const CBigNum &pubCoin, pubCoins) {
-                accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
+            libzerocoin::CoinDenomination denomination = (libzerocoin::CoinDenomination)targetDenominations[vinIndex];
+            CZerocoinAccumulatorMemo::Key memoKey = {fModulusV2, targetDenominations[vinIndex], (int)pubcoinId,
+                                                     coinGroup.lastBlock->GetBlockHash(), false};
+
+            std::shared_ptr<CZerocoinAccumulatorMemo::Entry> memoEntry = zerocoinState.accumulatorMemo.Get(memoKey);
+            for (size_t i = 0; i < pubCoins.size(); i++) {
+                libzerocoin::Accumulator accumulator(zcParams, memoEntry->GetValue(i, pubCoins, zcParams, denomination), denomination);
                 LogPrintf("CheckSpendIndexTransaction: accumulator=%s\n", accumulator.getValue().ToString().substr(0,15));
                 if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
                     break;
@@ -435,9 +441,11 @@ bool CheckSpendIndexTransaction(const CTransaction &tx,
             if (!passVerify) {
                 // One more time now in reverse direction. The only reason why it's required is compatibility with
                 // previous client versions
-                libzerocoin::Accumulator accumulator(zcParams, targetDenominations[vinIndex]);
-                BOOST_REVERSE_FOREACH(const CBigNum &pubCoin, pubCoins) {
-                    accumulator += libzerocoin::PublicCoin(zcParams, pubCoin, (libzerocoin::CoinDenomination)targetDenominations[vinIndex]);
+                vector<CBigNum> reversePubCoins(pubCoins.rbegin(), pubCoins.rend());
+                memoKey.fReverse = true;
+                memoEntry = zerocoinState.accumulatorMemo.Get(memoKey);
+                for (size_t i = 0; i < reversePubCoins.size(); i++) {
+                    libzerocoin::Accumulator accumulator(zcParams, memoEntry->GetValue(i, reversePubCoins, zcParams, denomination), denomination);
                     LogPrintf("CheckSpendIndexTransaction: accumulatorRev=%s\n", accumulator.getValue().ToString().substr(0,15));
                     if ((passVerify = spend->Verify(accumulator, newMetadata)) == true)
                         break;
@@ -914,7 +922,63 @@ void CZerocoinState::AddBlock(CBlockIndex *index, const Consensus::Params &param
     }
 }
 
+bool CZerocoinAccumulatorMemo::Key::operator<(const Key &other) const {
+    return std::tie(fModulusV2, denomination, id, lastBlockHash, fReverse) <
+            std::tie(other.fModulusV2, other.denomination, other.id, other.lastBlockHash, other.fReverse);
+}
+
+CBigNum CZerocoinAccumulatorMemo::Entry::GetValue(size_t n, const vector<CBigNum> &pubCoins, const libzerocoin::Params *params,
+                                                  libzerocoin::CoinDenomination denomination) {
+    assert(n < pubCoins.size());
+
+    LOCK(cs);
+    while (values.size() <= n) {
+        libzerocoin::Accumulator accumulator(params, denomination);
+        if (!values.empty())
+            accumulator = libzerocoin::Accumulator(params, values.back(), denomination);
+        accumulator += libzerocoin::PublicCoin(params, pubCoins[values.size()], denomination);
+        values.push_back(accumulator.getValue());
+    }
+    return values[n];
+}
+
+std::shared_ptr<CZerocoinAccumulatorMemo::Entry> CZerocoinAccumulatorMemo::Get(const Key &key) {
+    LOCK(cs);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        if (entries.size() >= MAX_ENTRIES) {
+            auto oldest = std::min_element(entries.begin(), entries.end(), [](const decltype(entries)::value_type &a, const decltype(entries)::value_type &b) {
+                return a.second.second < b.second.second;
+            });
+            entries.erase(oldest);
+        }
+        it = entries.emplace(key, make_pair(std::make_shared<Entry>(), 0)).first;
+    }
+
+    it->second.second = ++nUseCounter;
+    return it->second.first;
+}
+
+void CZerocoinAccumulatorMemo::RemoveBlock(const uint256 &blockHash) {
+    LOCK(cs);
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (it->first.lastBlockHash == blockHash)
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+void CZerocoinAccumulatorMemo::Clear() {
+    LOCK(cs);
+    entries.clear();
+}
+
 void CZerocoinState::RemoveBlock(CBlockIndex *index) {
+    // values computed up to the block are of no use any more
+    accumulatorMemo.RemoveBlock(index->GetBlockHash());
+
     // roll back accumulator updates
     BOOST_FOREACH(const PAIRTYPE(PAIRTYPE(int,int), PAIRTYPE(CBigNum,int)) &accUpdate, index->accumulatorChanges)
     {
@@ -1280,6 +1344,7 @@ void CZerocoinState::Reset() {
     mintedPubCoins.clear();
     latestCoinIds.clear();
     mempoolCoinSerials.clear();
+    accumulatorMemo.Clear();
 }
 
 CZerocoinState *CZerocoinState::GetZerocoinState() {
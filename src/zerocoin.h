@@ -7,9 +7,11 @@
 #include "consensus/validation.h"
 #include "libzerocoin/Zerocoin.h"
 #include "zerocoin_params.h"
+#include "sync.h"
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 
 // zerocoin parameters
 extern libzerocoin::Params *ZCParams, *ZCParamsV2;
@@ -68,6 +70,53 @@ bool ZerocoinBuildStateFromIndex(CChain *chain, set<CBlockIndex *> &changes);
 
 CBigNum ZerocoinGetSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 
+/*
+ * Accumulator values of coin groups computed from their mints one coin at a time, for spend v1 verification.
+ * A v1 spend may refer to an accumulator value the index does not have, then every accumulator value after
+ * each of the mints of the group is tried, in the order of the chain and in reverse. All the spends of a
+ * group need the same values, so they are kept by (modulus, denomination, id, hash of the last block of the
+ * group, direction), filled as far as a verification needed them. Bounded, the least recently used group is
+ * dropped first; entries of a block are dropped when it is disconnected.
+ */
+class CZerocoinAccumulatorMemo {
+public:
+    struct Key {
+        bool fModulusV2;
+        int denomination;
+        int id;
+        uint256 lastBlockHash;
+        bool fReverse;
+
+        bool operator<(const Key &other) const;
+    };
+
+    class Entry {
+    public:
+        // Accumulator value after the first n+1 of pubCoins, accumulating the ones not done yet.
+        // pubCoins must be the same every time for the entry.
+        CBigNum GetValue(size_t n, const vector<CBigNum> &pubCoins, const libzerocoin::Params *params,
+                         libzerocoin::CoinDenomination denomination);
+
+    private:
+        CCriticalSection cs;
+        vector<CBigNum> values;
+    };
+
+    static const size_t MAX_ENTRIES = 64;
+
+    // Entry for the key, a new empty one if there is none
+    std::shared_ptr<Entry> Get(const Key &key);
+    // Drop the entries computed up to the block
+    void RemoveBlock(const uint256 &blockHash);
+    void Clear();
+
+private:
+    CCriticalSection cs;
+    // entries with the counter value of their last use
+    map<Key, pair<std::shared_ptr<Entry>, uint64_t>> entries;
+    uint64_t nUseCounter = 0;
+};
+
 /*
  * State of minted/spent coins as extracted from the index
  */
@@ -116,6 +165,9 @@ public:
     // serials of spends currently in the mempool mapped to tx hashes
     unordered_map<CBigNum,uint256,CBigNumHash> mempoolCoinSerials;
 
+    // accumulator values for spend v1 verification computed from the mints of coin groups
+    CZerocoinAccumulatorMemo accumulatorMemo;
+
     // Add mint, automatically assigning id to it. Returns id and previous accumulator value (if any)
     int AddMint(CBlockIndex *index, int denomination, const CBigNum &pubCoin, CBigNum &previousAccValue);
     // Add serial to the list of used ones